@@ -0,0 +1,347 @@
+// Batch runner
+// Run many independent emulator instances on a work-stealing thread pool
+// Each job: one ROM, an optional input script, run to a frame or clock budget,
+// then dump the frame buffer (PGM), the RAM and one line of stats (CSV)
+
+// usage
+// batch-runner [--threads N] [--frames N] [--clocks N] [--out DIR] <job-list>
+//
+// job list, one job per line, # for comments
+// <rom-path> [input-script-path]
+//
+// input script, buttons are held from the given frame until the next line
+// <frame> <buttons>      buttons: - or RIGHT+LEFT+UP+DOWN+A+B+SELECT+START
+
+#include "benchmark.h"
+#include "motherboard.h"
+#include "thread-pool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+
+using gameboy::JoypadInput;
+using gameboy::Motherboard;
+using gameboy::parse_number;
+using gameboy::ThreadPool;
+
+struct InputScriptEntry
+{
+    uint64_t frame;
+    uint8_t keys_directions;
+    uint8_t keys_controls;
+};
+
+struct BatchConfig
+{
+    unsigned thread_count = 0;   // 0: one per hardware thread
+    uint64_t frame_budget = 600; // 10 seconds of GameBoy time
+    uint64_t clock_budget = 0;   // 4 MHz clocks, replaces frame budget when set
+    std::string output_directory = "batch-output";
+};
+
+struct BatchJob
+{
+    unsigned job_index;
+    std::string rom_file_path;
+    std::string input_script_path;
+    std::vector<InputScriptEntry> input_script;
+};
+
+struct BatchResult
+{
+    bool finished = false;
+    uint64_t frames = 0;
+    uint64_t clocks = 0;
+    uint64_t instructions = 0;
+    uint64_t idle_loop_skips = 0;
+    uint64_t idle_loop_skipped_clocks = 0;
+    double wall_seconds = 0;
+};
+
+// Parse "RIGHT+A" into FF00 nibbles, 0 means pressed
+bool parse_buttons(const std::string &buttons, InputScriptEntry &entry)
+{
+    entry.keys_directions = 0x0F;
+    entry.keys_controls = 0x0F;
+    if (buttons == "-")
+    {
+        return true;
+    }
+
+    std::stringstream button_stream(buttons);
+    std::string button;
+    while (std::getline(button_stream, button, '+'))
+    {
+        if (button == "RIGHT")
+            entry.keys_directions &= 0xE;
+        else if (button == "LEFT")
+            entry.keys_directions &= 0xD;
+        else if (button == "UP")
+            entry.keys_directions &= 0xB;
+        else if (button == "DOWN")
+            entry.keys_directions &= 0x7;
+        else if (button == "A")
+            entry.keys_controls &= 0xE;
+        else if (button == "B")
+            entry.keys_controls &= 0xD;
+        else if (button == "SELECT")
+            entry.keys_controls &= 0xB;
+        else if (button == "START")
+            entry.keys_controls &= 0x7;
+        else
+            return false;
+    }
+    return true;
+}
+
+bool load_input_script(BatchJob &job)
+{
+    std::ifstream script_file(job.input_script_path);
+    if (!script_file)
+    {
+        printf("Cannot open input script %s\n", job.input_script_path.c_str());
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(script_file, line))
+    {
+        std::stringstream line_stream(line);
+        std::string buttons;
+        InputScriptEntry entry;
+        if (line.empty() || line[0] == '#' || !(line_stream >> entry.frame))
+        {
+            continue;
+        }
+        line_stream >> buttons;
+        if (!parse_buttons(buttons, entry))
+        {
+            printf("Unknown buttons \"%s\" in %s\n", buttons.c_str(), job.input_script_path.c_str());
+            return false;
+        }
+        job.input_script.push_back(entry);
+    }
+    return true;
+}
+
+bool load_job_list(const std::string &job_list_path, std::vector<BatchJob> &jobs)
+{
+    std::ifstream job_list_file(job_list_path);
+    if (!job_list_file)
+    {
+        printf("Cannot open job list %s\n", job_list_path.c_str());
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(job_list_file, line))
+    {
+        std::stringstream line_stream(line);
+        BatchJob job;
+        if (line.empty() || line[0] == '#' || !(line_stream >> job.rom_file_path))
+        {
+            continue;
+        }
+        line_stream >> job.input_script_path;
+        job.job_index = jobs.size();
+        if (!job.input_script_path.empty() && !load_input_script(job))
+        {
+            return false;
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+void dump_frame_buffer(const std::string &file_path, const Motherboard &motherboard)
+{
+    FILE *frame_out = fopen(file_path.c_str(), "wb");
+    if (!frame_out)
+    {
+        return;
+    }
+    // shade 0 is the lightest
+    fprintf(frame_out, "P5\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (int pos_y = 0; pos_y < SCREEN_HEIGHT; pos_y++)
+    {
+        uint8_t gray_line[SCREEN_WIDTH];
+        for (int pos_x = 0; pos_x < SCREEN_WIDTH; pos_x++)
+        {
+            gray_line[pos_x] = 255 - 85 * (motherboard.ppu.frame_buffer[pos_y][pos_x] & 0x03);
+        }
+        fwrite(gray_line, sizeof(uint8_t), SCREEN_WIDTH, frame_out);
+    }
+    fclose(frame_out);
+}
+
+void dump_ram(const std::string &file_path, const Motherboard &motherboard)
+{
+    FILE *ram_out = fopen(file_path.c_str(), "wb");
+    if (!ram_out)
+    {
+        return;
+    }
+    // 0xA000~0xBFFF is the cartridge RAM bank mapped now
+    std::vector<uint8_t> temp_bytes(motherboard.mem.memory_byte, motherboard.mem.memory_byte + 0x10000);
+    for (int page = (CARTRIDGE_RAM_START_ADDRESS >> PAGE_SHIFT); page <= (CARTRIDGE_RAM_END_ADDRESS >> PAGE_SHIFT); page++)
+    {
+        memcpy(&temp_bytes[page << PAGE_SHIFT], motherboard.mem.read_page[page], 1 << PAGE_SHIFT);
+    }
+    fwrite(temp_bytes.data(), sizeof(uint8_t), 0x10000, ram_out);
+    fclose(ram_out);
+}
+
+// Run one instance to its budget, everything lives on this task
+BatchResult run_job(const BatchJob &job, const BatchConfig &config)
+{
+    BatchResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    // Motherboard is too large for a worker stack
+    std::unique_ptr<Motherboard> motherboard(new Motherboard);
+    // instances of one ROM must not share its .sav file
+    motherboard->mem.cartridge.save_file_enabled = false;
+    if (!motherboard->power_on(job.rom_file_path))
+    {
+        return result;
+    }
+
+    JoypadInput input;
+    size_t next_script_entry = 0;
+    while (config.clock_budget ? motherboard->scheduler.now < config.clock_budget
+                               : result.frames < config.frame_budget)
+    {
+        // latch the buttons the script holds for this frame
+        while (next_script_entry < job.input_script.size() &&
+               job.input_script[next_script_entry].frame <= result.frames)
+        {
+            input.keys_directions = job.input_script[next_script_entry].keys_directions;
+            input.keys_controls = job.input_script[next_script_entry].keys_controls;
+            next_script_entry++;
+        }
+        motherboard->apply_input(input);
+
+        if (motherboard->run_until_poll())
+        {
+            result.frames++;
+        }
+    }
+
+    std::string output_prefix = config.output_directory + "/" + std::to_string(job.job_index);
+    dump_frame_buffer(output_prefix + ".pgm", *motherboard);
+    dump_ram(output_prefix + ".ram", *motherboard);
+
+    result.finished = true;
+    result.clocks = motherboard->scheduler.now;
+    result.instructions = motherboard->cpu.instruction_count;
+    result.idle_loop_skips = motherboard->cpu.idle_loop_skips;
+    result.idle_loop_skipped_clocks = motherboard->cpu.idle_loop_skipped_clocks;
+    result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    BatchConfig config;
+    std::string job_list_path;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = std::string(argv[i]);
+        bool has_value = i + 1 < argc;
+        if ((option == "--threads" || option == "--frames" || option == "--clocks") && has_value)
+        {
+            uint64_t temp_value;
+            if (!parse_number(argv[++i], option == "--threads" ? UINT32_MAX : UINT64_MAX, temp_value))
+            {
+                printf("Bad value %s for %s\n", argv[i], option.c_str());
+                printf("usage: %s [--threads N] [--frames N] [--clocks N] [--out DIR] <job-list>\n", argv[0]);
+                return 0xFE;
+            }
+            if (option == "--threads")
+                config.thread_count = temp_value;
+            else if (option == "--frames")
+                config.frame_budget = temp_value;
+            else
+                config.clock_budget = temp_value;
+        }
+        else if (option == "--out" && has_value)
+            config.output_directory = argv[++i];
+        else if (job_list_path.empty() && option[0] != '-')
+            job_list_path = option;
+        else
+        {
+            printf("Unrecognized argument %s\n", option.c_str());
+            return 0xFE;
+        }
+    }
+    if (job_list_path.empty())
+    {
+        printf("usage: %s [--threads N] [--frames N] [--clocks N] [--out DIR] <job-list>\n", argv[0]);
+        return 0xDE;
+    }
+
+    std::vector<BatchJob> jobs;
+    if (!load_job_list(job_list_path, jobs))
+    {
+        return 0xFF;
+    }
+
+#ifdef _WIN32
+    mkdir(config.output_directory.c_str());
+#else
+    mkdir(config.output_directory.c_str(), 0755);
+#endif
+
+    // one slot per job, each task only writes its own
+    std::vector<BatchResult> results(jobs.size());
+    auto start = std::chrono::steady_clock::now();
+    unsigned thread_count;
+    {
+        ThreadPool pool(config.thread_count);
+        thread_count = pool.get_thread_count();
+        for (const BatchJob &job : jobs)
+        {
+            BatchResult *result = &results[job.job_index];
+            const BatchJob *job_pointer = &job;
+            pool.submit([result, job_pointer, &config] { *result = run_job(*job_pointer, config); });
+        }
+        pool.wait();
+    }
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    FILE *stats_out = fopen((config.output_directory + "/stats.csv").c_str(), "w");
+    if (stats_out)
+    {
+        fprintf(stats_out, "job,rom,input_script,finished,frames,clocks,instructions,idle_loop_skips,idle_loop_skipped_clocks,wall_seconds\n");
+    }
+    uint64_t total_frames = 0;
+    unsigned failed_jobs = 0;
+    for (const BatchJob &job : jobs)
+    {
+        const BatchResult &result = results[job.job_index];
+        total_frames += result.frames;
+        failed_jobs += result.finished ? 0 : 1;
+        if (stats_out)
+        {
+            fprintf(stats_out, "%u,%s,%s,%d,%llu,%llu,%llu,%llu,%llu,%.3f\n",
+                    job.job_index, job.rom_file_path.c_str(), job.input_script_path.c_str(), result.finished,
+                    (unsigned long long)result.frames, (unsigned long long)result.clocks,
+                    (unsigned long long)result.instructions, (unsigned long long)result.idle_loop_skips,
+                    (unsigned long long)result.idle_loop_skipped_clocks, result.wall_seconds);
+        }
+    }
+    if (stats_out)
+    {
+        fclose(stats_out);
+    }
+
+    printf("%zu jobs (%u failed) on %u threads in %.3f s, %.1f frames/s in total\n",
+           jobs.size(), failed_jobs, thread_count, wall_seconds, total_frames / wall_seconds);
+    return failed_jobs ? 0xFF : 0;
+}
@@ -0,0 +1,72 @@
+// Headless benchmark, builds without SDL
+// Same measurement as run-emulator --benchmark, for servers and CI
+
+// usage
+// benchmark [--frames N] [--clocks N] [--frameskip N] [--poll-scanline] <rom-path>
+
+#include "benchmark.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+using gameboy::InputPollMode;
+using gameboy::Motherboard;
+using gameboy::parse_number;
+
+int main(int argc, char *argv[])
+{
+    // Motherboard is too large for the stack
+    std::unique_ptr<Motherboard> motherboard(new Motherboard);
+    uint64_t frame_budget = 0;
+    uint64_t clock_budget = 0;
+    uint64_t frameskip = 0;
+    std::string rom_file_path;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = std::string(argv[i]);
+        bool has_value = i + 1 < argc;
+        if ((option == "--frames" || option == "--clocks" || option == "--frameskip") && has_value)
+        {
+            uint64_t temp_value;
+            if (!parse_number(argv[++i], option == "--frameskip" ? UINT8_MAX : UINT64_MAX, temp_value))
+            {
+                printf("Bad value %s for %s\n", argv[i], option.c_str());
+                printf("usage: %s [--frames N] [--clocks N] [--frameskip N] [--poll-scanline] <rom-path>\n", argv[0]);
+                return 0xFE;
+            }
+            if (option == "--frames")
+                frame_budget = temp_value;
+            else if (option == "--clocks")
+                clock_budget = temp_value;
+            else
+                frameskip = temp_value;
+        }
+        else if (option == "--poll-scanline")
+            motherboard->input_poll_mode = InputPollMode::poll_per_scanline;
+        else if (rom_file_path.empty() && option[0] != '-')
+            rom_file_path = option;
+        else
+        {
+            printf("Unrecognized argument %s\n", option.c_str());
+            return 0xFE;
+        }
+    }
+    if (rom_file_path.empty())
+    {
+        printf("usage: %s [--frames N] [--clocks N] [--frameskip N] [--poll-scanline] <rom-path>\n", argv[0]);
+        return 0xDE;
+    }
+
+    // benchmark runs leave the game's .sav file alone
+    motherboard->mem.cartridge.save_file_enabled = false;
+    if (!motherboard->power_on(rom_file_path))
+    {
+        return 0xFF;
+    }
+    motherboard->ppu.frameskip = frameskip;
+    gameboy::run_benchmark(*motherboard, frame_budget, clock_budget);
+    motherboard->power_off();
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "benchmark.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using gameboy::JoypadInput;
+using gameboy::Motherboard;
+
+void gameboy::run_benchmark(Motherboard &motherboard, uint64_t frame_budget, uint64_t clock_budget)
+{
+    if (frame_budget == 0 && clock_budget == 0)
+    {
+        frame_budget = BENCHMARK_DEFAULT_FRAMES;
+    }
+    // no buttons held
+    JoypadInput input;
+    motherboard.apply_input(input);
+
+    uint64_t frames = 0;
+    uint64_t start_clock = motherboard.scheduler.now;
+    uint64_t start_instructions = motherboard.cpu.instruction_count;
+    uint64_t start_idle_loop_skips = motherboard.cpu.idle_loop_skips;
+    uint64_t start_idle_loop_clocks = motherboard.cpu.idle_loop_skipped_clocks;
+    auto start = std::chrono::steady_clock::now();
+    while ((frame_budget == 0 || frames < frame_budget) &&
+           (clock_budget == 0 || motherboard.scheduler.now - start_clock < clock_budget))
+    {
+        if (motherboard.run_until_poll())
+        {
+            frames++;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    uint64_t clocks = motherboard.scheduler.now - start_clock;
+    uint64_t instructions = motherboard.cpu.instruction_count - start_instructions;
+    printf("frames        %llu\n", (unsigned long long)frames);
+    printf("clocks        %llu\n", (unsigned long long)clocks);
+    printf("instructions  %llu\n", (unsigned long long)instructions);
+    printf("wall time     %.3f s\n", seconds);
+    printf("frames/s      %.1f\n", frames / seconds);
+    printf("CPU MHz       %.2f (%.1fx realtime)\n", clocks / seconds / 1e6, clocks / seconds / CLOCK_RATE);
+    printf("MIPS          %.2f\n", instructions / seconds / 1e6);
+    printf("idle loops    %llu skips, %.1f%% of clocks skipped\n",
+           (unsigned long long)(motherboard.cpu.idle_loop_skips - start_idle_loop_skips),
+           clocks ? 100.0 * (motherboard.cpu.idle_loop_skipped_clocks - start_idle_loop_clocks) / clocks : 0.0);
+}
+
+bool gameboy::parse_number(const char *text, uint64_t max_value, uint64_t &value)
+{
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    char *end;
+    errno = 0;
+    unsigned long long temp_value = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || temp_value > max_value)
+    {
+        return false;
+    }
+    value = temp_value;
+    return true;
+}
@@ -0,0 +1,28 @@
+// Headless benchmark
+// Run with no pacing until a frame or clock budget, then print throughput
+// Shared by the benchmark executable (no SDL) and run-emulator --benchmark,
+// with the option parsing of the command line tools
+
+#ifndef GAMEBOY_BENCHMARK_H
+#define GAMEBOY_BENCHMARK_H
+
+#include "motherboard.h"
+
+#include <cstdint>
+
+// one minute of GameBoy time
+#define BENCHMARK_DEFAULT_FRAMES 3600
+
+namespace gameboy
+{
+
+// Run the powered on motherboard with no buttons held and print frames/s, CPU MHz, MIPS and idle loop skips
+// 0 means no budget, both 0 runs BENCHMARK_DEFAULT_FRAMES
+void run_benchmark(Motherboard &motherboard, uint64_t frame_budget, uint64_t clock_budget);
+
+// Parse a whole decimal number no larger than max_value, for command line options
+// Return false on anything else (sign, trailing characters, overflow)
+bool parse_number(const char *text, uint64_t max_value, uint64_t &value);
+} // namespace gameboy
+
+#endif
@@ -0,0 +1,30 @@
+#include "block-cache.h"
+
+using gameboy::BasicBlock;
+using gameboy::BlockCache;
+
+BasicBlock *BlockCache::insert(uint16_t bank, uint16_t address, std::unique_ptr<BasicBlock> block)
+{
+    uint32_t temp_page = get_page(bank, address);
+    if (temp_page >= pages.size())
+    {
+        pages.resize(temp_page + 1);
+    }
+    if (!pages[temp_page])
+    {
+        pages[temp_page].reset(new BlockPage);
+    }
+
+    BasicBlock *temp_block = block.get();
+    pages[temp_page]->blocks[address & PAGE_MASK] = temp_block;
+    blocks.push_back(std::move(block));
+    block_count++;
+    return temp_block;
+}
+
+void BlockCache::clear(void)
+{
+    pages.clear();
+    blocks.clear();
+    block_count = 0;
+}
@@ -0,0 +1,102 @@
+// Basic block cache
+// ROM code decoded into runs of instructions that end with the first jump, call,
+// return, RST, HALT or STOP, see Cpu::decode_block and Cpu::run_block.
+// Blocks are keyed by (bank, half of the ROM space, offset in the bank). ROM never
+// changes, so a bank switch only changes which blocks a half finds, the blocks of
+// the switched out bank stay valid. The half is part of the key as translated
+// blocks (src/dynarec.h) hold absolute addresses: MBC1 and MBC5 can map one bank
+// at 0x0000~0x3FFF and 0x4000~0x7FFF. Code in RAM (0x8000~) may be written
+// at any time, it is never cached and always runs through Cpu::next.
+
+#ifndef GAMEBOY_BLOCK_CACHE_H
+#define GAMEBOY_BLOCK_CACHE_H
+
+#include "memory.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Code below this address is ROM
+#define BLOCK_ROM_END_ADDRESS 0x8000
+// Longest block, in instructions
+#define BLOCK_MAX_INSTRUCTIONS 64
+
+namespace gameboy
+{
+
+class Cpu;
+
+// Translated block (src/dynarec.h), called with the arguments of Cpu::run_block
+typedef void (*NativeBlock)(Cpu *cpu, Memory *mem, uint64_t *clock, const uint64_t *deadline);
+
+// One decoded instruction
+// PC still points at the opcode, the handler reads its immediates after it
+// The handler is looked up in Cpu::handle_opcode_main or handle_opcode_prefix_cb
+// when it runs, so a block costs 4 bytes per instruction
+struct BlockInstruction
+{
+    uint8_t opcode; // main opcode, or prefix CB opcode
+    uint8_t cycles; // 1 MHz cycles
+    // 0xCB and a prefix CB opcode
+    bool f_prefix_cb;
+    // Writes memory or enables interrupts: deadline, interrupts and
+    // the mapped ROM bank are checked again after it
+    bool f_check;
+};
+
+struct BasicBlock
+{
+    // Sum of instruction cycles, 1 MHz cycles
+    uint32_t cycles = 0;
+    // Empty when the first instruction can not be cached (illegal opcode, or
+    // its bytes cross the end of the bank): Cpu::next runs it
+    std::vector<BlockInstruction> instructions;
+    // Dynarec: runs through the interpreter, then the translated code
+    uint32_t run_count = 0;
+    NativeBlock native_code = nullptr;
+};
+
+class BlockCache
+{
+public:
+    // Decoded block at address (below BLOCK_ROM_END_ADDRESS)
+    // bank is the ROM bank mapped at address, Memory::get_mapped_rom_bank
+    // Return nullptr if it is not decoded yet
+    BasicBlock *find(uint16_t bank, uint16_t address)
+    {
+        uint32_t temp_page = get_page(bank, address);
+        if (temp_page >= pages.size() || !pages[temp_page])
+        {
+            return nullptr;
+        }
+        return pages[temp_page]->blocks[address & PAGE_MASK];
+    }
+
+    // Keep a decoded block, same key as find
+    BasicBlock *insert(uint16_t bank, uint16_t address, std::unique_ptr<BasicBlock> block);
+
+    // Drop every block, a new ROM is loaded
+    void clear(void);
+
+    // Blocks decoded since the last clear
+    uint64_t block_count = 0;
+
+private:
+    // Blocks of 256 bytes of one bank, allocated by the first block in them,
+    // like the page tables of Memory: code is a small part of most banks
+    struct BlockPage
+    {
+        BasicBlock *blocks[1 << PAGE_SHIFT] = {};
+    };
+    // page: (bank << 1 | 1 at 0x4000~0x7FFF) << 6 | offset in the bank >> PAGE_SHIFT
+    static uint32_t get_page(uint16_t bank, uint16_t address)
+    {
+        uint32_t temp_key = ((uint32_t)bank << 1) | ((address >> 14) & 1);
+        return (temp_key << (14 - PAGE_SHIFT)) | ((address & (BANK_SIZE - 1)) >> PAGE_SHIFT);
+    }
+    std::vector<std::unique_ptr<BlockPage>> pages;
+    std::vector<std::unique_ptr<BasicBlock>> blocks;
+};
+} // namespace gameboy
+
+#endif
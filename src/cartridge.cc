@@ -1,182 +1,181 @@
 #include "cartridge.h"
+#include <cstdio>
 //#define DEBUG
 
 using gameboy::Cartridge;
+using gameboy::Mapper;
+using gameboy::MapperType;
+using gameboy::RomImage;
+using gameboy::StateReader;
+using gameboy::StateWriter;
 
 bool Cartridge::load_rom_to_buffer(std::string file_name)
 {
-    char this_file_name[40];
-    uint8_t i = 0;
-    size_t read_byte;
-    //uint16_t address = 0x0000;
-
-    for (i = 0; i < file_name.length(); i++)
-        this_file_name[i] = file_name[i];
-    this_file_name[i] = '\0';
-
-    // read rom
-    if ((rom_file = fopen(this_file_name, "r+b")) == NULL) // read-only, binary
+    rom_image = RomImage::open(file_name);
+    rom_bytes = nullptr;
+    rom_size = 0;
+    if (!rom_image)
     {
-        printf("cannot open this file. Check your input.\n");
         return false;
     }
 
-    // put all rom data into rom buffer
-    read_byte = fread(rom_bytes, sizeof(uint8_t), ZELDA_SIZE, rom_file);
-    if (read_byte != ROM_SIZE && read_byte != ROM_SIZE / 2 && read_byte != ZELDA_SIZE)
+    // the header is in bank 0
+    if (rom_image->get_size() < ROM_MIN_SIZE)
     {
         printf("Rom size not supported!\n");
+        rom_image.reset();
         return false;
     }
-    rom_file = nullptr;
+    rom_bytes = rom_image->get_bytes();
     return true;
 }
 
 bool Cartridge::check_cartridge_headers(void)
 {
-    // check memory controller type (0x0147 in ROM is 01h)
+    // check memory controller type (0x0147)
+    has_battery = false;
+    has_rtc = false;
     switch (rom_bytes[CARTRIDGE_TYPE_ADDRESS])
     {
-    case 0x01:
+    case 0x00:
     {
-        // set bool
-        using_MBC1 = true;
-        not_supported_cartridge_mode = false;
-        printf("Cartridge Type: ROM + MBC1\n");
+        mapper_type = MapperType::mapper_rom_only;
+        printf("Cartridge Type: ROM only\n");
         break;
     }
+    case 0x01:
     case 0x02:
+    case 0x03:
     {
-        // set bool
-        using_MBC1_RAM = true;
-        not_supported_cartridge_mode = false;
-        printf("Cartridge Type: ROM + MBC1 + RAM\n");
-        printf("RAM switching restricted, game behoviour maybe abnormal!\n");
+        mapper_type = MapperType::mapper_mbc1;
+        has_battery = rom_bytes[CARTRIDGE_TYPE_ADDRESS] == 0x03;
+        static const char *mbc1_names[3] = {"", " + RAM", " + RAM + BATTERY"};
+        printf("Cartridge Type: ROM + MBC1%s\n", mbc1_names[rom_bytes[CARTRIDGE_TYPE_ADDRESS] - 0x01]);
         break;
     }
-    case 0x03:
+    case 0x05:
+    case 0x06:
     {
-        // set bool
-        using_MBC1_RAM = true;
-        not_supported_cartridge_mode = false;
-        printf("Cartridge Type: ROM + MBC1 + RAM + BATTERY\n");
-        printf("RAM switching restricted, game behoviour maybe abnormal!\n");
+        mapper_type = MapperType::mapper_mbc2;
+        has_battery = rom_bytes[CARTRIDGE_TYPE_ADDRESS] == 0x06;
+        printf("Cartridge Type: ROM + MBC2%s\n", has_battery ? " + BATTERY" : "");
         break;
     }
-    case 0x00:
+    case 0x08:
+    case 0x09:
     {
-        // set bool
-        using_ROM_only = true;
-        not_supported_cartridge_mode = false;
-        printf("Cartridge Type: ROM only\n");
+        mapper_type = MapperType::mapper_rom_only;
+        has_battery = rom_bytes[CARTRIDGE_TYPE_ADDRESS] == 0x09;
+        printf("Cartridge Type: ROM + RAM%s\n", has_battery ? " + BATTERY" : "");
+        break;
+    }
+    case 0x0F:
+    case 0x10:
+    case 0x11:
+    case 0x12:
+    case 0x13:
+    {
+        mapper_type = MapperType::mapper_mbc3;
+        has_rtc = rom_bytes[CARTRIDGE_TYPE_ADDRESS] <= 0x10;
+        has_battery = rom_bytes[CARTRIDGE_TYPE_ADDRESS] != 0x11 && rom_bytes[CARTRIDGE_TYPE_ADDRESS] != 0x12;
+        printf("Cartridge Type: ROM + MBC3%s%s\n", has_rtc ? " + TIMER" : "", has_battery ? " + BATTERY" : "");
+        break;
+    }
+    case 0x19:
+    case 0x1A:
+    case 0x1B:
+    case 0x1C:
+    case 0x1D:
+    case 0x1E:
+    {
+        // 0x1C~0x1E: rumble motor, not emulated
+        mapper_type = MapperType::mapper_mbc5;
+        has_battery = rom_bytes[CARTRIDGE_TYPE_ADDRESS] == 0x1B || rom_bytes[CARTRIDGE_TYPE_ADDRESS] == 0x1E;
+        printf("Cartridge Type: ROM + MBC5%s\n", has_battery ? " + BATTERY" : "");
         break;
     }
     default:
     {
-        not_supported_cartridge_mode = true;
         printf("Unsupported Cartridge Type!\n");
         return false;
     }
     }
 
-    // check ROM Size
-    switch (rom_bytes[ROM_SIZE_ADDRESS])
+    // check ROM Size: 32 KB << n, or the 72, 80 and 96 bank sizes
+    uint8_t rom_size_code = rom_bytes[ROM_SIZE_ADDRESS];
+    if (rom_size_code <= 0x08)
     {
-    case 0x01:
-    {
-        rom_attributes_bank_count = 4;
-        printf("ROM Banks: %d\n", rom_attributes_bank_count);
-        break;
+        rom_attributes_bank_count = 2 << rom_size_code;
     }
-    case 0x02:
+    else if (rom_size_code == 0x52 || rom_size_code == 0x53 || rom_size_code == 0x54)
     {
-        rom_attributes_bank_count = 8;
-        printf("ROM Banks: %d\n", rom_attributes_bank_count);
-        break;
+        static const uint16_t odd_bank_counts[3] = {72, 80, 96};
+        rom_attributes_bank_count = odd_bank_counts[rom_size_code - 0x52];
     }
-    case 0x03:
+    else
     {
-        rom_attributes_bank_count = 16;
-        printf("ROM Banks: %d\n", rom_attributes_bank_count);
-        break;
+        printf("False ROM Banks Count!\n");
+        return false;
     }
-    case 0x04:
+    if (rom_attributes_bank_count == 2)
     {
-        rom_attributes_bank_count = 32;
-        printf("ROM Banks: %d\n", rom_attributes_bank_count);
-        break;
+        printf("no ROM banking\n");
     }
-    case 0x00:
+    else
     {
-        rom_attributes_bank_count = 2;
-        printf("no ROM banking\n");
-        break;
+        printf("ROM Banks: %d\n", rom_attributes_bank_count);
     }
-    default:
+    rom_size = rom_attributes_bank_count * BANK_SIZE;
+    if (rom_image && rom_image->get_size() < rom_size)
     {
-        printf("False ROM Banks Count!\n");
+        printf("ROM file is %u bytes, shorter than the %u bytes in its header!\n", (unsigned)rom_image->get_size(), rom_size);
         return false;
     }
-    }
 
-    // check RAM Size
+    // check RAM Size, MBC2 has its own 512 x 4 bits
+    uint32_t temp_ram_size = 0;
     switch (rom_bytes[RAM_SIZE_ADDRESS])
     {
+    case 0x00:
+        temp_ram_size = 0;
+        break;
     case 0x01:
-    {
-        ram_attributes_bank_count = 1;
-        ram_attributes_bank_size = 2;
-        printf("RAM Banks: %d with size %d * %dkb\n", rom_attributes_bank_count, rom_attributes_bank_count, ram_attributes_bank_size);
+        temp_ram_size = 0x800;
         break;
-    }
     case 0x02:
-    {
-        ram_attributes_bank_count = 1;
-        ram_attributes_bank_size = 8;
-        printf("RAM Banks: %d with size %d * %dkb\n", rom_attributes_bank_count, rom_attributes_bank_count, ram_attributes_bank_size);
+        temp_ram_size = 0x2000;
         break;
-    }
     case 0x03:
-    {
-        ram_attributes_bank_count = 2;
-        ram_attributes_bank_size = 8;
-        printf("RAM Banks: %d with size %d * %dkb\n", rom_attributes_bank_count, rom_attributes_bank_count, ram_attributes_bank_size);
+        temp_ram_size = 0x8000;
         break;
-    }
     case 0x04:
-    {
-        ram_attributes_bank_count = 4;
-        ram_attributes_bank_size = 8;
-        printf("RAM Banks: %d with size %d * %dkb\n", rom_attributes_bank_count, rom_attributes_bank_count, ram_attributes_bank_size);
+        temp_ram_size = 0x20000;
         break;
-    }
-    case 0x00:
-    {
-        // set bool
-        rom_attributes_bank_count = 0;
-        printf("no RAM banking\n");
+    case 0x05:
+        temp_ram_size = 0x10000;
         break;
-    }
     default:
     {
         printf("False RAM Banks Count!\n");
         return false;
     }
     }
+    if (mapper_type == MapperType::mapper_mbc2)
+    {
+        temp_ram_size = MBC2_RAM_SIZE;
+    }
+    if (temp_ram_size == 0)
+    {
+        printf("no RAM banking\n");
+    }
+    else
+    {
+        printf("RAM: %u bytes\n", temp_ram_size);
+    }
+    ram_size = temp_ram_size;
     return true;
 }
 
-void Cartridge::switch_banks(uint8_t bank_number)
-{
-    uint8_t temp_number = bank_number;
-
-    // Values of 0 and 1 do the same thing and point to ROM bank 1.
-    if (temp_number == 0)
-        temp_number = 1;
-
-    mbc1_current_bank = temp_number;
-}
-
 void Cartridge::get_rom_name(void)
 {
     uint8_t i;
@@ -188,134 +187,113 @@ void Cartridge::get_rom_name(void)
     }
     rom_name[finish + 1] = '\0';
     printf("ROM name: %s\n", rom_name);
-    ppu_optimizaion();
 }
 
-bool Cartridge::power_on(std::string arg_rom_file)
+void Cartridge::open_ram(std::string save_path)
 {
-    // cartridge load
-    if (!load_rom_to_buffer(arg_rom_file))
+    // MBC2 stores 4 bits, the high ones read as 1
+    uint8_t temp_fill = (mapper_type == MapperType::mapper_mbc2) ? 0xF0 : 0x00;
+    if (save_path.empty())
     {
-        return false;
+        save_ram.allocate(ram_size, temp_fill);
     }
-    if (!check_cartridge_headers())
+    else
     {
-        return false;
+        save_ram.open(save_path, ram_size, temp_fill);
     }
-    get_rom_name();
-    return true;
+    ram_bytes = save_ram.get_bytes();
 }
 
-void Cartridge::ppu_optimizaion(void)
+void Cartridge::create_mapper(void)
 {
-    if (strcmp(rom_name, "BOXES") == 0)
-    {
-        auto_optimization = 4;
-    }
-    else if (strcmp(rom_name, "SUPER MARIOLAND") == 0)
-    {
-        auto_optimization = 1;
-        printf("Marioland: force compatibility mode.\n\n");
-    }
-    else if (strcmp(rom_name, "TETRIS") == 0)
-    {
-        auto_optimization = 4;
-    }
-    else if (strcmp(rom_name, "BATTLECITY") == 0)
-    {
-        auto_optimization = 4;
-    }
-    else if (strcmp(rom_name, "Opus Test") == 0)
-    {
-        auto_optimization = 4;
-    }
-    else if (strcmp(rom_name, "CPU_INSTRS") == 0)
+    mapper = Mapper::create(mapper_type, rom_bytes, rom_attributes_bank_count, ram_bytes, ram_size);
+    mapper->clock = clock;
+}
+
+bool Cartridge::power_on(std::string arg_rom_file)
+{
+    // cartridge load, the RAM of the last one goes back to its file
+    mapper.reset();
+    save_ram.close();
+    ram_bytes = nullptr;
+    if (!load_rom_to_buffer(arg_rom_file))
     {
-        auto_optimization = 1;
-        printf("Entering CPU test: running at original speed.\n");
-        printf("Please wait patiently untill it pass all the tests...\n\n");
+        return false;
     }
-    else
+    if (!check_cartridge_headers())
     {
-        auto_optimization = 4;
+        return false;
     }
-}
+    get_rom_name();
 
-uint8_t Cartridge::get_cartridge_byte(uint16_t address)
-{
-    if (using_MBC1 || using_MBC1_RAM)
+    // game.gb keeps its battery RAM in game.sav
+    std::string temp_save_path;
+    if (has_battery && ram_size && save_file_enabled)
     {
-        if (address < BANK_SIZE)
+        size_t temp_dot = arg_rom_file.find_last_of('.');
+        size_t temp_slash = arg_rom_file.find_last_of("/\\");
+        if (temp_dot == std::string::npos || (temp_slash != std::string::npos && temp_dot < temp_slash))
         {
-            // MBC ROM BANK 0
-            return rom_bytes[address];
+            temp_dot = arg_rom_file.size();
         }
-        // if not in ROM BANK 0
-        // eg: ROM BANK 2 begins at 0x8000
-        // we read 0x4000
-        // 0x8000=0x4000+(2-1)*0x4000
-        return rom_bytes[address + (mbc1_current_bank - 1) * BANK_SIZE];
+        temp_save_path = arg_rom_file.substr(0, temp_dot) + ".sav";
     }
-    return rom_bytes[address];
+    open_ram(temp_save_path);
+    create_mapper();
+    return true;
 }
 
-void Cartridge::set_cartridge_byte(uint16_t address, uint8_t byte)
+bool Cartridge::write_register(uint16_t address, uint8_t byte)
 {
-    if (using_MBC1 || using_MBC1_RAM)
+    if (!mapper)
     {
-        if (address >= MBC1_MAGIC_NUMBER_START_ADDRESS && address <= MBC1_MAGIC_NUMBER_END_ADDRESS)
-        {
-            uint8_t switch_target = byte & 0x1F;
-
-#ifdef DEBUG
-            printf("Switching bank to %d\n", switch_target);
-#endif
-            switch_banks(switch_target);
-            return;
-        }
-#ifdef DEBUG
-        printf("ROM is Trying to set address %d to byte %d, MBC1\n", address, byte);
-#endif
-        return;
+        return false;
     }
+    // the page tables only need the mapped pointers, most writes keep them
+    const uint8_t *temp_rom_bank_0_bytes = mapper->rom_bank_0_bytes;
+    const uint8_t *temp_rom_bank_1_bytes = mapper->rom_bank_1_bytes;
+    const uint8_t *temp_ram_window = mapper->ram_window;
+    uint16_t temp_ram_window_mask = mapper->ram_window_mask;
+    bool temp_ram_writable = mapper->ram_writable;
 #ifdef DEBUG
-    printf("ROM is Trying to set address %d to byte %d, ROM ONLY\n", address, byte);
+    printf("MBC register %04x = %02x\n", address, byte);
 #endif
+    mapper->write_register(address, byte);
+    return mapper->rom_bank_0_bytes != temp_rom_bank_0_bytes || mapper->rom_bank_1_bytes != temp_rom_bank_1_bytes ||
+           mapper->ram_window != temp_ram_window || mapper->ram_window_mask != temp_ram_window_mask ||
+           mapper->ram_writable != temp_ram_writable;
 }
 
-uint16_t Cartridge::get_cartridge_word(uint16_t address)
+void Cartridge::write_ram(uint16_t address, uint8_t byte)
 {
-    uint16_t byte_low = 0x0000;
-    uint16_t byte_high = 0x0000;
-
-    if (using_MBC1 || using_MBC1_RAM)
+    if (mapper)
     {
-        if (address < BANK_SIZE)
-        {
-            // MBC ROM BANK 0
-            byte_low = (rom_bytes[address] & 0xffff);
-            byte_high = ((rom_bytes[address + 1] << 8) & 0xffff);
-            return (byte_low | byte_high);
-        }
-        // if not in ROM BANK 0
-        // eg: ROM BANK 2 begins at 0x8000
-        // we read 0x4000
-        // 0x8000=0x4000+(2-1)*0x4000
-        byte_low = (rom_bytes[address + (mbc1_current_bank - 1) * BANK_SIZE] & 0xffff);
-        byte_high = ((rom_bytes[address + (mbc1_current_bank - 1) * BANK_SIZE + 1] << 8) & 0xffff);
-        return (byte_low | byte_high);
+        mapper->write_ram(address, byte);
     }
+}
 
-    byte_low = (rom_bytes[address] & 0xffff);
-    byte_high = ((rom_bytes[address + 1] << 8) & 0xffff);
-
-    return (byte_low | byte_high);
+void Cartridge::save_state(StateWriter &writer)
+{
+    writer.put_byte(mapper_type);
+    if (mapper)
+    {
+        mapper->save_state(writer);
+    }
+    writer.put_dword(ram_size);
+    writer.put_bytes(ram_bytes, ram_size);
 }
 
-void Cartridge::set_cartridge_word(uint16_t address, uint16_t word)
+bool Cartridge::load_state(StateReader &reader)
 {
-// do nothing except print error
-#ifdef DEBUG
-    printf("ROM is Trying to set address %d to word %d\n", address, word);
-#endif
+    // same ROM, so the same mapper and RAM size
+    if (reader.get_byte() != mapper_type || !mapper || !mapper->load_state(reader))
+    {
+        return false;
+    }
+    if (reader.get_dword() != ram_size)
+    {
+        return false;
+    }
+    reader.get_bytes(ram_bytes, ram_size);
+    return !reader.failed();
 }
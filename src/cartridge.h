@@ -1,22 +1,22 @@
 #ifndef GAMEBOY_CARTRIDGE_H
 #define GAMEBOY_CARTRIDGE_H
 
+#include "mapper.h"
+#include "rom-image.h"
+#include "save-ram.h"
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <math.h>
 #include <cstring>
 
-// target is Super Mario Land (64 KB)
-#define ROM_SIZE 65536
-#define ZELDA_SIZE 524288
 #define CARTRIDGE_TYPE_ADDRESS 0x0147
 #define ROM_SIZE_ADDRESS 0x0148
 #define RAM_SIZE_ADDRESS 0x0149
-#define BANK_SIZE 0x4000
-
-#define MBC1_MAGIC_NUMBER_START_ADDRESS 0x1FFF
-#define MBC1_MAGIC_NUMBER_END_ADDRESS 0x4000
+// Smallest ROM: bank 0 and bank 1
+#define ROM_MIN_SIZE 0x8000
 
 
 namespace gameboy
@@ -25,38 +25,56 @@ namespace gameboy
 class Cartridge
 {
 public:
-    bool using_ROM_only = false;
-    bool using_MBC1 = false;
-    bool using_MBC1_RAM = false;
-    bool not_supported_cartridge_mode = true;
-
-    uint8_t mbc1_current_bank = 1;
-    uint16_t mbc1_trigger_address = 0;
-    uint8_t rom_attributes_bank_count = 0;
-    uint8_t ram_attributes_bank_count = 0;
-    uint8_t ram_attributes_bank_size = 0;// in kb
-    uint8_t rom_bytes[524288] = {0};
+    // From the header (0x0147)
+    MapperType mapper_type = MapperType::mapper_rom_only;
+    bool has_battery = false;
+    bool has_rtc = false;
+
+    uint16_t rom_attributes_bank_count = 0;
+    // ROM image shared with every cartridge running the same file, see src/rom-image.h
+    // rom_bytes points into it, rom_size is rom_attributes_bank_count banks (header 0x0148)
+    std::shared_ptr<const RomImage> rom_image;
+    const uint8_t *rom_bytes = nullptr;
+    uint32_t rom_size = 0;
+    // Cartridge RAM, the size comes from the header (0x0149), 512 bytes for MBC2
+    // With a battery it is the .sav file next to the ROM, see src/save-ram.h
+    // ram_bytes points into save_ram
+    SaveRam save_ram;
+    uint8_t *ram_bytes = nullptr;
+    uint32_t ram_size = 0;
+    // Off: battery RAM is not kept in a .sav file (batch runs stay independent)
+    bool save_file_enabled = true;
     char rom_name[16];
-    uint8_t auto_optimization = 1;
 
-    FILE *rom_file;
+    // Bank registers, created by power_on, see src/mapper.h
+    std::unique_ptr<Mapper> mapper;
+    // Emulated time for the MBC3 clock, set by the motherboard
+    const uint64_t *clock = nullptr;
 
+    // Open the shared image of the file, the size is checked against the header by check_cartridge_headers
     bool load_rom_to_buffer(std::string file_name);
     bool check_cartridge_headers(void);
-    void load_rom_to_ram(void);
-    void switch_banks(uint8_t bank_number);
     void get_rom_name(void);
+    // CRC-32 of the file, 0 without an image (computed on first use, see RomImage::get_checksum)
+    uint32_t get_rom_checksum(void)
+    {
+        return rom_image ? rom_image->get_checksum() : 0;
+    }
+    // ram_size bytes of RAM, from save_path when it is not empty
+    void open_ram(std::string save_path);
+    // Fresh mapper for the loaded ROM and RAM
+    void create_mapper(void);
     bool power_on(std::string arg_rom_file);
 
-    void ppu_optimizaion(void);
-
-    // cartridge get and set byte
-    uint8_t get_cartridge_byte(uint16_t address);
-    void set_cartridge_byte(uint16_t address, uint8_t byte);
+    // Write to 0x0000~0x7FFF, return true if the mapped banks changed
+    bool write_register(uint16_t address, uint8_t byte);
+    // Write to 0xA000~0xBFFF the page tables do not take
+    void write_ram(uint16_t address, uint8_t byte);
 
-    // cartridge get and set word
-    uint16_t get_cartridge_word(uint16_t address);
-    void set_cartridge_word(uint16_t address, uint16_t word);
+    // Save states: mapper type and registers, then the RAM
+    // Memory::map_cartridge_pages has to follow a load
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
 };
 } // namespace gameboy
 
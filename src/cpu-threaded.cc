@@ -0,0 +1,631 @@
+// Threaded interpreter
+// Every handler ends with its own copy of the dispatch code and jumps
+// straight to the handler of the next opcode (GCC labels as values).
+// Handlers are called directly, so there is no member function pointer
+// call or return between two instructions.
+// The function table in cpu.h stays the portable core: Cpu::run_table
+
+#include "cpu.h"
+
+#ifdef GAMEBOY_THREADED_INTERPRETER
+
+using gameboy::Cpu;
+using gameboy::Memory;
+
+// Go back to the slow path on deadline, pending interrupt, HALT or idle loop,
+// otherwise fetch and jump to the next handler
+#define THREADED_DISPATCH()                                                              \
+    instruction_count++;                                                                 \
+    if (clock >= deadline || f_halted || idle_loop_hit ||                                \
+        (f_enable_interrupts && (mem.memory_byte[0xff0f] & mem.memory_byte[0xffff]))) \
+    {                                                                                    \
+        goto slow_path;                                                                  \
+    }                                                                                    \
+    temp_opcode_main = read_opcode_byte(mem);                                            \
+    goto *dispatch_main[temp_opcode_main];
+
+// Main opcode handled by ex_ function
+// handler may be a template with several arguments, so it is __VA_ARGS__
+#define THREADED_MAIN(code, ...)                                     \
+    main_##code : __VA_ARGS__(mem, 0x##code, temp_opcode_prefix_cb); \
+    clock += 4 * opcode_cycle_main[0x##code];                        \
+    THREADED_DISPATCH();
+
+// Prefix CB opcode handled by ex_ function
+#define THREADED_PREFIX_CB(code, ...)                 \
+    prefix_cb_##code : __VA_ARGS__(mem, 0x##code);    \
+    clock += 4 * opcode_cycle_prefix_cb[0x##code];    \
+    THREADED_DISPATCH();
+
+// Run until clock reaches deadline
+// Same behaviour as calling Cpu::next in a loop
+void Cpu::run_threaded(Memory &mem, uint64_t &clock, const uint64_t &deadline)
+{
+    static void *const dispatch_main[256] = {
+        //  0 ~ f
+        &&main_00, &&main_01, &&main_02, &&main_03, &&main_04, &&main_05, &&main_06, &&main_07, &&main_08, &&main_09, &&main_0a, &&main_0b, &&main_0c, &&main_0d, &&main_0e, &&main_0f, // 0
+        &&main_10, &&main_11, &&main_12, &&main_13, &&main_14, &&main_15, &&main_16, &&main_17, &&main_18, &&main_19, &&main_1a, &&main_1b, &&main_1c, &&main_1d, &&main_1e, &&main_1f, // 1
+        &&main_20, &&main_21, &&main_22, &&main_23, &&main_24, &&main_25, &&main_26, &&main_27, &&main_28, &&main_29, &&main_2a, &&main_2b, &&main_2c, &&main_2d, &&main_2e, &&main_2f, // 2
+        &&main_30, &&main_31, &&main_32, &&main_33, &&main_34, &&main_35, &&main_36, &&main_37, &&main_38, &&main_39, &&main_3a, &&main_3b, &&main_3c, &&main_3d, &&main_3e, &&main_3f, // 3
+        &&main_40, &&main_41, &&main_42, &&main_43, &&main_44, &&main_45, &&main_46, &&main_47, &&main_48, &&main_49, &&main_4a, &&main_4b, &&main_4c, &&main_4d, &&main_4e, &&main_4f, // 4
+        &&main_50, &&main_51, &&main_52, &&main_53, &&main_54, &&main_55, &&main_56, &&main_57, &&main_58, &&main_59, &&main_5a, &&main_5b, &&main_5c, &&main_5d, &&main_5e, &&main_5f, // 5
+        &&main_60, &&main_61, &&main_62, &&main_63, &&main_64, &&main_65, &&main_66, &&main_67, &&main_68, &&main_69, &&main_6a, &&main_6b, &&main_6c, &&main_6d, &&main_6e, &&main_6f, // 6
+        &&main_70, &&main_71, &&main_72, &&main_73, &&main_74, &&main_75, &&main_76, &&main_77, &&main_78, &&main_79, &&main_7a, &&main_7b, &&main_7c, &&main_7d, &&main_7e, &&main_7f, // 7
+        &&main_80, &&main_81, &&main_82, &&main_83, &&main_84, &&main_85, &&main_86, &&main_87, &&main_88, &&main_89, &&main_8a, &&main_8b, &&main_8c, &&main_8d, &&main_8e, &&main_8f, // 8
+        &&main_90, &&main_91, &&main_92, &&main_93, &&main_94, &&main_95, &&main_96, &&main_97, &&main_98, &&main_99, &&main_9a, &&main_9b, &&main_9c, &&main_9d, &&main_9e, &&main_9f, // 9
+        &&main_a0, &&main_a1, &&main_a2, &&main_a3, &&main_a4, &&main_a5, &&main_a6, &&main_a7, &&main_a8, &&main_a9, &&main_aa, &&main_ab, &&main_ac, &&main_ad, &&main_ae, &&main_af, // a
+        &&main_b0, &&main_b1, &&main_b2, &&main_b3, &&main_b4, &&main_b5, &&main_b6, &&main_b7, &&main_b8, &&main_b9, &&main_ba, &&main_bb, &&main_bc, &&main_bd, &&main_be, &&main_bf, // b
+        &&main_c0, &&main_c1, &&main_c2, &&main_c3, &&main_c4, &&main_c5, &&main_c6, &&main_c7, &&main_c8, &&main_c9, &&main_ca, &&main_cb, &&main_cc, &&main_cd, &&main_ce, &&main_cf, // c
+        &&main_d0, &&main_d1, &&main_d2, &&main_illegal, &&main_d4, &&main_d5, &&main_d6, &&main_d7, &&main_d8, &&main_d9, &&main_da, &&main_illegal, &&main_dc, &&main_illegal, &&main_de, &&main_df, // d
+        &&main_e0, &&main_e1, &&main_e2, &&main_illegal, &&main_illegal, &&main_e5, &&main_e6, &&main_e7, &&main_e8, &&main_e9, &&main_ea, &&main_illegal, &&main_illegal, &&main_illegal, &&main_ee, &&main_ef, // e
+        &&main_f0, &&main_f1, &&main_f2, &&main_f3, &&main_illegal, &&main_f5, &&main_f6, &&main_f7, &&main_f8, &&main_f9, &&main_fa, &&main_fb, &&main_illegal, &&main_illegal, &&main_fe, &&main_ff, // f
+    };
+
+    static void *const dispatch_prefix_cb[256] = {
+        //  0 ~ f
+        &&prefix_cb_00, &&prefix_cb_01, &&prefix_cb_02, &&prefix_cb_03, &&prefix_cb_04, &&prefix_cb_05, &&prefix_cb_06, &&prefix_cb_07, &&prefix_cb_08, &&prefix_cb_09, &&prefix_cb_0a, &&prefix_cb_0b, &&prefix_cb_0c, &&prefix_cb_0d, &&prefix_cb_0e, &&prefix_cb_0f, // 0
+        &&prefix_cb_10, &&prefix_cb_11, &&prefix_cb_12, &&prefix_cb_13, &&prefix_cb_14, &&prefix_cb_15, &&prefix_cb_16, &&prefix_cb_17, &&prefix_cb_18, &&prefix_cb_19, &&prefix_cb_1a, &&prefix_cb_1b, &&prefix_cb_1c, &&prefix_cb_1d, &&prefix_cb_1e, &&prefix_cb_1f, // 1
+        &&prefix_cb_20, &&prefix_cb_21, &&prefix_cb_22, &&prefix_cb_23, &&prefix_cb_24, &&prefix_cb_25, &&prefix_cb_26, &&prefix_cb_27, &&prefix_cb_28, &&prefix_cb_29, &&prefix_cb_2a, &&prefix_cb_2b, &&prefix_cb_2c, &&prefix_cb_2d, &&prefix_cb_2e, &&prefix_cb_2f, // 2
+        &&prefix_cb_30, &&prefix_cb_31, &&prefix_cb_32, &&prefix_cb_33, &&prefix_cb_34, &&prefix_cb_35, &&prefix_cb_36, &&prefix_cb_37, &&prefix_cb_38, &&prefix_cb_39, &&prefix_cb_3a, &&prefix_cb_3b, &&prefix_cb_3c, &&prefix_cb_3d, &&prefix_cb_3e, &&prefix_cb_3f, // 3
+        &&prefix_cb_40, &&prefix_cb_41, &&prefix_cb_42, &&prefix_cb_43, &&prefix_cb_44, &&prefix_cb_45, &&prefix_cb_46, &&prefix_cb_47, &&prefix_cb_48, &&prefix_cb_49, &&prefix_cb_4a, &&prefix_cb_4b, &&prefix_cb_4c, &&prefix_cb_4d, &&prefix_cb_4e, &&prefix_cb_4f, // 4
+        &&prefix_cb_50, &&prefix_cb_51, &&prefix_cb_52, &&prefix_cb_53, &&prefix_cb_54, &&prefix_cb_55, &&prefix_cb_56, &&prefix_cb_57, &&prefix_cb_58, &&prefix_cb_59, &&prefix_cb_5a, &&prefix_cb_5b, &&prefix_cb_5c, &&prefix_cb_5d, &&prefix_cb_5e, &&prefix_cb_5f, // 5
+        &&prefix_cb_60, &&prefix_cb_61, &&prefix_cb_62, &&prefix_cb_63, &&prefix_cb_64, &&prefix_cb_65, &&prefix_cb_66, &&prefix_cb_67, &&prefix_cb_68, &&prefix_cb_69, &&prefix_cb_6a, &&prefix_cb_6b, &&prefix_cb_6c, &&prefix_cb_6d, &&prefix_cb_6e, &&prefix_cb_6f, // 6
+        &&prefix_cb_70, &&prefix_cb_71, &&prefix_cb_72, &&prefix_cb_73, &&prefix_cb_74, &&prefix_cb_75, &&prefix_cb_76, &&prefix_cb_77, &&prefix_cb_78, &&prefix_cb_79, &&prefix_cb_7a, &&prefix_cb_7b, &&prefix_cb_7c, &&prefix_cb_7d, &&prefix_cb_7e, &&prefix_cb_7f, // 7
+        &&prefix_cb_80, &&prefix_cb_81, &&prefix_cb_82, &&prefix_cb_83, &&prefix_cb_84, &&prefix_cb_85, &&prefix_cb_86, &&prefix_cb_87, &&prefix_cb_88, &&prefix_cb_89, &&prefix_cb_8a, &&prefix_cb_8b, &&prefix_cb_8c, &&prefix_cb_8d, &&prefix_cb_8e, &&prefix_cb_8f, // 8
+        &&prefix_cb_90, &&prefix_cb_91, &&prefix_cb_92, &&prefix_cb_93, &&prefix_cb_94, &&prefix_cb_95, &&prefix_cb_96, &&prefix_cb_97, &&prefix_cb_98, &&prefix_cb_99, &&prefix_cb_9a, &&prefix_cb_9b, &&prefix_cb_9c, &&prefix_cb_9d, &&prefix_cb_9e, &&prefix_cb_9f, // 9
+        &&prefix_cb_a0, &&prefix_cb_a1, &&prefix_cb_a2, &&prefix_cb_a3, &&prefix_cb_a4, &&prefix_cb_a5, &&prefix_cb_a6, &&prefix_cb_a7, &&prefix_cb_a8, &&prefix_cb_a9, &&prefix_cb_aa, &&prefix_cb_ab, &&prefix_cb_ac, &&prefix_cb_ad, &&prefix_cb_ae, &&prefix_cb_af, // a
+        &&prefix_cb_b0, &&prefix_cb_b1, &&prefix_cb_b2, &&prefix_cb_b3, &&prefix_cb_b4, &&prefix_cb_b5, &&prefix_cb_b6, &&prefix_cb_b7, &&prefix_cb_b8, &&prefix_cb_b9, &&prefix_cb_ba, &&prefix_cb_bb, &&prefix_cb_bc, &&prefix_cb_bd, &&prefix_cb_be, &&prefix_cb_bf, // b
+        &&prefix_cb_c0, &&prefix_cb_c1, &&prefix_cb_c2, &&prefix_cb_c3, &&prefix_cb_c4, &&prefix_cb_c5, &&prefix_cb_c6, &&prefix_cb_c7, &&prefix_cb_c8, &&prefix_cb_c9, &&prefix_cb_ca, &&prefix_cb_cb, &&prefix_cb_cc, &&prefix_cb_cd, &&prefix_cb_ce, &&prefix_cb_cf, // c
+        &&prefix_cb_d0, &&prefix_cb_d1, &&prefix_cb_d2, &&prefix_cb_d3, &&prefix_cb_d4, &&prefix_cb_d5, &&prefix_cb_d6, &&prefix_cb_d7, &&prefix_cb_d8, &&prefix_cb_d9, &&prefix_cb_da, &&prefix_cb_db, &&prefix_cb_dc, &&prefix_cb_dd, &&prefix_cb_de, &&prefix_cb_df, // d
+        &&prefix_cb_e0, &&prefix_cb_e1, &&prefix_cb_e2, &&prefix_cb_e3, &&prefix_cb_e4, &&prefix_cb_e5, &&prefix_cb_e6, &&prefix_cb_e7, &&prefix_cb_e8, &&prefix_cb_e9, &&prefix_cb_ea, &&prefix_cb_eb, &&prefix_cb_ec, &&prefix_cb_ed, &&prefix_cb_ee, &&prefix_cb_ef, // e
+        &&prefix_cb_f0, &&prefix_cb_f1, &&prefix_cb_f2, &&prefix_cb_f3, &&prefix_cb_f4, &&prefix_cb_f5, &&prefix_cb_f6, &&prefix_cb_f7, &&prefix_cb_f8, &&prefix_cb_f9, &&prefix_cb_fa, &&prefix_cb_fb, &&prefix_cb_fc, &&prefix_cb_fd, &&prefix_cb_fe, &&prefix_cb_ff, // f
+    };
+
+    uint8_t temp_opcode_main = 0x00;
+    uint8_t temp_opcode_prefix_cb = 0x00;
+    uint8_t temp_cycle = 0;
+
+    // events may have changed memory since the last run
+    idle_loop_armed = false;
+
+slow_path:
+    while (clock < deadline)
+    {
+        // a branch found an idle loop, see Cpu::check_idle_loop
+        if (idle_loop_hit)
+        {
+            skip_idle_loop(clock, deadline);
+            continue;
+        }
+        // interrupts and HALT
+        temp_cycle = handle_interrupts(mem);
+        if (temp_cycle)
+        {
+            clock += 4 * temp_cycle;
+            continue;
+        }
+        if (f_halted)
+        {
+            // no interrupt was requested, see Cpu::skip_halt
+            skip_halt(clock, deadline);
+            continue;
+        }
+
+        temp_opcode_main = read_opcode_byte(mem);
+        goto *dispatch_main[temp_opcode_main];
+
+    main_cb:
+        temp_opcode_prefix_cb = read_opcode_byte(mem);
+        goto *dispatch_prefix_cb[temp_opcode_prefix_cb];
+
+    main_illegal:
+        // no handler, same as the function table
+        (this->*handle_opcode_main[temp_opcode_main])(mem, temp_opcode_main, temp_opcode_prefix_cb);
+        clock += 4 * opcode_cycle_main[temp_opcode_main];
+        THREADED_DISPATCH();
+
+        THREADED_MAIN(00, ex_nop)
+        THREADED_MAIN(01, ex_ld_imm_to_pair<PairName::p_bc>)
+        THREADED_MAIN(02, ex_ld_byte_to_pair_mem<PairName::p_bc>)
+        THREADED_MAIN(03, ex_inc_pair<PairName::p_bc>)
+        THREADED_MAIN(04, ex_inc_byte<RegisterName::r_b>)
+        THREADED_MAIN(05, ex_dec_byte<RegisterName::r_b>)
+        THREADED_MAIN(06, ex_ld_imm_to_byte<RegisterName::r_b>)
+        THREADED_MAIN(07, ex_rlca)
+        THREADED_MAIN(08, ex_ld_sp_to_mem)
+        THREADED_MAIN(09, ex_add_pair_to_hl<PairName::p_bc>)
+        THREADED_MAIN(0a, ex_ld_pair_mem_to_byte<PairName::p_bc>)
+        THREADED_MAIN(0b, ex_dec_pair<PairName::p_bc>)
+        THREADED_MAIN(0c, ex_inc_byte<RegisterName::r_c>)
+        THREADED_MAIN(0d, ex_dec_byte<RegisterName::r_c>)
+        THREADED_MAIN(0e, ex_ld_imm_to_byte<RegisterName::r_c>)
+        THREADED_MAIN(0f, ex_rrca)
+        THREADED_MAIN(10, ex_stop)
+        THREADED_MAIN(11, ex_ld_imm_to_pair<PairName::p_de>)
+        THREADED_MAIN(12, ex_ld_byte_to_pair_mem<PairName::p_de>)
+        THREADED_MAIN(13, ex_inc_pair<PairName::p_de>)
+        THREADED_MAIN(14, ex_inc_byte<RegisterName::r_d>)
+        THREADED_MAIN(15, ex_dec_byte<RegisterName::r_d>)
+        THREADED_MAIN(16, ex_ld_imm_to_byte<RegisterName::r_d>)
+        THREADED_MAIN(17, ex_rla)
+        THREADED_MAIN(18, ex_jr)
+        THREADED_MAIN(19, ex_add_pair_to_hl<PairName::p_de>)
+        THREADED_MAIN(1a, ex_ld_pair_mem_to_byte<PairName::p_de>)
+        THREADED_MAIN(1b, ex_dec_pair<PairName::p_de>)
+        THREADED_MAIN(1c, ex_inc_byte<RegisterName::r_e>)
+        THREADED_MAIN(1d, ex_dec_byte<RegisterName::r_e>)
+        THREADED_MAIN(1e, ex_ld_imm_to_byte<RegisterName::r_e>)
+        THREADED_MAIN(1f, ex_rra)
+        THREADED_MAIN(20, ex_jr_nz)
+        THREADED_MAIN(21, ex_ld_imm_to_pair<PairName::p_hl>)
+        THREADED_MAIN(22, ex_ldi_byte_to_hl_mem)
+        THREADED_MAIN(23, ex_inc_pair<PairName::p_hl>)
+        THREADED_MAIN(24, ex_inc_byte<RegisterName::r_h>)
+        THREADED_MAIN(25, ex_dec_byte<RegisterName::r_h>)
+        THREADED_MAIN(26, ex_ld_imm_to_byte<RegisterName::r_h>)
+        THREADED_MAIN(27, ex_daa_byte)
+        THREADED_MAIN(28, ex_jr_z)
+        THREADED_MAIN(29, ex_add_pair_to_hl<PairName::p_hl>)
+        THREADED_MAIN(2a, ex_ldi_hl_mem_to_byte)
+        THREADED_MAIN(2b, ex_dec_pair<PairName::p_hl>)
+        THREADED_MAIN(2c, ex_inc_byte<RegisterName::r_l>)
+        THREADED_MAIN(2d, ex_dec_byte<RegisterName::r_l>)
+        THREADED_MAIN(2e, ex_ld_imm_to_byte<RegisterName::r_l>)
+        THREADED_MAIN(2f, ex_cpl_byte)
+        THREADED_MAIN(30, ex_jr_nc)
+        THREADED_MAIN(31, ex_ld_imm_to_sp)
+        THREADED_MAIN(32, ex_ldd_byte_to_hl_mem)
+        THREADED_MAIN(33, ex_inc_sp)
+        THREADED_MAIN(34, ex_inc_hl_mem)
+        THREADED_MAIN(35, ex_dec_hl_mem)
+        THREADED_MAIN(36, ex_ld_imm_to_hl_mem)
+        THREADED_MAIN(37, ex_scf_byte)
+        THREADED_MAIN(38, ex_jr_c)
+        THREADED_MAIN(39, ex_add_sp_to_hl)
+        THREADED_MAIN(3a, ex_ldd_hl_mem_to_byte)
+        THREADED_MAIN(3b, ex_dec_sp)
+        THREADED_MAIN(3c, ex_inc_byte<RegisterName::r_a>)
+        THREADED_MAIN(3d, ex_dec_byte<RegisterName::r_a>)
+        THREADED_MAIN(3e, ex_ld_imm_to_byte<RegisterName::r_a>)
+        THREADED_MAIN(3f, ex_ccf_byte)
+        THREADED_MAIN(40, ex_ld_byte<RegisterName::r_b, RegisterName::r_b>)
+        THREADED_MAIN(41, ex_ld_byte<RegisterName::r_b, RegisterName::r_c>)
+        THREADED_MAIN(42, ex_ld_byte<RegisterName::r_b, RegisterName::r_d>)
+        THREADED_MAIN(43, ex_ld_byte<RegisterName::r_b, RegisterName::r_e>)
+        THREADED_MAIN(44, ex_ld_byte<RegisterName::r_b, RegisterName::r_h>)
+        THREADED_MAIN(45, ex_ld_byte<RegisterName::r_b, RegisterName::r_l>)
+        THREADED_MAIN(46, ex_ld_hl_mem_to_byte<RegisterName::r_b>)
+        THREADED_MAIN(47, ex_ld_byte<RegisterName::r_b, RegisterName::r_a>)
+        THREADED_MAIN(48, ex_ld_byte<RegisterName::r_c, RegisterName::r_b>)
+        THREADED_MAIN(49, ex_ld_byte<RegisterName::r_c, RegisterName::r_c>)
+        THREADED_MAIN(4a, ex_ld_byte<RegisterName::r_c, RegisterName::r_d>)
+        THREADED_MAIN(4b, ex_ld_byte<RegisterName::r_c, RegisterName::r_e>)
+        THREADED_MAIN(4c, ex_ld_byte<RegisterName::r_c, RegisterName::r_h>)
+        THREADED_MAIN(4d, ex_ld_byte<RegisterName::r_c, RegisterName::r_l>)
+        THREADED_MAIN(4e, ex_ld_hl_mem_to_byte<RegisterName::r_c>)
+        THREADED_MAIN(4f, ex_ld_byte<RegisterName::r_c, RegisterName::r_a>)
+        THREADED_MAIN(50, ex_ld_byte<RegisterName::r_d, RegisterName::r_b>)
+        THREADED_MAIN(51, ex_ld_byte<RegisterName::r_d, RegisterName::r_c>)
+        THREADED_MAIN(52, ex_ld_byte<RegisterName::r_d, RegisterName::r_d>)
+        THREADED_MAIN(53, ex_ld_byte<RegisterName::r_d, RegisterName::r_e>)
+        THREADED_MAIN(54, ex_ld_byte<RegisterName::r_d, RegisterName::r_h>)
+        THREADED_MAIN(55, ex_ld_byte<RegisterName::r_d, RegisterName::r_l>)
+        THREADED_MAIN(56, ex_ld_hl_mem_to_byte<RegisterName::r_d>)
+        THREADED_MAIN(57, ex_ld_byte<RegisterName::r_d, RegisterName::r_a>)
+        THREADED_MAIN(58, ex_ld_byte<RegisterName::r_e, RegisterName::r_b>)
+        THREADED_MAIN(59, ex_ld_byte<RegisterName::r_e, RegisterName::r_c>)
+        THREADED_MAIN(5a, ex_ld_byte<RegisterName::r_e, RegisterName::r_d>)
+        THREADED_MAIN(5b, ex_ld_byte<RegisterName::r_e, RegisterName::r_e>)
+        THREADED_MAIN(5c, ex_ld_byte<RegisterName::r_e, RegisterName::r_h>)
+        THREADED_MAIN(5d, ex_ld_byte<RegisterName::r_e, RegisterName::r_l>)
+        THREADED_MAIN(5e, ex_ld_hl_mem_to_byte<RegisterName::r_e>)
+        THREADED_MAIN(5f, ex_ld_byte<RegisterName::r_e, RegisterName::r_a>)
+        THREADED_MAIN(60, ex_ld_byte<RegisterName::r_h, RegisterName::r_b>)
+        THREADED_MAIN(61, ex_ld_byte<RegisterName::r_h, RegisterName::r_c>)
+        THREADED_MAIN(62, ex_ld_byte<RegisterName::r_h, RegisterName::r_d>)
+        THREADED_MAIN(63, ex_ld_byte<RegisterName::r_h, RegisterName::r_e>)
+        THREADED_MAIN(64, ex_ld_byte<RegisterName::r_h, RegisterName::r_h>)
+        THREADED_MAIN(65, ex_ld_byte<RegisterName::r_h, RegisterName::r_l>)
+        THREADED_MAIN(66, ex_ld_hl_mem_to_byte<RegisterName::r_h>)
+        THREADED_MAIN(67, ex_ld_byte<RegisterName::r_h, RegisterName::r_a>)
+        THREADED_MAIN(68, ex_ld_byte<RegisterName::r_l, RegisterName::r_b>)
+        THREADED_MAIN(69, ex_ld_byte<RegisterName::r_l, RegisterName::r_c>)
+        THREADED_MAIN(6a, ex_ld_byte<RegisterName::r_l, RegisterName::r_d>)
+        THREADED_MAIN(6b, ex_ld_byte<RegisterName::r_l, RegisterName::r_e>)
+        THREADED_MAIN(6c, ex_ld_byte<RegisterName::r_l, RegisterName::r_h>)
+        THREADED_MAIN(6d, ex_ld_byte<RegisterName::r_l, RegisterName::r_l>)
+        THREADED_MAIN(6e, ex_ld_hl_mem_to_byte<RegisterName::r_l>)
+        THREADED_MAIN(6f, ex_ld_byte<RegisterName::r_l, RegisterName::r_a>)
+        THREADED_MAIN(70, ex_ld_byte_to_hl_mem<RegisterName::r_b>)
+        THREADED_MAIN(71, ex_ld_byte_to_hl_mem<RegisterName::r_c>)
+        THREADED_MAIN(72, ex_ld_byte_to_hl_mem<RegisterName::r_d>)
+        THREADED_MAIN(73, ex_ld_byte_to_hl_mem<RegisterName::r_e>)
+        THREADED_MAIN(74, ex_ld_byte_to_hl_mem<RegisterName::r_h>)
+        THREADED_MAIN(75, ex_ld_byte_to_hl_mem<RegisterName::r_l>)
+        THREADED_MAIN(76, ex_halt)
+        THREADED_MAIN(77, ex_ld_byte_to_hl_mem<RegisterName::r_a>)
+        THREADED_MAIN(78, ex_ld_byte<RegisterName::r_a, RegisterName::r_b>)
+        THREADED_MAIN(79, ex_ld_byte<RegisterName::r_a, RegisterName::r_c>)
+        THREADED_MAIN(7a, ex_ld_byte<RegisterName::r_a, RegisterName::r_d>)
+        THREADED_MAIN(7b, ex_ld_byte<RegisterName::r_a, RegisterName::r_e>)
+        THREADED_MAIN(7c, ex_ld_byte<RegisterName::r_a, RegisterName::r_h>)
+        THREADED_MAIN(7d, ex_ld_byte<RegisterName::r_a, RegisterName::r_l>)
+        THREADED_MAIN(7e, ex_ld_hl_mem_to_byte<RegisterName::r_a>)
+        THREADED_MAIN(7f, ex_ld_byte<RegisterName::r_a, RegisterName::r_a>)
+        THREADED_MAIN(80, ex_add_byte<RegisterName::r_b>)
+        THREADED_MAIN(81, ex_add_byte<RegisterName::r_c>)
+        THREADED_MAIN(82, ex_add_byte<RegisterName::r_d>)
+        THREADED_MAIN(83, ex_add_byte<RegisterName::r_e>)
+        THREADED_MAIN(84, ex_add_byte<RegisterName::r_h>)
+        THREADED_MAIN(85, ex_add_byte<RegisterName::r_l>)
+        THREADED_MAIN(86, ex_add_hl_mem)
+        THREADED_MAIN(87, ex_add_byte<RegisterName::r_a>)
+        THREADED_MAIN(88, ex_adc_byte<RegisterName::r_b>)
+        THREADED_MAIN(89, ex_adc_byte<RegisterName::r_c>)
+        THREADED_MAIN(8a, ex_adc_byte<RegisterName::r_d>)
+        THREADED_MAIN(8b, ex_adc_byte<RegisterName::r_e>)
+        THREADED_MAIN(8c, ex_adc_byte<RegisterName::r_h>)
+        THREADED_MAIN(8d, ex_adc_byte<RegisterName::r_l>)
+        THREADED_MAIN(8e, ex_adc_hl_mem)
+        THREADED_MAIN(8f, ex_adc_byte<RegisterName::r_a>)
+        THREADED_MAIN(90, ex_sub_byte<RegisterName::r_b>)
+        THREADED_MAIN(91, ex_sub_byte<RegisterName::r_c>)
+        THREADED_MAIN(92, ex_sub_byte<RegisterName::r_d>)
+        THREADED_MAIN(93, ex_sub_byte<RegisterName::r_e>)
+        THREADED_MAIN(94, ex_sub_byte<RegisterName::r_h>)
+        THREADED_MAIN(95, ex_sub_byte<RegisterName::r_l>)
+        THREADED_MAIN(96, ex_sub_hl_mem)
+        THREADED_MAIN(97, ex_sub_byte<RegisterName::r_a>)
+        THREADED_MAIN(98, ex_sbc_byte<RegisterName::r_b>)
+        THREADED_MAIN(99, ex_sbc_byte<RegisterName::r_c>)
+        THREADED_MAIN(9a, ex_sbc_byte<RegisterName::r_d>)
+        THREADED_MAIN(9b, ex_sbc_byte<RegisterName::r_e>)
+        THREADED_MAIN(9c, ex_sbc_byte<RegisterName::r_h>)
+        THREADED_MAIN(9d, ex_sbc_byte<RegisterName::r_l>)
+        THREADED_MAIN(9e, ex_sbc_hl_mem)
+        THREADED_MAIN(9f, ex_sbc_byte<RegisterName::r_a>)
+        THREADED_MAIN(a0, ex_and_byte<RegisterName::r_b>)
+        THREADED_MAIN(a1, ex_and_byte<RegisterName::r_c>)
+        THREADED_MAIN(a2, ex_and_byte<RegisterName::r_d>)
+        THREADED_MAIN(a3, ex_and_byte<RegisterName::r_e>)
+        THREADED_MAIN(a4, ex_and_byte<RegisterName::r_h>)
+        THREADED_MAIN(a5, ex_and_byte<RegisterName::r_l>)
+        THREADED_MAIN(a6, ex_and_hl_mem)
+        THREADED_MAIN(a7, ex_and_byte<RegisterName::r_a>)
+        THREADED_MAIN(a8, ex_xor_byte<RegisterName::r_b>)
+        THREADED_MAIN(a9, ex_xor_byte<RegisterName::r_c>)
+        THREADED_MAIN(aa, ex_xor_byte<RegisterName::r_d>)
+        THREADED_MAIN(ab, ex_xor_byte<RegisterName::r_e>)
+        THREADED_MAIN(ac, ex_xor_byte<RegisterName::r_h>)
+        THREADED_MAIN(ad, ex_xor_byte<RegisterName::r_l>)
+        THREADED_MAIN(ae, ex_xor_hl_mem)
+        THREADED_MAIN(af, ex_xor_byte<RegisterName::r_a>)
+        THREADED_MAIN(b0, ex_or_byte<RegisterName::r_b>)
+        THREADED_MAIN(b1, ex_or_byte<RegisterName::r_c>)
+        THREADED_MAIN(b2, ex_or_byte<RegisterName::r_d>)
+        THREADED_MAIN(b3, ex_or_byte<RegisterName::r_e>)
+        THREADED_MAIN(b4, ex_or_byte<RegisterName::r_h>)
+        THREADED_MAIN(b5, ex_or_byte<RegisterName::r_l>)
+        THREADED_MAIN(b6, ex_or_hl_mem)
+        THREADED_MAIN(b7, ex_or_byte<RegisterName::r_a>)
+        THREADED_MAIN(b8, ex_cp_byte<RegisterName::r_b>)
+        THREADED_MAIN(b9, ex_cp_byte<RegisterName::r_c>)
+        THREADED_MAIN(ba, ex_cp_byte<RegisterName::r_d>)
+        THREADED_MAIN(bb, ex_cp_byte<RegisterName::r_e>)
+        THREADED_MAIN(bc, ex_cp_byte<RegisterName::r_h>)
+        THREADED_MAIN(bd, ex_cp_byte<RegisterName::r_l>)
+        THREADED_MAIN(be, ex_cp_hl_mem)
+        THREADED_MAIN(bf, ex_cp_byte<RegisterName::r_a>)
+        THREADED_MAIN(c0, ex_ret_nz)
+        THREADED_MAIN(c1, ex_pop_pair<PairName::p_bc>)
+        THREADED_MAIN(c2, ex_jp_nz)
+        THREADED_MAIN(c3, ex_jp)
+        THREADED_MAIN(c4, ex_call_nz)
+        THREADED_MAIN(c5, ex_push_pair<PairName::p_bc>)
+        THREADED_MAIN(c6, ex_add_imm)
+        THREADED_MAIN(c7, ex_rst_00)
+        THREADED_MAIN(c8, ex_ret_z)
+        THREADED_MAIN(c9, ex_ret)
+        THREADED_MAIN(ca, ex_jp_z)
+        THREADED_MAIN(cc, ex_call_z)
+        THREADED_MAIN(cd, ex_call)
+        THREADED_MAIN(ce, ex_adc_imm)
+        THREADED_MAIN(cf, ex_rst_08)
+        THREADED_MAIN(d0, ex_ret_nc)
+        THREADED_MAIN(d1, ex_pop_pair<PairName::p_de>)
+        THREADED_MAIN(d2, ex_jp_nc)
+        THREADED_MAIN(d4, ex_call_nc)
+        THREADED_MAIN(d5, ex_push_pair<PairName::p_de>)
+        THREADED_MAIN(d6, ex_sub_imm)
+        THREADED_MAIN(d7, ex_rst_10)
+        THREADED_MAIN(d8, ex_ret_c)
+        THREADED_MAIN(d9, ex_reti)
+        THREADED_MAIN(da, ex_jp_c)
+        THREADED_MAIN(dc, ex_call_c)
+        THREADED_MAIN(de, ex_sbc_imm)
+        THREADED_MAIN(df, ex_rst_18)
+        THREADED_MAIN(e0, ex_ldh_byte_to_n_zp)
+        THREADED_MAIN(e1, ex_pop_pair<PairName::p_hl>)
+        THREADED_MAIN(e2, ex_ld_byte_to_c_zp)
+        THREADED_MAIN(e5, ex_push_pair<PairName::p_hl>)
+        THREADED_MAIN(e6, ex_and_imm)
+        THREADED_MAIN(e7, ex_rst_20)
+        THREADED_MAIN(e8, ex_add_r8_to_sp)
+        THREADED_MAIN(e9, ex_jp_hl)
+        THREADED_MAIN(ea, ex_ld_byte_to_n_mem)
+        THREADED_MAIN(ee, ex_xor_imm)
+        THREADED_MAIN(ef, ex_rst_28)
+        THREADED_MAIN(f0, ex_ldh_n_zp_to_byte)
+        THREADED_MAIN(f1, ex_pop_af)
+        THREADED_MAIN(f2, ex_ld_c_zp_to_byte)
+        THREADED_MAIN(f3, ex_di)
+        THREADED_MAIN(f5, ex_push_pair<PairName::p_af>)
+        THREADED_MAIN(f6, ex_or_imm)
+        THREADED_MAIN(f7, ex_rst_30)
+        THREADED_MAIN(f8, ex_ld_sp_r8_to_hl)
+        THREADED_MAIN(f9, ex_ld_hl_to_sp)
+        THREADED_MAIN(fa, ex_ld_n_mem_to_byte)
+        THREADED_MAIN(fb, ex_ei)
+        THREADED_MAIN(fe, ex_cp_imm)
+        THREADED_MAIN(ff, ex_rst_38)
+
+        THREADED_PREFIX_CB(00, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(01, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(02, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(03, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(04, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(05, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(06, ex_cb_hl_mem<CbOperation::cb_rlc, 0>)
+        THREADED_PREFIX_CB(07, ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(08, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(09, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(0a, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(0b, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(0c, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(0d, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(0e, ex_cb_hl_mem<CbOperation::cb_rrc, 0>)
+        THREADED_PREFIX_CB(0f, ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(10, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(11, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(12, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(13, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(14, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(15, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(16, ex_cb_hl_mem<CbOperation::cb_rl, 0>)
+        THREADED_PREFIX_CB(17, ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(18, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(19, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(1a, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(1b, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(1c, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(1d, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(1e, ex_cb_hl_mem<CbOperation::cb_rr, 0>)
+        THREADED_PREFIX_CB(1f, ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(20, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(21, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(22, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(23, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(24, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(25, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(26, ex_cb_hl_mem<CbOperation::cb_sla, 0>)
+        THREADED_PREFIX_CB(27, ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(28, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(29, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(2a, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(2b, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(2c, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(2d, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(2e, ex_cb_hl_mem<CbOperation::cb_sra, 0>)
+        THREADED_PREFIX_CB(2f, ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(30, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(31, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(32, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(33, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(34, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(35, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(36, ex_cb_hl_mem<CbOperation::cb_swap, 0>)
+        THREADED_PREFIX_CB(37, ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(38, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(39, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(3a, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(3b, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(3c, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(3d, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(3e, ex_cb_hl_mem<CbOperation::cb_srl, 0>)
+        THREADED_PREFIX_CB(3f, ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(40, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(41, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(42, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(43, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(44, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(45, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(46, ex_cb_hl_mem<CbOperation::cb_bit, 0>)
+        THREADED_PREFIX_CB(47, ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(48, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_b>)
+        THREADED_PREFIX_CB(49, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_c>)
+        THREADED_PREFIX_CB(4a, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_d>)
+        THREADED_PREFIX_CB(4b, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_e>)
+        THREADED_PREFIX_CB(4c, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_h>)
+        THREADED_PREFIX_CB(4d, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_l>)
+        THREADED_PREFIX_CB(4e, ex_cb_hl_mem<CbOperation::cb_bit, 1>)
+        THREADED_PREFIX_CB(4f, ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_a>)
+        THREADED_PREFIX_CB(50, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_b>)
+        THREADED_PREFIX_CB(51, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_c>)
+        THREADED_PREFIX_CB(52, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_d>)
+        THREADED_PREFIX_CB(53, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_e>)
+        THREADED_PREFIX_CB(54, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_h>)
+        THREADED_PREFIX_CB(55, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_l>)
+        THREADED_PREFIX_CB(56, ex_cb_hl_mem<CbOperation::cb_bit, 2>)
+        THREADED_PREFIX_CB(57, ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_a>)
+        THREADED_PREFIX_CB(58, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_b>)
+        THREADED_PREFIX_CB(59, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_c>)
+        THREADED_PREFIX_CB(5a, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_d>)
+        THREADED_PREFIX_CB(5b, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_e>)
+        THREADED_PREFIX_CB(5c, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_h>)
+        THREADED_PREFIX_CB(5d, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_l>)
+        THREADED_PREFIX_CB(5e, ex_cb_hl_mem<CbOperation::cb_bit, 3>)
+        THREADED_PREFIX_CB(5f, ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_a>)
+        THREADED_PREFIX_CB(60, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_b>)
+        THREADED_PREFIX_CB(61, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_c>)
+        THREADED_PREFIX_CB(62, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_d>)
+        THREADED_PREFIX_CB(63, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_e>)
+        THREADED_PREFIX_CB(64, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_h>)
+        THREADED_PREFIX_CB(65, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_l>)
+        THREADED_PREFIX_CB(66, ex_cb_hl_mem<CbOperation::cb_bit, 4>)
+        THREADED_PREFIX_CB(67, ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_a>)
+        THREADED_PREFIX_CB(68, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_b>)
+        THREADED_PREFIX_CB(69, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_c>)
+        THREADED_PREFIX_CB(6a, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_d>)
+        THREADED_PREFIX_CB(6b, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_e>)
+        THREADED_PREFIX_CB(6c, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_h>)
+        THREADED_PREFIX_CB(6d, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_l>)
+        THREADED_PREFIX_CB(6e, ex_cb_hl_mem<CbOperation::cb_bit, 5>)
+        THREADED_PREFIX_CB(6f, ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_a>)
+        THREADED_PREFIX_CB(70, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_b>)
+        THREADED_PREFIX_CB(71, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_c>)
+        THREADED_PREFIX_CB(72, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_d>)
+        THREADED_PREFIX_CB(73, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_e>)
+        THREADED_PREFIX_CB(74, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_h>)
+        THREADED_PREFIX_CB(75, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_l>)
+        THREADED_PREFIX_CB(76, ex_cb_hl_mem<CbOperation::cb_bit, 6>)
+        THREADED_PREFIX_CB(77, ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_a>)
+        THREADED_PREFIX_CB(78, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_b>)
+        THREADED_PREFIX_CB(79, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_c>)
+        THREADED_PREFIX_CB(7a, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_d>)
+        THREADED_PREFIX_CB(7b, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_e>)
+        THREADED_PREFIX_CB(7c, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_h>)
+        THREADED_PREFIX_CB(7d, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_l>)
+        THREADED_PREFIX_CB(7e, ex_cb_hl_mem<CbOperation::cb_bit, 7>)
+        THREADED_PREFIX_CB(7f, ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_a>)
+        THREADED_PREFIX_CB(80, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(81, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(82, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(83, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(84, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(85, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(86, ex_cb_hl_mem<CbOperation::cb_res, 0>)
+        THREADED_PREFIX_CB(87, ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(88, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_b>)
+        THREADED_PREFIX_CB(89, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_c>)
+        THREADED_PREFIX_CB(8a, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_d>)
+        THREADED_PREFIX_CB(8b, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_e>)
+        THREADED_PREFIX_CB(8c, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_h>)
+        THREADED_PREFIX_CB(8d, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_l>)
+        THREADED_PREFIX_CB(8e, ex_cb_hl_mem<CbOperation::cb_res, 1>)
+        THREADED_PREFIX_CB(8f, ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_a>)
+        THREADED_PREFIX_CB(90, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_b>)
+        THREADED_PREFIX_CB(91, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_c>)
+        THREADED_PREFIX_CB(92, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_d>)
+        THREADED_PREFIX_CB(93, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_e>)
+        THREADED_PREFIX_CB(94, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_h>)
+        THREADED_PREFIX_CB(95, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_l>)
+        THREADED_PREFIX_CB(96, ex_cb_hl_mem<CbOperation::cb_res, 2>)
+        THREADED_PREFIX_CB(97, ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_a>)
+        THREADED_PREFIX_CB(98, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_b>)
+        THREADED_PREFIX_CB(99, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_c>)
+        THREADED_PREFIX_CB(9a, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_d>)
+        THREADED_PREFIX_CB(9b, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_e>)
+        THREADED_PREFIX_CB(9c, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_h>)
+        THREADED_PREFIX_CB(9d, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_l>)
+        THREADED_PREFIX_CB(9e, ex_cb_hl_mem<CbOperation::cb_res, 3>)
+        THREADED_PREFIX_CB(9f, ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_a>)
+        THREADED_PREFIX_CB(a0, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_b>)
+        THREADED_PREFIX_CB(a1, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_c>)
+        THREADED_PREFIX_CB(a2, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_d>)
+        THREADED_PREFIX_CB(a3, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_e>)
+        THREADED_PREFIX_CB(a4, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_h>)
+        THREADED_PREFIX_CB(a5, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_l>)
+        THREADED_PREFIX_CB(a6, ex_cb_hl_mem<CbOperation::cb_res, 4>)
+        THREADED_PREFIX_CB(a7, ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_a>)
+        THREADED_PREFIX_CB(a8, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_b>)
+        THREADED_PREFIX_CB(a9, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_c>)
+        THREADED_PREFIX_CB(aa, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_d>)
+        THREADED_PREFIX_CB(ab, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_e>)
+        THREADED_PREFIX_CB(ac, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_h>)
+        THREADED_PREFIX_CB(ad, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_l>)
+        THREADED_PREFIX_CB(ae, ex_cb_hl_mem<CbOperation::cb_res, 5>)
+        THREADED_PREFIX_CB(af, ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_a>)
+        THREADED_PREFIX_CB(b0, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_b>)
+        THREADED_PREFIX_CB(b1, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_c>)
+        THREADED_PREFIX_CB(b2, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_d>)
+        THREADED_PREFIX_CB(b3, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_e>)
+        THREADED_PREFIX_CB(b4, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_h>)
+        THREADED_PREFIX_CB(b5, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_l>)
+        THREADED_PREFIX_CB(b6, ex_cb_hl_mem<CbOperation::cb_res, 6>)
+        THREADED_PREFIX_CB(b7, ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_a>)
+        THREADED_PREFIX_CB(b8, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_b>)
+        THREADED_PREFIX_CB(b9, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_c>)
+        THREADED_PREFIX_CB(ba, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_d>)
+        THREADED_PREFIX_CB(bb, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_e>)
+        THREADED_PREFIX_CB(bc, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_h>)
+        THREADED_PREFIX_CB(bd, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_l>)
+        THREADED_PREFIX_CB(be, ex_cb_hl_mem<CbOperation::cb_res, 7>)
+        THREADED_PREFIX_CB(bf, ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_a>)
+        THREADED_PREFIX_CB(c0, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_b>)
+        THREADED_PREFIX_CB(c1, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_c>)
+        THREADED_PREFIX_CB(c2, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_d>)
+        THREADED_PREFIX_CB(c3, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_e>)
+        THREADED_PREFIX_CB(c4, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_h>)
+        THREADED_PREFIX_CB(c5, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_l>)
+        THREADED_PREFIX_CB(c6, ex_cb_hl_mem<CbOperation::cb_set, 0>)
+        THREADED_PREFIX_CB(c7, ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_a>)
+        THREADED_PREFIX_CB(c8, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_b>)
+        THREADED_PREFIX_CB(c9, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_c>)
+        THREADED_PREFIX_CB(ca, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_d>)
+        THREADED_PREFIX_CB(cb, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_e>)
+        THREADED_PREFIX_CB(cc, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_h>)
+        THREADED_PREFIX_CB(cd, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_l>)
+        THREADED_PREFIX_CB(ce, ex_cb_hl_mem<CbOperation::cb_set, 1>)
+        THREADED_PREFIX_CB(cf, ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_a>)
+        THREADED_PREFIX_CB(d0, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_b>)
+        THREADED_PREFIX_CB(d1, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_c>)
+        THREADED_PREFIX_CB(d2, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_d>)
+        THREADED_PREFIX_CB(d3, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_e>)
+        THREADED_PREFIX_CB(d4, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_h>)
+        THREADED_PREFIX_CB(d5, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_l>)
+        THREADED_PREFIX_CB(d6, ex_cb_hl_mem<CbOperation::cb_set, 2>)
+        THREADED_PREFIX_CB(d7, ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_a>)
+        THREADED_PREFIX_CB(d8, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_b>)
+        THREADED_PREFIX_CB(d9, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_c>)
+        THREADED_PREFIX_CB(da, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_d>)
+        THREADED_PREFIX_CB(db, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_e>)
+        THREADED_PREFIX_CB(dc, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_h>)
+        THREADED_PREFIX_CB(dd, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_l>)
+        THREADED_PREFIX_CB(de, ex_cb_hl_mem<CbOperation::cb_set, 3>)
+        THREADED_PREFIX_CB(df, ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_a>)
+        THREADED_PREFIX_CB(e0, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_b>)
+        THREADED_PREFIX_CB(e1, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_c>)
+        THREADED_PREFIX_CB(e2, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_d>)
+        THREADED_PREFIX_CB(e3, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_e>)
+        THREADED_PREFIX_CB(e4, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_h>)
+        THREADED_PREFIX_CB(e5, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_l>)
+        THREADED_PREFIX_CB(e6, ex_cb_hl_mem<CbOperation::cb_set, 4>)
+        THREADED_PREFIX_CB(e7, ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_a>)
+        THREADED_PREFIX_CB(e8, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_b>)
+        THREADED_PREFIX_CB(e9, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_c>)
+        THREADED_PREFIX_CB(ea, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_d>)
+        THREADED_PREFIX_CB(eb, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_e>)
+        THREADED_PREFIX_CB(ec, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_h>)
+        THREADED_PREFIX_CB(ed, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_l>)
+        THREADED_PREFIX_CB(ee, ex_cb_hl_mem<CbOperation::cb_set, 5>)
+        THREADED_PREFIX_CB(ef, ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_a>)
+        THREADED_PREFIX_CB(f0, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_b>)
+        THREADED_PREFIX_CB(f1, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_c>)
+        THREADED_PREFIX_CB(f2, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_d>)
+        THREADED_PREFIX_CB(f3, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_e>)
+        THREADED_PREFIX_CB(f4, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_h>)
+        THREADED_PREFIX_CB(f5, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_l>)
+        THREADED_PREFIX_CB(f6, ex_cb_hl_mem<CbOperation::cb_set, 6>)
+        THREADED_PREFIX_CB(f7, ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_a>)
+        THREADED_PREFIX_CB(f8, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_b>)
+        THREADED_PREFIX_CB(f9, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_c>)
+        THREADED_PREFIX_CB(fa, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_d>)
+        THREADED_PREFIX_CB(fb, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_e>)
+        THREADED_PREFIX_CB(fc, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_h>)
+        THREADED_PREFIX_CB(fd, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_l>)
+        THREADED_PREFIX_CB(fe, ex_cb_hl_mem<CbOperation::cb_set, 7>)
+        THREADED_PREFIX_CB(ff, ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_a>)
+    }
+}
+
+#endif
@@ -1,9 +1,14 @@
 #include "cpu.h"
+using gameboy::BasicBlock;
+using gameboy::BlockInstruction;
 using gameboy::Cpu;
 using gameboy::FlagName;
 using gameboy::Memory;
+using gameboy::PairName;
 using gameboy::Register;
 using gameboy::RegisterName;
+using gameboy::StateReader;
+using gameboy::StateWriter;
 
 // Stack operations
 void Cpu::stack_add(Memory &mem, uint16_t word)
@@ -53,11 +58,68 @@ Cpu &Cpu::power_on()
 {
     reg.power_on();
     f_halted = false;
+    memset(&idle_loop_state, 0, sizeof(idle_loop_state));
     f_enable_interrupts = true;
+    // blocks of the last ROM
+#ifdef GAMEBOY_DYNAREC
+    dynarec.clear();
+#endif
+    block_cache.clear();
 
     return *this;
 }
 
+void Cpu::save_state(StateWriter &writer)
+{
+    // F from a copy, saving does not touch the lazy flags
+    Register temp_reg = reg;
+    static const RegisterName save_order[8] = {
+        RegisterName::r_a, RegisterName::r_f, RegisterName::r_b, RegisterName::r_c,
+        RegisterName::r_d, RegisterName::r_e, RegisterName::r_h, RegisterName::r_l};
+    for (int i = 0; i < 8; i++)
+    {
+        writer.put_byte(temp_reg.get_register_byte(save_order[i]));
+    }
+    writer.put_word(reg.register_word[RegisterName::r_sp]);
+    writer.put_word(reg.register_word[RegisterName::r_pc]);
+    writer.put_byte(f_enable_interrupts);
+    writer.put_byte(f_halted);
+    writer.put_qword(instruction_count);
+}
+
+bool Cpu::load_state(StateReader &reader)
+{
+    static const RegisterName load_order[8] = {
+        RegisterName::r_a, RegisterName::r_f, RegisterName::r_b, RegisterName::r_c,
+        RegisterName::r_d, RegisterName::r_e, RegisterName::r_h, RegisterName::r_l};
+    uint8_t temp_bytes[8];
+    reader.get_bytes(temp_bytes, 8);
+    uint16_t temp_r_sp_word = reader.get_word();
+    uint16_t temp_r_pc_word = reader.get_word();
+    bool temp_enable_interrupts = reader.get_byte();
+    bool temp_halted = reader.get_byte();
+    uint64_t temp_instruction_count = reader.get_qword();
+    if (reader.failed())
+    {
+        return false;
+    }
+
+    for (int i = 0; i < 8; i++)
+    {
+        reg.set_register_byte(load_order[i], temp_bytes[i]);
+    }
+    reg.set_register_word(RegisterName::r_sp, temp_r_sp_word);
+    reg.set_register_word(RegisterName::r_pc, temp_r_pc_word);
+    f_enable_interrupts = temp_enable_interrupts;
+    f_halted = temp_halted;
+    instruction_count = temp_instruction_count;
+    // the idle loop snapshot belongs to the state left behind
+    memset(&idle_loop_state, 0, sizeof(idle_loop_state));
+    idle_loop_hit = false;
+    idle_loop_armed = false;
+    return true;
+}
+
 // Hanldle interrupts
 uint8_t Cpu::handle_interrupts(Memory &mem)
 {
@@ -147,10 +209,243 @@ uint8_t Cpu::next(Memory &mem)
     return temp_counter;
 }
 
+// Run until clock reaches deadline
+void Cpu::run(Memory &mem, uint64_t &clock, const uint64_t &deadline)
+{
+#if defined(GAMEBOY_DYNAREC)
+    run_dynarec(mem, clock, deadline);
+#elif defined(GAMEBOY_THREADED_INTERPRETER)
+    run_threaded(mem, clock, deadline);
+#else
+    run_table(mem, clock, deadline);
+#endif
+}
+
+void Cpu::run_table(Memory &mem, uint64_t &clock, const uint64_t &deadline)
+{
+    // events may have changed memory since the last run
+    idle_loop_armed = false;
+    while (clock < deadline)
+    {
+        // halted and no interrupt to wake up, same test as handle_interrupts
+        if (f_halted && !(mem.memory_byte[0xff0f] & mem.memory_byte[0xffff]))
+        {
+            skip_halt(clock, deadline);
+            return;
+        }
+        // ROM code with no interrupt to handle runs from the block cache
+        BasicBlock *temp_block = nullptr;
+        if (!f_halted && reg.register_word[RegisterName::r_pc] < BLOCK_ROM_END_ADDRESS &&
+            !(f_enable_interrupts && (mem.memory_byte[0xff0f] & mem.memory_byte[0xffff])))
+        {
+            temp_block = get_block(mem);
+        }
+        if (temp_block && !temp_block->instructions.empty())
+        {
+            run_block(mem, *temp_block, clock, deadline);
+        }
+        else
+        {
+            clock += 4 * next(mem);
+        }
+        if (idle_loop_hit)
+        {
+            skip_idle_loop(clock, deadline);
+        }
+    }
+}
+
+// Main opcodes that end a basic block: they may change PC or stop the CPU
+static bool opcode_ends_block(uint8_t opcode_main)
+{
+    switch (opcode_main)
+    {
+    case 0x10: // STOP
+    case 0x76: // HALT
+    case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // JR
+    case 0xc2: case 0xc3: case 0xca: case 0xd2: case 0xda: case 0xe9: // JP
+    case 0xc4: case 0xcc: case 0xcd: case 0xd4: case 0xdc: // CALL
+    case 0xc0: case 0xc8: case 0xc9: case 0xd0: case 0xd8: case 0xd9: // RET RETI
+    case 0xc7: case 0xcf: case 0xd7: case 0xdf: case 0xe7: case 0xef: case 0xf7: case 0xff: // RST
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Opcodes that write memory or enable interrupts
+// A write may switch the ROM bank, move the deadline (timer registers) or request an interrupt (IF IE)
+static bool opcode_needs_check(uint8_t opcode_main, uint8_t opcode_prefix_cb)
+{
+    if (opcode_main == 0xcb)
+    {
+        // operations on (HL), BIT only reads it
+        return (opcode_prefix_cb & 0x07) == 0x06 && (opcode_prefix_cb < 0x40 || opcode_prefix_cb >= 0x80);
+    }
+    switch (opcode_main)
+    {
+    case 0x02: case 0x12: case 0x22: case 0x32: // LD (BC) (DE) (HL+) (HL-), A
+    case 0x34: case 0x35: case 0x36: // INC DEC LD (HL)
+    case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x77: // LD (HL), r
+    case 0x08: // LD (nn), SP
+    case 0xc5: case 0xd5: case 0xe5: case 0xf5: // PUSH
+    case 0xe0: case 0xe2: case 0xea: // LDH (n), A  LD (C), A  LD (nn), A
+    case 0xfb: // EI
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Decode the instructions from address to the end of the block into the cache
+BasicBlock *Cpu::decode_block(Memory &mem, uint16_t address)
+{
+    std::unique_ptr<BasicBlock> temp_block(new BasicBlock);
+
+    // a block never leaves its bank
+    uint32_t temp_end_address = (address & ~(BANK_SIZE - 1)) + BANK_SIZE;
+    uint32_t temp_address = address;
+    while (temp_block->instructions.size() < BLOCK_MAX_INSTRUCTIONS)
+    {
+        uint8_t temp_opcode_main = mem.get_memory_byte(temp_address);
+        if (!handle_opcode_main[temp_opcode_main] ||
+            temp_address + opcode_length_main[temp_opcode_main] > temp_end_address)
+        {
+            break;
+        }
+
+        BlockInstruction temp_instruction;
+        if (temp_opcode_main == 0xcb)
+        {
+            uint8_t temp_opcode_prefix_cb = mem.get_memory_byte(temp_address + 1);
+            temp_instruction.opcode = temp_opcode_prefix_cb;
+            temp_instruction.cycles = opcode_cycle_prefix_cb[temp_opcode_prefix_cb];
+            temp_instruction.f_prefix_cb = true;
+            temp_instruction.f_check = opcode_needs_check(temp_opcode_main, temp_opcode_prefix_cb);
+        }
+        else
+        {
+            temp_instruction.opcode = temp_opcode_main;
+            temp_instruction.cycles = opcode_cycle_main[temp_opcode_main];
+            temp_instruction.f_prefix_cb = false;
+            temp_instruction.f_check = opcode_needs_check(temp_opcode_main, 0x00);
+        }
+        temp_block->instructions.push_back(temp_instruction);
+        temp_block->cycles += temp_instruction.cycles;
+
+        temp_address += opcode_length_main[temp_opcode_main];
+        if (opcode_ends_block(temp_opcode_main) || temp_address >= temp_end_address)
+        {
+            break;
+        }
+    }
+    // blocks stay for the whole run, drop the growth slack
+    temp_block->instructions.shrink_to_fit();
+    return block_cache.insert(mem.get_mapped_rom_bank(address), address, std::move(temp_block));
+}
+
+// Run the instructions of a block
+// Same as Cpu::next in a loop: nothing but a memory write or EI can change the
+// deadline, request or enable an interrupt, or switch the bank under the block,
+// so those are the only places to look again
+void Cpu::run_block(Memory &mem, const BasicBlock &block, uint64_t &clock, const uint64_t &deadline)
+{
+    // every instruction starts before deadline, unless a write moves it
+    bool temp_fits = clock + 4 * block.cycles < deadline;
+    uint16_t temp_r_pc_word = reg.register_word[RegisterName::r_pc];
+    uint16_t temp_bank = mem.get_mapped_rom_bank(temp_r_pc_word);
+    uint8_t temp_opcode_prefix_cb = 0x00;
+
+    for (const BlockInstruction &temp_instruction : block.instructions)
+    {
+        instruction_count++;
+        if (!temp_instruction.f_prefix_cb)
+        {
+            reg.register_word[RegisterName::r_pc] += 1;
+            (this->*handle_opcode_main[temp_instruction.opcode])(mem, temp_instruction.opcode, temp_opcode_prefix_cb);
+        }
+        else
+        {
+            // 0xCB and the prefix CB opcode
+            reg.register_word[RegisterName::r_pc] += 2;
+            (this->*handle_opcode_prefix_cb[temp_instruction.opcode])(mem, temp_instruction.opcode);
+        }
+        clock += 4 * temp_instruction.cycles;
+
+        if (temp_fits && !temp_instruction.f_check)
+        {
+            continue;
+        }
+        if (clock >= deadline || mem.get_mapped_rom_bank(temp_r_pc_word) != temp_bank ||
+            (f_enable_interrupts && (mem.memory_byte[0xff0f] & mem.memory_byte[0xffff])))
+        {
+            return;
+        }
+    }
+}
+
+// Compare the CPU state with the one saved at the last backward branch
+void Cpu::check_idle_loop(Memory &mem)
+{
+    // Any write since the last branch, not idle: skip the register snapshot
+    if (mem.write_count != idle_loop_state.write_count)
+    {
+        idle_loop_state.write_count = mem.write_count;
+        idle_loop_armed = false;
+        return;
+    }
+
+    IdleLoopState temp_state;
+    memset(&temp_state, 0, sizeof(temp_state));
+    memcpy(temp_state.register_byte, reg.register_byte, sizeof(temp_state.register_byte));
+    memcpy(temp_state.register_word, reg.register_word, sizeof(temp_state.register_word));
+    temp_state.flag_state[0] = reg.flag_op;
+    temp_state.flag_state[1] = reg.flag_x;
+    temp_state.flag_state[2] = reg.flag_y;
+    temp_state.flag_state[3] = reg.flag_carry;
+    temp_state.flag_state[4] = reg.flag_result;
+    temp_state.flag_state[5] = reg.flag_fixed;
+    temp_state.f_enable_interrupts = f_enable_interrupts;
+    temp_state.write_count = mem.write_count;
+
+    if (memcmp(&temp_state, &idle_loop_state, sizeof(temp_state)) == 0)
+    {
+        idle_loop_hit = true;
+        return;
+    }
+    idle_loop_state = temp_state;
+    idle_loop_armed = false;
+}
+
+// Skip whole loop iterations up to deadline
+// The first hit only measures one iteration (clocks and instructions),
+// memory and CPU state are the same at both ends, so it repeats exactly
+void Cpu::skip_idle_loop(uint64_t &clock, const uint64_t &deadline)
+{
+    idle_loop_hit = false;
+    if (idle_loop_armed && clock < deadline)
+    {
+        uint64_t temp_period = clock - idle_loop_clock;
+        uint64_t temp_iterations = (deadline - clock) / temp_period;
+        if (temp_iterations)
+        {
+            clock += temp_iterations * temp_period;
+            instruction_count += temp_iterations * (instruction_count - idle_loop_instruction);
+            idle_loop_skips++;
+            idle_loop_skipped_clocks += temp_iterations * temp_period;
+        }
+    }
+    idle_loop_armed = true;
+    idle_loop_clock = clock;
+    idle_loop_instruction = instruction_count;
+}
+
 // Execute opcodes
 // Return cycles in opcode_cycle_main or opcode_cycle_prefix_cb
 uint8_t Cpu::execute(Memory &mem)
 {
+    instruction_count++;
+
     uint8_t opcode_main = read_opcode_byte(mem);
     uint8_t opcode_prefix_cb = 0x00;
 
@@ -159,7 +454,7 @@ uint8_t Cpu::execute(Memory &mem)
     (this->*handle_opcode_main[opcode_main])(mem, opcode_main, opcode_prefix_cb);
 
     // return cycles
-    if (opcode_cycle_prefix_cb)
+    if (opcode_main == 0xcb)
     {
         return opcode_cycle_prefix_cb[opcode_prefix_cb];
     }
@@ -183,16 +478,8 @@ void Cpu::alu_add(uint8_t n)
     uint16_t temp_r_a_word = reg.get_register_byte(RegisterName::r_a);
     uint16_t temp_reg_word = temp_r_a_word + temp_n_word;
 
-    bool f_carry = (temp_reg_word > 0x00ff);
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    bool f_half_carry = ((temp_r_a_word & 0x000f) + (temp_n_word & 0x000f) > 0x000f);
-    reg.set_flag(FlagName::f_h, f_half_carry);
-
-    reg.set_flag(FlagName::f_n, false);
-
     uint8_t temp_reg_byte = temp_reg_word & 0xff;
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_add(temp_r_a_word, temp_n_word, 0, temp_reg_byte);
 
     reg.set_register_byte(RegisterName::r_a, temp_reg_byte);
 }
@@ -212,16 +499,8 @@ void Cpu::alu_adc(uint8_t n)
     uint16_t temp_carry_word = reg.get_flag(FlagName::f_c);
     uint16_t temp_reg_word = temp_r_a_word + temp_carry_word + temp_n_word;
 
-    bool f_carry = (temp_reg_word > 0x00ff);
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    bool f_half_carry = (((temp_r_a_word & 0x000f) + (temp_carry_word & 0x000f) + (temp_n_word & 0x000f)) > 0x000f);
-    reg.set_flag(FlagName::f_h, f_half_carry);
-
-    reg.set_flag(FlagName::f_n, false);
-
     uint8_t temp_reg_byte = temp_reg_word & 0xff;
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_add(temp_r_a_word, temp_n_word, temp_carry_word, temp_reg_byte);
 
     reg.set_register_byte(RegisterName::r_a, temp_reg_byte);
 }
@@ -245,16 +524,8 @@ void Cpu::alu_sub(uint8_t n)
     uint16_t temp_r_a_word = reg.get_register_byte(RegisterName::r_a);
     uint16_t temp_reg_word = temp_r_a_word - temp_n_word;
 
-    bool f_carry = (temp_r_a_word < temp_n_word);
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    bool f_half_carry = ((temp_r_a_word & 0x000f) < (temp_n_word & 0x000f));
-    reg.set_flag(FlagName::f_h, f_half_carry);
-
-    reg.set_flag(FlagName::f_n, true);
-
     uint8_t temp_reg_byte = temp_reg_word & 0xff;
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_sub(temp_r_a_word, temp_n_word, 0, temp_reg_byte);
 
     reg.set_register_byte(RegisterName::r_a, temp_reg_byte);
 }
@@ -279,19 +550,10 @@ void Cpu::alu_sbc(uint8_t n)
     uint16_t temp_carry_word = reg.get_flag(FlagName::f_c);
     uint16_t temp_reg_word = temp_r_a_word - temp_carry_word - temp_n_word;
 
-    bool f_carry = (temp_r_a_word < (temp_carry_word + temp_n_word));
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    bool f_half_carry = (temp_r_a_word & 0x000f) < (temp_carry_word + (temp_n_word & 0x000f));
-    reg.set_flag(FlagName::f_h, f_half_carry);
-
-    reg.set_flag(FlagName::f_n, true);
-
     uint8_t temp_reg_byte = temp_reg_word & 0xff;
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_sub(temp_r_a_word, temp_n_word, temp_carry_word, temp_reg_byte);
 
     reg.set_register_byte(RegisterName::r_a, temp_reg_byte);
-
 }
 
 // Logically AND n with A, result in A.
@@ -307,10 +569,7 @@ void Cpu::alu_and(uint8_t n)
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte &= n;
 
-    reg.set_flag(FlagName::f_c, false);
-    reg.set_flag(FlagName::f_h, true);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_r_a_byte);
+    reg.set_flags_result(temp_r_a_byte, FlagName::f_h);
 
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
 }
@@ -328,10 +587,7 @@ void Cpu::alu_or(uint8_t n)
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte |= n;
 
-    reg.set_flag(FlagName::f_c, false);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_r_a_byte);
+    reg.set_flags_result(temp_r_a_byte, 0);
 
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
 }
@@ -349,10 +605,7 @@ void Cpu::alu_xor(uint8_t n)
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte ^= n;
 
-    reg.set_flag(FlagName::f_c, false);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_r_a_byte);
+    reg.set_flags_result(temp_r_a_byte, 0);
 
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
 }
@@ -369,8 +622,8 @@ void Cpu::alu_xor(uint8_t n)
 void Cpu::alu_cp(uint8_t n)
 {
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
-    alu_sub(n);
-    reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
+    uint8_t temp_reg_byte = temp_r_a_byte - n;
+    reg.set_flags_sub(temp_r_a_byte, n, 0, temp_reg_byte);
 }
 
 // Increment register n.
@@ -385,12 +638,8 @@ uint8_t Cpu::alu_inc(uint8_t n)
 {
     uint8_t temp_reg_byte = n + 1;
 
-    bool f_half_carry = ((n & 0x0f) + 0x01) > 0x0f;
-    reg.set_flag(FlagName::f_h, f_half_carry);
-
-    reg.set_flag(FlagName::f_n, false);
-
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    // H: low nibble wrapped to 0
+    reg.set_flags_inc(temp_reg_byte);
 
     return temp_reg_byte;
 }
@@ -411,12 +660,8 @@ uint8_t Cpu::alu_dec(uint8_t n)
 {
     uint8_t temp_reg_byte = n - 0x01;
 
-    bool f_half_carry = (n & 0x0f);
-    reg.set_flag(FlagName::f_h, !f_half_carry);
-
-    reg.set_flag(FlagName::f_n, true);
-
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    // H: low nibble wrapped to 0x0f
+    reg.set_flags_dec(temp_reg_byte);
 
     return temp_reg_byte;
 }
@@ -431,19 +676,20 @@ uint8_t Cpu::alu_dec(uint8_t n)
 // C - Set if carry from bit 15.
 void Cpu::alu_add_hl(uint16_t n)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint32_t temp_reg_dword = temp_r_hl_word + n;
 
     bool f_carry = temp_reg_dword > 0xffff;
-    reg.set_flag(FlagName::f_c, f_carry);
-
     bool f_half_carry = ((temp_r_hl_word & 0x07ff) + (n & 0x07ff)) > 0x07ff;
-    reg.set_flag(FlagName::f_h, f_half_carry);
 
-    reg.set_flag(FlagName::f_n, false);
+    // Z is kept
+    uint8_t temp_flags = reg.get_flags() & FlagName::f_z;
+    temp_flags |= f_half_carry ? FlagName::f_h : 0;
+    temp_flags |= f_carry ? FlagName::f_c : 0;
+    reg.set_flags(temp_flags);
 
     uint16_t temp_reg_word = temp_reg_dword & 0xffff;
-    reg.set_register_byte_pair(RegisterName::r_h, RegisterName::r_l, temp_reg_word);
+    reg.set_pair(PairName::p_hl, temp_reg_word);
 }
 
 // Add n to Stack Pointer (SP).
@@ -460,14 +706,9 @@ void Cpu::alu_add_sp(Memory &mem)
     int8_t temp_imm_word = read_opcode_byte(mem);
 
     bool f_carry = ((temp_r_sp_word & 0x00ff) + (temp_imm_word & 0x00ff)) > 0x00ff;
-    reg.set_flag(FlagName::f_c, f_carry);
-
     bool f_half_carry = ((temp_r_sp_word & 0x000f) + (temp_imm_word & 0x000f)) > 0x000f;
-    reg.set_flag(FlagName::f_h, f_half_carry);
-
-    reg.set_flag(FlagName::f_n, false);
 
-    reg.set_flag(FlagName::f_z, false);
+    reg.set_flags((f_half_carry ? FlagName::f_h : 0) | (f_carry ? FlagName::f_c : 0));
 
     uint16_t temp_reg_word = temp_r_sp_word + temp_imm_word;
     reg.set_register_word(RegisterName::r_sp, temp_reg_word);
@@ -483,12 +724,8 @@ void Cpu::alu_add_sp(Memory &mem)
 // C - Reset.
 uint8_t Cpu::alu_swap(uint8_t n)
 {
-    reg.set_flag(FlagName::f_c, false);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !n);
-
     uint8_t temp_reg_byte = (n >> 4) | (n << 4);
+    reg.set_flags_result(temp_reg_byte, 0);
     return temp_reg_byte;
 }
 
@@ -533,9 +770,11 @@ void Cpu::alu_daa()
         temp_r_a_byte -= temp_adjust_byte;
     }
 
-    reg.set_flag(FlagName::f_c, temp_adjust_byte >= 0x60);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_z, !temp_r_a_byte);
+    // N is kept
+    uint8_t temp_flags = f_subtract ? FlagName::f_n : 0;
+    temp_flags |= (temp_adjust_byte >= 0x60) ? FlagName::f_c : 0;
+    temp_flags |= temp_r_a_byte ? 0 : FlagName::f_z;
+    reg.set_flags(temp_flags);
 
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
 }
@@ -552,8 +791,7 @@ void Cpu::alu_cpl()
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     reg.set_register_byte(RegisterName::r_a, ~temp_r_a_byte);
 
-    reg.set_flag(FlagName::f_h, true);
-    reg.set_flag(FlagName::f_n, true);
+    reg.set_flags(reg.get_flags() | FlagName::f_h | FlagName::f_n);
 }
 
 // Complement carry flag. If C flag is set, then reset it. If C flag is reset, then set it.
@@ -565,11 +803,8 @@ void Cpu::alu_cpl()
 // C - Complemented.
 void Cpu::alu_ccf()
 {
-    bool f_carry = reg.get_flag(FlagName::f_c);
-    reg.set_flag(FlagName::f_c, !f_carry);
-
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
+    uint8_t temp_flags = reg.get_flags();
+    reg.set_flags((temp_flags & FlagName::f_z) | ((temp_flags & FlagName::f_c) ^ FlagName::f_c));
 }
 
 // Set Carry flag.
@@ -581,9 +816,7 @@ void Cpu::alu_ccf()
 // C - Set.
 void Cpu::alu_scf()
 {
-    reg.set_flag(FlagName::f_c, true);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
+    reg.set_flags((reg.get_flags() & FlagName::f_z) | FlagName::f_c);
 }
 
 // Rotate A left. Old bit 7 to Carry flag.
@@ -596,14 +829,10 @@ void Cpu::alu_scf()
 uint8_t Cpu::alu_rlc(uint8_t n)
 {
     bool f_carry = ((n & 0x80) >> 7) == 0x01;
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
 
     uint8_t temp_carry_byte = f_carry;
     uint8_t temp_reg_byte = (n << 1) | temp_carry_byte;
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
@@ -621,11 +850,7 @@ uint8_t Cpu::alu_rl(uint8_t n)
     uint8_t temp_reg_byte = (n << 1) + temp_carry_byte;
 
     bool f_carry = ((n & 0x80) >> 7) == 0x01;
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
@@ -642,10 +867,7 @@ uint8_t Cpu::alu_rrc(uint8_t n)
     bool f_carry = (n & 0x01) == 0x01;
     uint8_t temp_reg_byte = f_carry ? ((n >> 1) | 0x80) : (n >> 1);
 
-    reg.set_flag(FlagName::f_c, f_carry);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
@@ -663,11 +885,7 @@ uint8_t Cpu::alu_rr(uint8_t n)
     uint8_t temp_reg_byte = (n >> 1) | (temp_carry_byte << 7);
 
     bool f_carry = (n & 0x01) == 0x01;
-    reg.set_flag(FlagName::f_c, f_carry);
-
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
@@ -685,10 +903,7 @@ uint8_t Cpu::alu_sla(uint8_t n)
     bool f_carry = ((n & 0x80) >> 7) == 0x01;
     uint8_t temp_reg_byte = (n << 1);
 
-    reg.set_flag(FlagName::f_c, f_carry);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
@@ -706,10 +921,7 @@ uint8_t Cpu::alu_sra(uint8_t n)
     bool f_carry = (n & 0x01) == 0x01;
     uint8_t temp_reg_byte = (n >> 1) | (n & 0x80);
 
-    reg.set_flag(FlagName::f_c, f_carry);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
@@ -727,58 +939,22 @@ uint8_t Cpu::alu_srl(uint8_t n)
     bool f_carry = (n & 0x01) == 0x01;
     uint8_t temp_reg_byte = (n >> 1);
 
-    reg.set_flag(FlagName::f_c, f_carry);
-    reg.set_flag(FlagName::f_h, false);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
+    reg.set_flags_result(temp_reg_byte, f_carry ? FlagName::f_c : 0);
 
     return temp_reg_byte;
 }
 
-// Test bit b in register r.
-// b = 0 - 7, r = A,B,C,D,E,H,L,(HL)
-//
-// Flags affected:
-// Z - Set if bit b of register r is 0.
-// N - Reset.
-// H - Set.
-// C - Not affected
-void Cpu::alu_bit(uint8_t a, uint8_t b)
-{
-    uint8_t temp_reg_byte = (a & (0x01 << b));
-
-    reg.set_flag(FlagName::f_h, true);
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, !temp_reg_byte);
-}
-
-// Set bit b in register r.
-// b = 0 - 7, r = A,B,C,D,E,H,L,(HL)
-//
-// Flags affected:  None.
-uint8_t Cpu::alu_set(uint8_t a, uint8_t b)
-{
-    return (a | (0x01 << b));
-}
-
-// Reset bit b in register r.
-// b = 0 - 7, r = A,B,C,D,E,H,L,(HL)
-//
-// Flags affected:  None.
-uint8_t Cpu::alu_res(uint8_t a, uint8_t b)
-{
-    return (a & (~(0x01 << b)));
-}
-
 // Add n to current address and jump to it.
 // n = one byte signed immediate value
 void Cpu::alu_jr(Memory &mem)
 {
     int8_t temp_imm_byte = read_opcode_byte(mem);
-    uint32_t temp_r_pc_dword = reg.get_register_word(RegisterName::r_pc);
+    uint16_t temp_from_word = reg.get_register_word(RegisterName::r_pc);
+    uint32_t temp_r_pc_dword = temp_from_word;
     temp_r_pc_dword += temp_imm_byte;
     uint16_t temp_r_pc_word = temp_r_pc_dword & 0xffff;
     reg.set_register_word(RegisterName::r_pc, temp_r_pc_word);
+    branch_taken(mem, temp_from_word);
 }
 
 // Decode and execute opcode
@@ -802,7 +978,7 @@ void Cpu::ex_rlca(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_c
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte = alu_rlc(temp_r_a_byte);
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
-    reg.set_flag(FlagName::f_z, false);
+    reg.set_flags(reg.get_flags() & FlagName::f_c);
 }
 
 // RLA
@@ -811,7 +987,7 @@ void Cpu::ex_rla(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte = alu_rl(temp_r_a_byte);
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
-    reg.set_flag(FlagName::f_z, false);
+    reg.set_flags(reg.get_flags() & FlagName::f_c);
 }
 // RRCA
 void Cpu::ex_rrca(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
@@ -819,7 +995,7 @@ void Cpu::ex_rrca(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_c
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte = alu_rrc(temp_r_a_byte);
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
-    reg.set_flag(FlagName::f_z, false);
+    reg.set_flags(reg.get_flags() & FlagName::f_c);
 }
 
 // RRA
@@ -828,78 +1004,7 @@ void Cpu::ex_rra(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     temp_r_a_byte = alu_rr(temp_r_a_byte);
     reg.set_register_byte(RegisterName::r_a, temp_r_a_byte);
-    reg.set_flag(FlagName::f_z, false);
-}
-
-// 8-bit INC
-void Cpu::ex_inc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_inc(temp_reg_byte);
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit DEC
-void Cpu::ex_dec_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_dec(temp_reg_byte);
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit ADD
-void Cpu::ex_add_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_add(temp_reg_byte);
-}
-
-// 8-bit ADC
-void Cpu::ex_adc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_adc(temp_reg_byte);
-}
-
-// 8-bit SUB
-void Cpu::ex_sub_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_sub(temp_reg_byte);
-}
-
-// 8-bit SBC
-void Cpu::ex_sbc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_sbc(temp_reg_byte);
-}
-
-// 8-bit AND
-void Cpu::ex_and_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_and(temp_reg_byte);
+    reg.set_flags(reg.get_flags() & FlagName::f_c);
 }
 
 // 8-bit DDA
@@ -914,35 +1019,6 @@ void Cpu::ex_scf_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pref
     alu_scf();
 }
 
-// 8-bit XOR
-void Cpu::ex_xor_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_xor(temp_reg_byte);
-}
-
-// 8-bit OR
-void Cpu::ex_or_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_or(temp_reg_byte);
-}
-
-// 8-bit CP
-void Cpu::ex_cp_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    alu_cp(temp_reg_byte);
-}
 // 8-bit CPL
 void Cpu::ex_cpl_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
@@ -959,7 +1035,7 @@ void Cpu::ex_ccf_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pref
 // 8-bit INC
 void Cpu::ex_inc_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     uint8_t temp_reg_byte = alu_inc(temp_mem_byte);
     mem.set_memory_byte(temp_r_hl_word, temp_reg_byte);
@@ -968,7 +1044,7 @@ void Cpu::ex_inc_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit DEC
 void Cpu::ex_dec_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     uint8_t temp_reg_byte = alu_dec(temp_mem_byte);
     mem.set_memory_byte(temp_r_hl_word, temp_reg_byte);
@@ -977,7 +1053,7 @@ void Cpu::ex_dec_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit ADD
 void Cpu::ex_add_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_add(temp_mem_byte);
 }
@@ -985,7 +1061,7 @@ void Cpu::ex_add_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit ADC
 void Cpu::ex_adc_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_adc(temp_mem_byte);
 }
@@ -993,7 +1069,7 @@ void Cpu::ex_adc_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit SUB
 void Cpu::ex_sub_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_sub(temp_mem_byte);
 }
@@ -1001,7 +1077,7 @@ void Cpu::ex_sub_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit SBC
 void Cpu::ex_sbc_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_sbc(temp_mem_byte);
 }
@@ -1009,7 +1085,7 @@ void Cpu::ex_sbc_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit AND
 void Cpu::ex_and_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_and(temp_mem_byte);
 }
@@ -1017,7 +1093,7 @@ void Cpu::ex_and_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit XOR
 void Cpu::ex_xor_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_xor(temp_mem_byte);
 }
@@ -1025,7 +1101,7 @@ void Cpu::ex_xor_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pr
 // 8-bit OR
 void Cpu::ex_or_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_or(temp_mem_byte);
 }
@@ -1033,22 +1109,11 @@ void Cpu::ex_or_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_pre
 // 8-bit CP
 void Cpu::ex_cp_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     alu_cp(temp_mem_byte);
 }
 
-// 16-bit paired registers to HL ADD
-void Cpu::ex_add_pair_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from_first = args.arg_reg_from_0;
-    RegisterName from_second = args.arg_reg_from_1;
-
-    uint16_t temp_reg_word = reg.get_register_byte_pair(from_first, from_second);
-    alu_add_hl(temp_reg_word);
-}
-
 // ADD 8-bit imm
 void Cpu::ex_add_imm(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
@@ -1108,10 +1173,7 @@ void Cpu::ex_sbc_imm(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefi
 // 16-bit SP to HL ADD
 void Cpu::ex_add_sp_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint16_t temp_reg_word = reg.get_register_word(from);
+    uint16_t temp_reg_word = reg.get_register_word(RegisterName::r_sp);
     alu_add_hl(temp_reg_word);
 }
 
@@ -1121,55 +1183,22 @@ void Cpu::ex_add_r8_to_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_
     alu_add_sp(mem);
 }
 
-// 16-bit DEC
-void Cpu::ex_dec_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self_first = args.arg_reg_from_0;
-    RegisterName self_second = args.arg_reg_from_1;
-
-    // Flags affected: None
-    uint16_t temp_reg_word = reg.get_register_byte_pair(self_first, self_second);
-    temp_reg_word -= 1;
-
-    reg.set_register_byte_pair(self_first, self_second, temp_reg_word);
-}
-
 // 16-bit DEC
 void Cpu::ex_dec_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint16_t temp_reg_word = reg.get_register_word(self);
+    uint16_t temp_reg_word = reg.get_register_word(RegisterName::r_sp);
     temp_reg_word -= 1;
 
-    reg.set_register_word(self, temp_reg_word);
-}
-
-// 16-bit paired registers INC
-void Cpu::ex_inc_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self_first = args.arg_reg_from_0;
-    RegisterName self_second = args.arg_reg_from_1;
-
-    uint16_t temp_reg_word = reg.get_register_byte_pair(self_first, self_second);
-    temp_reg_word += 1;
-
-    reg.set_register_byte_pair(self_first, self_second, temp_reg_word);
+    reg.set_register_word(RegisterName::r_sp, temp_reg_word);
 }
 
 // 16-bit INC
 void Cpu::ex_inc_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint16_t temp_reg_word = reg.get_register_word(self);
+    uint16_t temp_reg_word = reg.get_register_word(RegisterName::r_sp);
     temp_reg_word += 1;
 
-    reg.set_register_word(self, temp_reg_word);
+    reg.set_register_word(RegisterName::r_sp, temp_reg_word);
 }
 
 // JR
@@ -1238,7 +1267,9 @@ void Cpu::ex_jr_c(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_c
 void Cpu::ex_jp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
     uint16_t temp_imm_word = read_opcode_word(mem);
+    uint16_t temp_from_word = reg.get_register_word(RegisterName::r_pc);
     reg.set_register_word(RegisterName::r_pc, temp_imm_word);
+    branch_taken(mem, temp_from_word);
 }
 
 // JP NZ
@@ -1248,7 +1279,9 @@ void Cpu::ex_jp_nz(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_
     uint16_t temp_imm_word = read_opcode_word(mem);
     if (!f_z)
     {
+        uint16_t temp_from_word = reg.get_register_word(RegisterName::r_pc);
         reg.set_register_word(RegisterName::r_pc, temp_imm_word);
+        branch_taken(mem, temp_from_word);
     }
 }
 
@@ -1259,7 +1292,9 @@ void Cpu::ex_jp_nc(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_
     int16_t temp_imm_word = read_opcode_word(mem);
     if (!f_c)
     {
+        uint16_t temp_from_word = reg.get_register_word(RegisterName::r_pc);
         reg.set_register_word(RegisterName::r_pc, temp_imm_word);
+        branch_taken(mem, temp_from_word);
     }
 }
 
@@ -1270,7 +1305,9 @@ void Cpu::ex_jp_z(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_c
     uint16_t temp_imm_word = read_opcode_word(mem);
     if (f_z)
     {
+        uint16_t temp_from_word = reg.get_register_word(RegisterName::r_pc);
         reg.set_register_word(RegisterName::r_pc, temp_imm_word);
+        branch_taken(mem, temp_from_word);
     }
 }
 
@@ -1281,14 +1318,16 @@ void Cpu::ex_jp_c(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_c
     uint16_t temp_imm_word = read_opcode_word(mem);
     if (f_c)
     {
+        uint16_t temp_from_word = reg.get_register_word(RegisterName::r_pc);
         reg.set_register_word(RegisterName::r_pc, temp_imm_word);
+        branch_taken(mem, temp_from_word);
     }
 }
 
 // JP (HL)
 void Cpu::ex_jp_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     reg.set_register_word(RegisterName::r_pc, temp_r_hl_word);
 }
 
@@ -1525,86 +1564,15 @@ void Cpu::ex_di(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 
 // LD
 // 8-bit LD
-// LD 8-bit register to 8-bit register
-void Cpu::ex_ld_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-    RegisterName to = args.arg_reg_to_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    reg.set_register_byte(to, temp_reg_byte);
-}
-
-// LD 8-bit imm to 8-bit register
-void Cpu::ex_ld_imm_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName to = args.arg_reg_to_0;
-
-    uint8_t temp_imm_byte = read_opcode_byte(mem);
-    reg.set_register_byte(to, temp_imm_byte);
-}
-
 // LD 8-bit imm to (HL) in memory
 void Cpu::ex_ld_imm_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_imm_byte = read_opcode_byte(mem);
 
     mem.set_memory_byte(temp_r_hl_word, temp_imm_byte);
 }
 
-// LD (BC or DE) in memory to A
-void Cpu::ex_ld_pair_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from_first = args.arg_reg_from_0;
-    RegisterName from_second = args.arg_reg_from_1;
-
-    uint16_t temp_pair_word = reg.get_register_byte_pair(from_first, from_second);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_pair_word);
-
-    reg.set_register_byte(RegisterName::r_a, temp_mem_byte);
-}
-
-// LD A to (BC or DE) in memory
-void Cpu::ex_ld_byte_to_pair_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName to_first = args.arg_reg_to_0;
-    RegisterName to_second = args.arg_reg_to_1;
-
-    uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
-    uint16_t temp_pair_word = reg.get_register_byte_pair(to_first, to_second);
-
-    mem.set_memory_byte(temp_pair_word, temp_r_a_byte);
-}
-
-// LD 8-bit register to (HL) in memory
-void Cpu::ex_ld_byte_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName from = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(from);
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-
-    mem.set_memory_byte(temp_r_hl_word, temp_reg_byte);
-}
-
-// LD (HL) in memory to 8-bit register
-void Cpu::ex_ld_hl_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName to = args.arg_reg_to_0;
-
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    reg.set_register_byte(to, temp_mem_byte);
-}
-
  // LD (n) in memory to 8-bit A, n is 16-bit imm
 void Cpu::ex_ld_n_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
@@ -1625,45 +1593,45 @@ void Cpu::ex_ld_byte_to_n_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opc
 // LDD 8-bit register A to (HL) in memory
 void Cpu::ex_ldd_byte_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     mem.set_memory_byte(temp_r_hl_word, temp_r_a_byte);
 
     temp_r_hl_word -= 1;
-    reg.set_register_byte_pair(RegisterName::r_h, RegisterName::r_l, temp_r_hl_word);
+    reg.set_pair(PairName::p_hl, temp_r_hl_word);
 }
 // LDD (HL) in memory to 8-bit register A
 void Cpu::ex_ldd_hl_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     reg.set_register_byte(RegisterName::r_a, temp_mem_byte);
 
     temp_r_hl_word -= 1;
-    reg.set_register_byte_pair(RegisterName::r_h, RegisterName::r_l, temp_r_hl_word);
+    reg.set_pair(PairName::p_hl, temp_r_hl_word);
 }
 
 // LDI: LD INC
 // LDI 8-bit register A to (HL) in memory
 void Cpu::ex_ldi_byte_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_r_a_byte = reg.get_register_byte(RegisterName::r_a);
     mem.set_memory_byte(temp_r_hl_word, temp_r_a_byte);
 
     temp_r_hl_word += 1;
-    reg.set_register_byte_pair(RegisterName::r_h, RegisterName::r_l, temp_r_hl_word);
+    reg.set_pair(PairName::p_hl, temp_r_hl_word);
 }
 
 // LDI (HL) in memory to 8-bit register A
 void Cpu::ex_ldi_hl_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
     reg.set_register_byte(RegisterName::r_a, temp_mem_byte);
 
     temp_r_hl_word += 1;
-    reg.set_register_byte_pair(RegisterName::r_h, RegisterName::r_l, temp_r_hl_word);
+    reg.set_pair(PairName::p_hl, temp_r_hl_word);
 }
 
 // 8-bit Zero Page LD
@@ -1707,17 +1675,6 @@ void Cpu::ex_ldh_n_zp_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opc
 }
 
 // 16-bit LD
-// LD 16-bit imm to 16-bit paired registers
-void Cpu::ex_ld_imm_to_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName to_first = args.arg_reg_to_0;
-    RegisterName to_second = args.arg_reg_to_1;
-
-    uint16_t temp_imm_word = read_opcode_word(mem);
-    reg.set_register_byte_pair(to_first, to_second, temp_imm_word);
-}
-
 // LD 16-bit imm to 16-bit SP
 void Cpu::ex_ld_imm_to_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
@@ -1737,7 +1694,7 @@ void Cpu::ex_ld_sp_to_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_
 // LD 16-bit HL to 16-bit SP
 void Cpu::ex_ld_hl_to_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
 {
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
     reg.set_register_word(RegisterName::r_sp, temp_r_hl_word);
 }
 
@@ -1751,38 +1708,12 @@ void Cpu::ex_ld_sp_r8_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcod
     int8_t temp_r8_word = read_opcode_byte(mem);
 
     bool f_carry = (temp_r_sp_word & 0x00ff) + (temp_r8_word & 0x00ff) > 0x00ff;
-    reg.set_flag(FlagName::f_c, f_carry);
-
     bool f_half_carry = (temp_r_sp_word & 0x000f) + (temp_r8_word & 0x000f) > 0x000f;
-    reg.set_flag(FlagName::f_h, f_half_carry);
 
-    reg.set_flag(FlagName::f_n, false);
-    reg.set_flag(FlagName::f_z, false);
+    reg.set_flags((f_half_carry ? FlagName::f_h : 0) | (f_carry ? FlagName::f_c : 0));
 
     uint16_t temp_reg_word = temp_r8_word + temp_r_sp_word;
-    reg.set_register_byte_pair(RegisterName::r_h, RegisterName::r_l, temp_reg_word);
-}
-
-// 16-bit PUSH
-void Cpu::ex_push_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self_first = args.arg_reg_from_0;
-    RegisterName self_second = args.arg_reg_from_1;
-
-    uint16_t temp_pair_word = reg.get_register_byte_pair(self_first, self_second);
-    stack_add(mem, temp_pair_word);
-}
-
-// 16-bit POP
-void Cpu::ex_pop_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_main[opcode_main];
-    RegisterName self_first = args.arg_reg_from_0;
-    RegisterName self_second = args.arg_reg_from_1;
-
-    uint16_t temp_mem_word = stack_pop(mem);
-    reg.set_register_byte_pair(self_first, self_second, temp_mem_word);
+    reg.set_pair(PairName::p_hl, temp_reg_word);
 }
 
 // 16-bit POP AF
@@ -1790,258 +1721,7 @@ void Cpu::ex_pop_af(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix
 {
     uint16_t temp_mem_word = stack_pop(mem);
     temp_mem_word &= 0xfff0;
-    reg.set_register_byte_pair(RegisterName::r_a, RegisterName::r_f, temp_mem_word);
-}
-
-// Opcode Prefix CB
-// 8-bit RLC
-void Cpu::ex_rlc_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_rlc(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit RRC
-void Cpu::ex_rrc_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_rrc(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit RL
-void Cpu::ex_rl_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_rl(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit RR
-void Cpu::ex_rr_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_rr(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit SLA
-void Cpu::ex_sla_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_sla(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit SRA
-void Cpu::ex_sra_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_sra(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit SWAP
-void Cpu::ex_swap_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_swap(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit SRL
-void Cpu::ex_srl_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_srl(temp_reg_byte);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit BIT
-void Cpu::ex_bit_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-    uint8_t bit = args.arg_bit;
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-
-    alu_bit(temp_reg_byte, bit);
-}
-// 8-bit RES
-void Cpu::ex_res_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-    uint8_t bit = args.arg_bit;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_res(temp_reg_byte, bit);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 8-bit SET
-void Cpu::ex_set_byte(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    RegisterName self = args.arg_reg_from_0;
-    uint8_t bit = args.arg_bit;
-
-    uint8_t temp_reg_byte = reg.get_register_byte(self);
-    temp_reg_byte = alu_set(temp_reg_byte, bit);
-
-    reg.set_register_byte(self, temp_reg_byte);
-}
-
-// 16-bit RLC for (HL) in memory
-void Cpu::ex_rlc_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_rlc(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit RRC for (HL) in memory
-void Cpu::ex_rrc_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_rrc(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit RL for (HL) in memory
-void Cpu::ex_rl_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_rl(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit RR for (HL) in memory
-void Cpu::ex_rr_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_rr(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit SLA for (HL) in memory
-void Cpu::ex_sla_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_sla(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit SRA for (HL) in memory
-void Cpu::ex_sra_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_sra(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit SWAP for (HL) in memory
-void Cpu::ex_swap_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_swap(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit SRL for (HL) in memory
-void Cpu::ex_srl_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_srl(temp_mem_byte);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit BIT for (HL) in memory
-void Cpu::ex_bit_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    uint8_t bit = args.arg_bit;
-
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    alu_bit(temp_mem_byte, bit);
-}
-
-// 16-bit RES for (HL) in memory
-void Cpu::ex_res_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    uint8_t bit = args.arg_bit;
-
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_res(temp_mem_byte, bit);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
-}
-
-// 16-bit SET for (HL) in memory
-void Cpu::ex_set_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
-{
-    PackedArgs args = opcode_args_prefix_cb[opcode_prefix_cb];
-    uint8_t bit = args.arg_bit;
-
-    uint16_t temp_r_hl_word = reg.get_register_byte_pair(RegisterName::r_h, RegisterName::r_l);
-    uint8_t temp_mem_byte = mem.get_memory_byte(temp_r_hl_word);
-
-    temp_mem_byte = alu_set(temp_mem_byte, bit);
-    mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
+    reg.set_pair(PairName::p_af, temp_mem_word);
 }
 
 // Continue to decode and execute Opcode Prefix CB
@@ -4,7 +4,16 @@
 #define GAMEBOY_CPU_H
 #include "register.h"
 #include "memory.h"
+#include "block-cache.h"
+#include "dynarec.h"
 #include <cstdint>
+#include <cstring>
+
+// The threaded core needs labels as values (GNU extension)
+// Build option: GAMEBOY_THREADED_INTERPRETER in CMakeLists.txt
+#if defined(GAMEBOY_THREADED_INTERPRETER) && !defined(__GNUC__)
+#undef GAMEBOY_THREADED_INTERPRETER
+#endif
 
 namespace gameboy
 {
@@ -53,571 +62,58 @@ const uint8_t opcode_cycle_prefix_cb[256] = {
     2, 2, 2, 2, 2, 2, 4, 2, 2, 2, 2, 2, 2, 2, 4, 2, // f
 };
 
-struct PackedArgs
-{
-    PackedArgs(RegisterName from_0, RegisterName from_1, RegisterName to_0, RegisterName to_1, uint8_t bit):
-        arg_reg_from_0(from_0), arg_reg_from_1(from_1), arg_reg_to_0(to_0), arg_reg_to_1(to_1), arg_bit(bit) {}
-    RegisterName arg_reg_from_0; // From / Self
-    RegisterName arg_reg_from_1; // From (paried 8-bit register)
-    RegisterName arg_reg_to_0; // To
-    RegisterName arg_reg_to_1; // To (paired 8-bit register)
-
-    uint8_t arg_bit; // Bit for Prefix CB Opcodes
+// Bytes of each main opcode, immediates included, as read by its ex_ handler
+// STOP reads no operand here
+const uint8_t opcode_length_main[256] = {
+    //  0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f
+    1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1, // 0
+    1, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 1
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 2
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 3
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 4
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 5
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 6
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 7
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 8
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 9
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // a
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // b
+    1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1, // c
+    1, 1, 3, 1, 3, 1, 2, 1, 1, 1, 3, 1, 3, 1, 2, 1, // d
+    2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1, // e
+    2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1, // f
 };
 
-// Arguments 
-#define NULLREG RegisterName::r_a
-#define NULLBIT 0
-#define NULLARG PackedArgs(RegisterName::r_a, RegisterName::r_a, RegisterName::r_a, RegisterName::r_a, 0)
-// Main
-const PackedArgs opcode_args_main[256] = 
-{   // arg_reg_from_0, arg_reg_from_1, arg_reg_to_0, arg_reg_to_1, arg_bit
-    NULLARG, // 0x00 null
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_b, RegisterName::r_c, NULLBIT), //0x01 to BC
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_b, RegisterName::r_c, NULLBIT), //0x02 to BC
-    PackedArgs(RegisterName::r_b, RegisterName::r_c, NULLREG, NULLREG, NULLBIT), // 0x03 self BC
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x04 self B
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x05 self B
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x06 to B
-    NULLARG, // 0x07 null
-    NULLARG, // 0x08 null
-    PackedArgs(RegisterName::r_b, RegisterName::r_c, NULLREG, NULLREG, NULLBIT), // 0x09 from BC
-    PackedArgs(RegisterName::r_b, RegisterName::r_c, NULLREG, NULLREG, NULLBIT), // 0x0a from BC
-    PackedArgs(RegisterName::r_b, RegisterName::r_c, NULLREG, NULLREG, NULLBIT), // 0x0b self BC
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0c self C
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0d self C
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x0e to C
-    NULLARG, // 0x0f null
-
-    NULLARG, // 0x10 null
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_d, RegisterName::r_e, NULLBIT), // 0x11 to DE
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_d, RegisterName::r_e, NULLBIT), // 0x12 to DE
-    PackedArgs(RegisterName::r_d, RegisterName::r_e, NULLREG, NULLREG, NULLBIT), // 0x13 self DE
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x14 self D
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x15 self D
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x16 to D
-    NULLARG, // 0x17 null
-    NULLARG, // 0x18 null
-    PackedArgs(RegisterName::r_d, RegisterName::r_e, NULLREG, NULLREG, NULLBIT), // 0x19 from DE
-    PackedArgs(RegisterName::r_d, RegisterName::r_e, NULLREG, NULLREG, NULLBIT), // 0x1a from DE
-    PackedArgs(RegisterName::r_d, RegisterName::r_e, NULLREG, NULLREG, NULLBIT), // 0X1b self DE
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1c self E
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1d self E
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x1e to E
-    NULLARG, // 0x0f null
-
-    NULLARG, // 0x20 null
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_h, RegisterName::r_l, NULLBIT), // 0x21 to HL
-    NULLARG, // 0x22 null
-    PackedArgs(RegisterName::r_h, RegisterName::r_l, NULLREG, NULLREG, NULLBIT), // 0x23 self HL
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x24 self H
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x25 self H
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x26 to H
-    NULLARG, // 0x27 null
-    NULLARG, // 0x28 null
-    PackedArgs(RegisterName::r_h, RegisterName::r_l, NULLREG, NULLREG, NULLBIT), // 0x29 from HL
-    NULLARG, // 0x2a null
-    PackedArgs(RegisterName::r_h, RegisterName::r_l, NULLREG, NULLREG, NULLBIT), // 0x2b self HL
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2c self L
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2d self L
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x2e to L
-    NULLARG, // 0x2f null
-    
-    NULLARG, // 0x30 null
-    NULLARG, // 0x31 null
-    NULLARG, // 0x32 null
-    NULLARG, // 0x33 null
-    NULLARG, // 0x34 null
-    NULLARG, // 0x35 null
-    NULLARG, // 0x36 null
-    NULLARG, // 0x37 null
-    NULLARG, // 0x38 null
-    NULLARG, // 0x39 null
-    NULLARG, // 0x3a null
-    NULLARG, // 0x3b null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3c self A
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3d self A
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x3e to A
-    NULLARG, // 0x3f
-
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x40 from B to B
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x41 from C to B
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x42 from D to B
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x43 from E to B
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x44 from H to B
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x45 from L to B
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x46 to B
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_b, NULLREG, NULLBIT), // 0x47 from A to B
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x48 from B to C
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x49 from C to C
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x4a from D to C
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x4b from E to C
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x4c from H to C
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x4d from L to C
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x4e to C
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_c, NULLREG, NULLBIT), // 0x4f from A to C
-
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x50 from B to D
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x51 from C to D
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x52 from D to D
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x53 from E to D
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x54 from H to D
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x55 from L to D
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x56 to D
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_d, NULLREG, NULLBIT), // 0x57 from A to D
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x58 from B to E
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x59 from C to E
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x5a from D to E
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x5b from E to E
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x5c from H to E
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x5d from L to E
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x5e to E
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_e, NULLREG, NULLBIT), // 0x5f from A to E
-
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x60 from B to H
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x61 from C to H
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x62 from D to H
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x63 from E to H
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x64 from H to H
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x65 from L to H
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x66 to H
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_h, NULLREG, NULLBIT), // 0x67 from A to H
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x68 from B to L
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x69 from C to L
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x6a from D to L
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x6b from E to L
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x6c from H to L
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x6d from L to L
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x6e to L
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_l, NULLREG, NULLBIT), // 0x6f from A to L
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x70 from B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x71 from C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x72 from D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x73 from E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x74 from H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x75 from L
-    NULLARG, // 0x76 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x77 from A
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x78 from B to A
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x79 from C to A
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x7a from D to A
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x7b from E to A
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x7c from H to A
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x7d from L to A
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x7e to A
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x7f from A to A
-
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x80 from B to A
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x81 from C to A
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x82 from D to A
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x83 from E to A
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x84 from H to A
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x85 from L to A
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x86 to A
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x87 from A to A
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x88 from B to A
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x89 from C to A
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x8a from D to A
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x8b from E to A
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x8c from H to A
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x8d from L to A
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x8e to A
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x8f from A to A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x90 from B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x91 from C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x92 from D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x93 from E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x94 from H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x95 from L
-    NULLARG, // 0x96 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x97 from A
-    PackedArgs(RegisterName::r_b, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x98 from B to A
-    PackedArgs(RegisterName::r_c, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x99 from C to A
-    PackedArgs(RegisterName::r_d, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x9a from D to A
-    PackedArgs(RegisterName::r_e, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x9b from E to A
-    PackedArgs(RegisterName::r_h, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x9c from H to A
-    PackedArgs(RegisterName::r_l, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x9d from L to A
-    PackedArgs(NULLREG, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x9e to A
-    PackedArgs(RegisterName::r_a, NULLREG, RegisterName::r_a, NULLREG, NULLBIT), // 0x9f from A to A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa0 from B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa1 from C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa2 from D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa3 from E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa4 from H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa5 from L
-    NULLARG, // 0xa6 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa7 from A
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa8 from B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xa9 from C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xaa from D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xab from E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xac from H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xad from L
-    NULLARG, // 0xae null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xaf from A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb0 from B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb1 from C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb2 from D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb3 from E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb4 from H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb5 from L
-    NULLARG, // 0xb6 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb7 from A
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb8 from B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xb9 from C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xba from D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xbb from E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xbc from H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xbd from L
-    NULLARG, // 0xbe null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0xbf from A
-
-    NULLARG, // 0xc0 null
-    PackedArgs(RegisterName::r_b, RegisterName::r_c, NULLREG, NULLREG, NULLBIT), // 0xc1 self BC
-    NULLARG, // 0xc2 null
-    NULLARG, // 0xc3 null
-    NULLARG, // 0xc4 null
-    PackedArgs(RegisterName::r_b, RegisterName::r_c, NULLREG, NULLREG, NULLBIT), // 0xc5 self BC
-    NULLARG, // 0xc6 null
-    NULLARG, // 0xc7 null
-    NULLARG, // 0xc8 null
-    NULLARG, // 0xc9 null
-    NULLARG, // 0xca null
-    NULLARG, // 0xcb null Prefix CB
-    NULLARG, // 0xcc null
-    NULLARG, // 0xcd null
-    NULLARG, // 0xce null
-    NULLARG, // 0xcf null
-
-    NULLARG, // 0xd0 null
-    PackedArgs(RegisterName::r_d, RegisterName::r_e, NULLREG, NULLREG, NULLBIT), // 0xd1 self DE
-    NULLARG, // 0xd2 null
-    NULLARG, // 0xd3 null
-    NULLARG, // 0xd4 null
-    PackedArgs(RegisterName::r_d, RegisterName::r_e, NULLREG, NULLREG, NULLBIT), // 0xd5 self DE
-    NULLARG, // 0xd6 null
-    NULLARG, // 0xd7 null
-    NULLARG, // 0xd8 null
-    NULLARG, // 0xd9 null
-    NULLARG, // 0xda null
-    NULLARG, // 0xdb null
-    NULLARG, // 0xdc null
-    NULLARG, // 0xdd null
-    NULLARG, // 0xde null
-    NULLARG, // 0xdf null
-
-    NULLARG, // 0xe0 null
-    PackedArgs(RegisterName::r_h, RegisterName::r_l, NULLREG, NULLREG, NULLBIT), // 0xe1 self HL
-    NULLARG, // 0xe2 null
-    NULLARG, // 0xe3 null
-    NULLARG, // 0xe4 null
-    PackedArgs(RegisterName::r_h, RegisterName::r_l, NULLREG, NULLREG, NULLBIT), // 0xe5 self HL
-    NULLARG, // 0xe6 null
-    NULLARG, // 0xe7 null
-    NULLARG, // 0xe8 null
-    NULLARG, // 0xe9 null
-    NULLARG, // 0xea null
-    NULLARG, // 0xeb null
-    NULLARG, // 0xec null
-    NULLARG, // 0xed null
-    NULLARG, // 0xee null
-    NULLARG, // 0xef null
-
-    NULLARG, // 0xf0 null
-    NULLARG, // 0xf1 null
-    NULLARG, // 0xf2 null
-    NULLARG, // 0xf3 null
-    NULLARG, // 0xf4 null
-    PackedArgs(RegisterName::r_a, RegisterName::r_f, NULLREG, NULLREG, NULLBIT), // 0xf5 self AF
-    NULLARG, // 0xf6 null
-    NULLARG, // 0xf7 null
-    NULLARG, // 0xf8 null
-    NULLARG, // 0xf9 null
-    NULLARG, // 0xfa null
-    NULLARG, // 0xfb null
-    NULLARG, // 0xfc null
-    NULLARG, // 0xfd null
-    NULLARG, // 0xfe null
-    NULLARG, // 0xff null
+// Longest loop body (in bytes, branch included) checked for idle loops
+#define IDLE_LOOP_MAX_BYTES 16
+
+// CPU state at a short backward branch, see Cpu::check_idle_loop
+// Cleared with memset before it is filled, so memcmp can compare it
+struct IdleLoopState
+{
+    uint8_t register_byte[8];
+    uint16_t register_word[2]; // SP, PC (the branch target)
+    uint8_t flag_state[6];     // lazy flags: op, x, y, carry, result, fixed
+    bool f_enable_interrupts;
+    uint64_t write_count;
 };
 
-const PackedArgs opcode_args_prefix_cb[256] = 
-{   // arg_reg_from_0, arg_reg_from_1, arg_reg_to_0, arg_reg_to_1, arg_bit
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x00 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x01 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x02 self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x03 self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x04 self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x05 self L
-    NULLARG, // 0x06 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x07 self A
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x08 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x09 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0a self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0b self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0c self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0d self L
-    NULLARG, // 0x0e null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x0f self A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x10 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x11 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x12 self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x13 self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x14 self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x15 self L
-    NULLARG, // 0x16 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x17 self A
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x18 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x19 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1a self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1b self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1c self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1d self L
-    NULLARG, // 0x1e null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x1f self A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x20 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x21 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x22 self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x23 self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x24 self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x25 self L
-    NULLARG, // 0x26 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x27 self A
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x28 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x29 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2a self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2b self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2c self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2d self L
-    NULLARG, // 0x2e null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x2f self A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x30 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x31 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x32 self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x33 self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x34 self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x35 self L
-    NULLARG, // 0x36 null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x37 self A
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x38 self B
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x39 self C
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3a self D
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3b self E
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3c self H
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3d self L
-    NULLARG, // 0x3e null
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, NULLBIT), // 0x3f self A
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 0), // 0x40 self B bit 0
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 0), // 0x41 self C bit 0
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 0), // 0x42 self D bit 0
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 0), // 0x43 self E bit 0
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 0), // 0x44 self H bit 0
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 0), // 0x45 self L bit 0
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 0), // 0x46 bit 0
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 0), // 0x47 self A bit 0
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 1), // 0x48 self B bit 1
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 1), // 0x49 self C bit 1
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 1), // 0x4a self D bit 1
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 1), // 0x4b self E bit 1
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 1), // 0x4c self H bit 1
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 1), // 0x4d self L bit 1
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 1), // 0x4e bit 1
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 1), // 0x4f self A bit 1
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 2), // 0x50 self B bit 2
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 2), // 0x51 self C bit 2
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 2), // 0x52 self D bit 2
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 2), // 0x53 self E bit 2
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 2), // 0x54 self H bit 2
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 2), // 0x55 self L bit 2
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 2), // 0x56 bit 2
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 2), // 0x57 self A bit 2
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 3), // 0x58 self B bit 3
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 3), // 0x59 self C bit 3
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 3), // 0x5a self D bit 3
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 3), // 0x5b self E bit 3
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 3), // 0x5c self H bit 3
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 3), // 0x5d self L bit 3
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 3), // 0x5e bit 3
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 3), // 0x5f self A bit 3
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 4), // 0x60 self B bit 4
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 4), // 0x61 self C bit 4
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 4), // 0x62 self D bit 4
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 4), // 0x63 self E bit 4
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 4), // 0x64 self H bit 4
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 4), // 0x65 self L bit 4
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 4), // 0x66 bit 4
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 4), // 0x67 self A bit 4
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 5), // 0x68 self B bit 5
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 5), // 0x69 self C bit 5
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 5), // 0x6a self D bit 5
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 5), // 0x6b self E bit 5
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 5), // 0x6c self H bit 5
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 5), // 0x6d self L bit 5
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 5), // 0x6e bit 5
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 5), // 0x6f self A bit 5
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 6), // 0x70 self B bit 6
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 6), // 0x71 self C bit 6
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 6), // 0x72 self D bit 6
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 6), // 0x73 self E bit 6
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 6), // 0x74 self H bit 6
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 6), // 0x75 self L bit 6
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 6), // 0x76 bit 6
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 6), // 0x77 self A bit 6
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 7), // 0x78 self B bit 7
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 7), // 0x79 self C bit 7
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 7), // 0x7a self D bit 7
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 7), // 0x7b self E bit 7
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 7), // 0x7c self H bit 7
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 7), // 0x7d self L bit 7
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 7), // 0x7e bit 7
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 7), // 0x7f self A bit 7
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 0), // 0x80 self B bit 0
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 0), // 0x81 self C bit 0
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 0), // 0x82 self D bit 0
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 0), // 0x83 self E bit 0
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 0), // 0x84 self H bit 0
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 0), // 0x85 self L bit 0
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 0), // 0x86 bit 0
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 0), // 0x87 self A bit 0
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 1), // 0x88 self B bit 1
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 1), // 0x89 self C bit 1
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 1), // 0x8a self D bit 1
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 1), // 0x8b self E bit 1
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 1), // 0x8c self H bit 1
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 1), // 0x8d self L bit 1
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 1), // 0x8e bit 1
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 1), // 0x8f self A bit 1
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 2), // 0x90 self B bit 2
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 2), // 0x91 self C bit 2
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 2), // 0x92 self D bit 2
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 2), // 0x93 self E bit 2
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 2), // 0x94 self H bit 2
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 2), // 0x95 self L bit 2
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 2), // 0x96 bit 2
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 2), // 0x97 self A bit 2
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 3), // 0x98 self B bit 3
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 3), // 0x99 self C bit 3
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 3), // 0x9a self D bit 3
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 3), // 0x9b self E bit 3
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 3), // 0x9c self H bit 3
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 3), // 0x9d self L bit 3
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 3), // 0x9e bit 3
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 3), // 0x9f self A bit 3
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 4), // 0xa0 self B bit 4
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 4), // 0xa1 self C bit 4
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 4), // 0xa2 self D bit 4
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 4), // 0xa3 self E bit 4
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 4), // 0xa4 self H bit 4
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 4), // 0xa5 self L bit 4
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 4), // 0xa6 bit 4
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 4), // 0xa7 self A bit 4
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 5), // 0xa8 self B bit 5
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 5), // 0xa9 self C bit 5
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 5), // 0xaa self D bit 5
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 5), // 0xab self E bit 5
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 5), // 0xac self H bit 5
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 5), // 0xad self L bit 5
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 5), // 0xae bit 5
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 5), // 0xaf self A bit 5
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 6), // 0xb0 self B bit 6
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 6), // 0xb1 self C bit 6
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 6), // 0xb2 self D bit 6
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 6), // 0xb3 self E bit 6
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 6), // 0xb4 self H bit 6
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 6), // 0xb5 self L bit 6
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 6), // 0xb6 bit 6
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 6), // 0xb7 self A bit 6
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 7), // 0xb8 self B bit 7
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 7), // 0xb9 self C bit 7
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 7), // 0xba self D bit 7
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 7), // 0xbb self E bit 7
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 7), // 0xbc self H bit 7
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 7), // 0xbd self L bit 7
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 7), // 0xbe bit 7
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 7), // 0xbf self A bit 7
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 0), // 0xc0 self B bit 0
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 0), // 0xc1 self C bit 0
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 0), // 0xc2 self D bit 0
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 0), // 0xc3 self E bit 0
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 0), // 0xc4 self H bit 0
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 0), // 0xc5 self L bit 0
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 0), // 0xc6 bit 0
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 0), // 0xc7 self A bit 0
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 1), // 0xc8 self B bit 1
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 1), // 0xc9 self C bit 1
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 1), // 0xca self D bit 1
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 1), // 0xcb self E bit 1
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 1), // 0xcc self H bit 1
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 1), // 0xcd self L bit 1
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 1), // 0xce bit 1
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 1), // 0xcf self A bit 1
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 2), // 0xd0 self B bit 2
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 2), // 0xd1 self C bit 2
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 2), // 0xd2 self D bit 2
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 2), // 0xd3 self E bit 2
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 2), // 0xd4 self H bit 2
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 2), // 0xd5 self L bit 2
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 2), // 0xd6 bit 2
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 2), // 0xd7 self A bit 2
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 3), // 0xd8 self B bit 3
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 3), // 0xd9 self C bit 3
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 3), // 0xda self D bit 3
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 3), // 0xdb self E bit 3
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 3), // 0xdc self H bit 3
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 3), // 0xdd self L bit 3
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 3), // 0xde bit 3
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 3), // 0xdf self A bit 3
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 4), // 0xe0 self B bit 4
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 4), // 0xe1 self C bit 4
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 4), // 0xe2 self D bit 4
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 4), // 0xe3 self E bit 4
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 4), // 0xe4 self H bit 4
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 4), // 0xe5 self L bit 4
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 4), // 0xe6 bit 4
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 4), // 0xe7 self A bit 4
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 5), // 0xe8 self B bit 5
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 5), // 0xe9 self C bit 5
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 5), // 0xea self D bit 5
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 5), // 0xeb self E bit 5
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 5), // 0xec self H bit 5
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 5), // 0xed self L bit 5
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 5), // 0xee bit 5
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 5), // 0xef self A bit 5
-
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 6), // 0xf0 self B bit 6
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 6), // 0xf1 self C bit 6
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 6), // 0xf2 self D bit 6
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 6), // 0xf3 self E bit 6
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 6), // 0xf4 self H bit 6
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 6), // 0xf5 self L bit 6
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 6), // 0xf6 bit 6
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 6), // 0xf7 self A bit 6
-    PackedArgs(RegisterName::r_b, NULLREG, NULLREG, NULLREG, 7), // 0xf8 self B bit 7
-    PackedArgs(RegisterName::r_c, NULLREG, NULLREG, NULLREG, 7), // 0xf9 self C bit 7
-    PackedArgs(RegisterName::r_d, NULLREG, NULLREG, NULLREG, 7), // 0xfa self D bit 7
-    PackedArgs(RegisterName::r_e, NULLREG, NULLREG, NULLREG, 7), // 0xfb self E bit 7
-    PackedArgs(RegisterName::r_h, NULLREG, NULLREG, NULLREG, 7), // 0xfc self H bit 7
-    PackedArgs(RegisterName::r_l, NULLREG, NULLREG, NULLREG, 7), // 0xfd self L bit 7
-    PackedArgs(NULLREG, NULLREG, NULLREG, NULLREG, 7), // 0xfe bit 7
-    PackedArgs(RegisterName::r_a, NULLREG, NULLREG, NULLREG, 7), // 0xff self A bit 7
+// Prefix CB opcodes are a grid: operation (bits 7~3) x register (bits 2~0, B C D E H L (HL) A)
+// BIT, RES and SET take bit b from bits 5~3
+// Prefix cb_ means prefix CB operation
+enum CbOperation
+{
+    cb_rlc = 0,
+    cb_rrc = 1,
+    cb_rl = 2,
+    cb_rr = 3,
+    cb_sla = 4,
+    cb_sra = 5,
+    cb_swap = 6,
+    cb_srl = 7,
+    cb_bit = 8,
+    cb_res = 9,
+    cb_set = 10
 };
 
 class Cpu
@@ -638,54 +134,54 @@ class Cpu
         // Function Table
         // Main
         handle_opcode_main[0x00] = &Cpu::ex_nop;
-        handle_opcode_main[0x01] = &Cpu::ex_ld_imm_to_pair;
-        handle_opcode_main[0x02] = &Cpu::ex_ld_byte_to_pair_mem;
-        handle_opcode_main[0x03] = &Cpu::ex_inc_pair;
-        handle_opcode_main[0x04] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x05] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x06] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x01] = &Cpu::ex_ld_imm_to_pair<PairName::p_bc>;
+        handle_opcode_main[0x02] = &Cpu::ex_ld_byte_to_pair_mem<PairName::p_bc>;
+        handle_opcode_main[0x03] = &Cpu::ex_inc_pair<PairName::p_bc>;
+        handle_opcode_main[0x04] = &Cpu::ex_inc_byte<RegisterName::r_b>;
+        handle_opcode_main[0x05] = &Cpu::ex_dec_byte<RegisterName::r_b>;
+        handle_opcode_main[0x06] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_b>;
         handle_opcode_main[0x07] = &Cpu::ex_rlca;
         handle_opcode_main[0x08] = &Cpu::ex_ld_sp_to_mem;
-        handle_opcode_main[0x09] = &Cpu::ex_add_pair_to_hl;
-        handle_opcode_main[0x0a] = &Cpu::ex_ld_pair_mem_to_byte;
-        handle_opcode_main[0x0b] = &Cpu::ex_dec_pair;
-        handle_opcode_main[0x0c] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x0d] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x0e] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x09] = &Cpu::ex_add_pair_to_hl<PairName::p_bc>;
+        handle_opcode_main[0x0a] = &Cpu::ex_ld_pair_mem_to_byte<PairName::p_bc>;
+        handle_opcode_main[0x0b] = &Cpu::ex_dec_pair<PairName::p_bc>;
+        handle_opcode_main[0x0c] = &Cpu::ex_inc_byte<RegisterName::r_c>;
+        handle_opcode_main[0x0d] = &Cpu::ex_dec_byte<RegisterName::r_c>;
+        handle_opcode_main[0x0e] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_c>;
         handle_opcode_main[0x0f] = &Cpu::ex_rrca;
 
         handle_opcode_main[0x10] = &Cpu::ex_stop;
-        handle_opcode_main[0x11] = &Cpu::ex_ld_imm_to_pair;
-        handle_opcode_main[0x12] = &Cpu::ex_ld_byte_to_pair_mem;
-        handle_opcode_main[0x13] = &Cpu::ex_inc_pair;
-        handle_opcode_main[0x14] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x15] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x16] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x11] = &Cpu::ex_ld_imm_to_pair<PairName::p_de>;
+        handle_opcode_main[0x12] = &Cpu::ex_ld_byte_to_pair_mem<PairName::p_de>;
+        handle_opcode_main[0x13] = &Cpu::ex_inc_pair<PairName::p_de>;
+        handle_opcode_main[0x14] = &Cpu::ex_inc_byte<RegisterName::r_d>;
+        handle_opcode_main[0x15] = &Cpu::ex_dec_byte<RegisterName::r_d>;
+        handle_opcode_main[0x16] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_d>;
         handle_opcode_main[0x17] = &Cpu::ex_rla;
         handle_opcode_main[0x18] = &Cpu::ex_jr;
-        handle_opcode_main[0x19] = &Cpu::ex_add_pair_to_hl;
-        handle_opcode_main[0x1a] = &Cpu::ex_ld_pair_mem_to_byte;
-        handle_opcode_main[0x1b] = &Cpu::ex_dec_pair;
-        handle_opcode_main[0x1c] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x1d] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x1e] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x19] = &Cpu::ex_add_pair_to_hl<PairName::p_de>;
+        handle_opcode_main[0x1a] = &Cpu::ex_ld_pair_mem_to_byte<PairName::p_de>;
+        handle_opcode_main[0x1b] = &Cpu::ex_dec_pair<PairName::p_de>;
+        handle_opcode_main[0x1c] = &Cpu::ex_inc_byte<RegisterName::r_e>;
+        handle_opcode_main[0x1d] = &Cpu::ex_dec_byte<RegisterName::r_e>;
+        handle_opcode_main[0x1e] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_e>;
         handle_opcode_main[0x1f] = &Cpu::ex_rra;
 
         handle_opcode_main[0x20] = &Cpu::ex_jr_nz;
-        handle_opcode_main[0x21] = &Cpu::ex_ld_imm_to_pair;
+        handle_opcode_main[0x21] = &Cpu::ex_ld_imm_to_pair<PairName::p_hl>;
         handle_opcode_main[0x22] = &Cpu::ex_ldi_byte_to_hl_mem;
-        handle_opcode_main[0x23] = &Cpu::ex_inc_pair;
-        handle_opcode_main[0x24] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x25] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x26] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x23] = &Cpu::ex_inc_pair<PairName::p_hl>;
+        handle_opcode_main[0x24] = &Cpu::ex_inc_byte<RegisterName::r_h>;
+        handle_opcode_main[0x25] = &Cpu::ex_dec_byte<RegisterName::r_h>;
+        handle_opcode_main[0x26] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_h>;
         handle_opcode_main[0x27] = &Cpu::ex_daa_byte;
         handle_opcode_main[0x28] = &Cpu::ex_jr_z;
-        handle_opcode_main[0x29] = &Cpu::ex_add_pair_to_hl;
+        handle_opcode_main[0x29] = &Cpu::ex_add_pair_to_hl<PairName::p_hl>;
         handle_opcode_main[0x2a] = &Cpu::ex_ldi_hl_mem_to_byte;
-        handle_opcode_main[0x2b] = &Cpu::ex_dec_pair;
-        handle_opcode_main[0x2c] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x2d] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x2e] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x2b] = &Cpu::ex_dec_pair<PairName::p_hl>;
+        handle_opcode_main[0x2c] = &Cpu::ex_inc_byte<RegisterName::r_l>;
+        handle_opcode_main[0x2d] = &Cpu::ex_dec_byte<RegisterName::r_l>;
+        handle_opcode_main[0x2e] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_l>;
         handle_opcode_main[0x2f] = &Cpu::ex_cpl_byte;
 
         handle_opcode_main[0x30] = &Cpu::ex_jr_nc;
@@ -700,153 +196,153 @@ class Cpu
         handle_opcode_main[0x39] = &Cpu::ex_add_sp_to_hl;
         handle_opcode_main[0x3a] = &Cpu::ex_ldd_hl_mem_to_byte;
         handle_opcode_main[0x3b] = &Cpu::ex_dec_sp;
-        handle_opcode_main[0x3c] = &Cpu::ex_inc_byte;
-        handle_opcode_main[0x3d] = &Cpu::ex_dec_byte;
-        handle_opcode_main[0x3e] = &Cpu::ex_ld_imm_to_byte;
+        handle_opcode_main[0x3c] = &Cpu::ex_inc_byte<RegisterName::r_a>;
+        handle_opcode_main[0x3d] = &Cpu::ex_dec_byte<RegisterName::r_a>;
+        handle_opcode_main[0x3e] = &Cpu::ex_ld_imm_to_byte<RegisterName::r_a>;
         handle_opcode_main[0x3f] = &Cpu::ex_ccf_byte;
 
-        handle_opcode_main[0x40] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x41] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x42] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x43] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x44] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x45] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x46] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x47] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x48] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x49] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x4a] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x4b] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x4c] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x4d] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x4e] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x4f] = &Cpu::ex_ld_byte;
-
-        handle_opcode_main[0x50] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x51] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x52] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x53] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x54] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x55] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x56] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x57] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x58] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x59] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x5a] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x5b] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x5c] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x5d] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x5e] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x5f] = &Cpu::ex_ld_byte;
-
-        handle_opcode_main[0x60] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x61] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x62] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x63] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x64] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x65] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x66] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x67] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x68] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x69] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x6a] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x6b] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x6c] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x6d] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x6e] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x6f] = &Cpu::ex_ld_byte;
-
-        handle_opcode_main[0x70] = &Cpu::ex_ld_byte_to_hl_mem;
-        handle_opcode_main[0x71] = &Cpu::ex_ld_byte_to_hl_mem;
-        handle_opcode_main[0x72] = &Cpu::ex_ld_byte_to_hl_mem;
-        handle_opcode_main[0x73] = &Cpu::ex_ld_byte_to_hl_mem;
-        handle_opcode_main[0x74] = &Cpu::ex_ld_byte_to_hl_mem;
-        handle_opcode_main[0x75] = &Cpu::ex_ld_byte_to_hl_mem;
+        handle_opcode_main[0x40] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_b>;
+        handle_opcode_main[0x41] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_c>;
+        handle_opcode_main[0x42] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_d>;
+        handle_opcode_main[0x43] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_e>;
+        handle_opcode_main[0x44] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_h>;
+        handle_opcode_main[0x45] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_l>;
+        handle_opcode_main[0x46] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_b>;
+        handle_opcode_main[0x47] = &Cpu::ex_ld_byte<RegisterName::r_b, RegisterName::r_a>;
+        handle_opcode_main[0x48] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_b>;
+        handle_opcode_main[0x49] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_c>;
+        handle_opcode_main[0x4a] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_d>;
+        handle_opcode_main[0x4b] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_e>;
+        handle_opcode_main[0x4c] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_h>;
+        handle_opcode_main[0x4d] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_l>;
+        handle_opcode_main[0x4e] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_c>;
+        handle_opcode_main[0x4f] = &Cpu::ex_ld_byte<RegisterName::r_c, RegisterName::r_a>;
+
+        handle_opcode_main[0x50] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_b>;
+        handle_opcode_main[0x51] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_c>;
+        handle_opcode_main[0x52] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_d>;
+        handle_opcode_main[0x53] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_e>;
+        handle_opcode_main[0x54] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_h>;
+        handle_opcode_main[0x55] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_l>;
+        handle_opcode_main[0x56] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_d>;
+        handle_opcode_main[0x57] = &Cpu::ex_ld_byte<RegisterName::r_d, RegisterName::r_a>;
+        handle_opcode_main[0x58] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_b>;
+        handle_opcode_main[0x59] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_c>;
+        handle_opcode_main[0x5a] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_d>;
+        handle_opcode_main[0x5b] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_e>;
+        handle_opcode_main[0x5c] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_h>;
+        handle_opcode_main[0x5d] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_l>;
+        handle_opcode_main[0x5e] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_e>;
+        handle_opcode_main[0x5f] = &Cpu::ex_ld_byte<RegisterName::r_e, RegisterName::r_a>;
+
+        handle_opcode_main[0x60] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_b>;
+        handle_opcode_main[0x61] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_c>;
+        handle_opcode_main[0x62] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_d>;
+        handle_opcode_main[0x63] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_e>;
+        handle_opcode_main[0x64] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_h>;
+        handle_opcode_main[0x65] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_l>;
+        handle_opcode_main[0x66] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_h>;
+        handle_opcode_main[0x67] = &Cpu::ex_ld_byte<RegisterName::r_h, RegisterName::r_a>;
+        handle_opcode_main[0x68] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_b>;
+        handle_opcode_main[0x69] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_c>;
+        handle_opcode_main[0x6a] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_d>;
+        handle_opcode_main[0x6b] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_e>;
+        handle_opcode_main[0x6c] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_h>;
+        handle_opcode_main[0x6d] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_l>;
+        handle_opcode_main[0x6e] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_l>;
+        handle_opcode_main[0x6f] = &Cpu::ex_ld_byte<RegisterName::r_l, RegisterName::r_a>;
+
+        handle_opcode_main[0x70] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_b>;
+        handle_opcode_main[0x71] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_c>;
+        handle_opcode_main[0x72] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_d>;
+        handle_opcode_main[0x73] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_e>;
+        handle_opcode_main[0x74] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_h>;
+        handle_opcode_main[0x75] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_l>;
         handle_opcode_main[0x76] = &Cpu::ex_halt;
-        handle_opcode_main[0x77] = &Cpu::ex_ld_byte_to_hl_mem;
-        handle_opcode_main[0x78] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x79] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x7a] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x7b] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x7c] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x7d] = &Cpu::ex_ld_byte;
-        handle_opcode_main[0x7e] = &Cpu::ex_ld_hl_mem_to_byte;
-        handle_opcode_main[0x7f] = &Cpu::ex_ld_byte;
-
-        handle_opcode_main[0x80] = &Cpu::ex_add_byte;
-        handle_opcode_main[0x81] = &Cpu::ex_add_byte;
-        handle_opcode_main[0x82] = &Cpu::ex_add_byte;
-        handle_opcode_main[0x83] = &Cpu::ex_add_byte;
-        handle_opcode_main[0x84] = &Cpu::ex_add_byte;
-        handle_opcode_main[0x85] = &Cpu::ex_add_byte;
+        handle_opcode_main[0x77] = &Cpu::ex_ld_byte_to_hl_mem<RegisterName::r_a>;
+        handle_opcode_main[0x78] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_b>;
+        handle_opcode_main[0x79] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_c>;
+        handle_opcode_main[0x7a] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_d>;
+        handle_opcode_main[0x7b] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_e>;
+        handle_opcode_main[0x7c] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_h>;
+        handle_opcode_main[0x7d] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_l>;
+        handle_opcode_main[0x7e] = &Cpu::ex_ld_hl_mem_to_byte<RegisterName::r_a>;
+        handle_opcode_main[0x7f] = &Cpu::ex_ld_byte<RegisterName::r_a, RegisterName::r_a>;
+
+        handle_opcode_main[0x80] = &Cpu::ex_add_byte<RegisterName::r_b>;
+        handle_opcode_main[0x81] = &Cpu::ex_add_byte<RegisterName::r_c>;
+        handle_opcode_main[0x82] = &Cpu::ex_add_byte<RegisterName::r_d>;
+        handle_opcode_main[0x83] = &Cpu::ex_add_byte<RegisterName::r_e>;
+        handle_opcode_main[0x84] = &Cpu::ex_add_byte<RegisterName::r_h>;
+        handle_opcode_main[0x85] = &Cpu::ex_add_byte<RegisterName::r_l>;
         handle_opcode_main[0x86] = &Cpu::ex_add_hl_mem;
-        handle_opcode_main[0x87] = &Cpu::ex_add_byte;
-        handle_opcode_main[0x88] = &Cpu::ex_adc_byte;
-        handle_opcode_main[0x89] = &Cpu::ex_adc_byte;
-        handle_opcode_main[0x8a] = &Cpu::ex_adc_byte;
-        handle_opcode_main[0x8b] = &Cpu::ex_adc_byte;
-        handle_opcode_main[0x8c] = &Cpu::ex_adc_byte;
-        handle_opcode_main[0x8d] = &Cpu::ex_adc_byte;
+        handle_opcode_main[0x87] = &Cpu::ex_add_byte<RegisterName::r_a>;
+        handle_opcode_main[0x88] = &Cpu::ex_adc_byte<RegisterName::r_b>;
+        handle_opcode_main[0x89] = &Cpu::ex_adc_byte<RegisterName::r_c>;
+        handle_opcode_main[0x8a] = &Cpu::ex_adc_byte<RegisterName::r_d>;
+        handle_opcode_main[0x8b] = &Cpu::ex_adc_byte<RegisterName::r_e>;
+        handle_opcode_main[0x8c] = &Cpu::ex_adc_byte<RegisterName::r_h>;
+        handle_opcode_main[0x8d] = &Cpu::ex_adc_byte<RegisterName::r_l>;
         handle_opcode_main[0x8e] = &Cpu::ex_adc_hl_mem;
-        handle_opcode_main[0x8f] = &Cpu::ex_adc_byte;
-
-        handle_opcode_main[0x90] = &Cpu::ex_sub_byte;
-        handle_opcode_main[0x91] = &Cpu::ex_sub_byte;
-        handle_opcode_main[0x92] = &Cpu::ex_sub_byte;
-        handle_opcode_main[0x93] = &Cpu::ex_sub_byte;
-        handle_opcode_main[0x94] = &Cpu::ex_sub_byte;
-        handle_opcode_main[0x95] = &Cpu::ex_sub_byte;
+        handle_opcode_main[0x8f] = &Cpu::ex_adc_byte<RegisterName::r_a>;
+
+        handle_opcode_main[0x90] = &Cpu::ex_sub_byte<RegisterName::r_b>;
+        handle_opcode_main[0x91] = &Cpu::ex_sub_byte<RegisterName::r_c>;
+        handle_opcode_main[0x92] = &Cpu::ex_sub_byte<RegisterName::r_d>;
+        handle_opcode_main[0x93] = &Cpu::ex_sub_byte<RegisterName::r_e>;
+        handle_opcode_main[0x94] = &Cpu::ex_sub_byte<RegisterName::r_h>;
+        handle_opcode_main[0x95] = &Cpu::ex_sub_byte<RegisterName::r_l>;
         handle_opcode_main[0x96] = &Cpu::ex_sub_hl_mem;
-        handle_opcode_main[0x97] = &Cpu::ex_sub_byte;
-        handle_opcode_main[0x98] = &Cpu::ex_sbc_byte;
-        handle_opcode_main[0x99] = &Cpu::ex_sbc_byte;
-        handle_opcode_main[0x9a] = &Cpu::ex_sbc_byte;
-        handle_opcode_main[0x9b] = &Cpu::ex_sbc_byte;
-        handle_opcode_main[0x9c] = &Cpu::ex_sbc_byte;
-        handle_opcode_main[0x9d] = &Cpu::ex_sbc_byte;
+        handle_opcode_main[0x97] = &Cpu::ex_sub_byte<RegisterName::r_a>;
+        handle_opcode_main[0x98] = &Cpu::ex_sbc_byte<RegisterName::r_b>;
+        handle_opcode_main[0x99] = &Cpu::ex_sbc_byte<RegisterName::r_c>;
+        handle_opcode_main[0x9a] = &Cpu::ex_sbc_byte<RegisterName::r_d>;
+        handle_opcode_main[0x9b] = &Cpu::ex_sbc_byte<RegisterName::r_e>;
+        handle_opcode_main[0x9c] = &Cpu::ex_sbc_byte<RegisterName::r_h>;
+        handle_opcode_main[0x9d] = &Cpu::ex_sbc_byte<RegisterName::r_l>;
         handle_opcode_main[0x9e] = &Cpu::ex_sbc_hl_mem;
-        handle_opcode_main[0x9f] = &Cpu::ex_sbc_byte;
-
-        handle_opcode_main[0xa0] = &Cpu::ex_and_byte;
-        handle_opcode_main[0xa1] = &Cpu::ex_and_byte;
-        handle_opcode_main[0xa2] = &Cpu::ex_and_byte;
-        handle_opcode_main[0xa3] = &Cpu::ex_and_byte;
-        handle_opcode_main[0xa4] = &Cpu::ex_and_byte;
-        handle_opcode_main[0xa5] = &Cpu::ex_and_byte;
+        handle_opcode_main[0x9f] = &Cpu::ex_sbc_byte<RegisterName::r_a>;
+
+        handle_opcode_main[0xa0] = &Cpu::ex_and_byte<RegisterName::r_b>;
+        handle_opcode_main[0xa1] = &Cpu::ex_and_byte<RegisterName::r_c>;
+        handle_opcode_main[0xa2] = &Cpu::ex_and_byte<RegisterName::r_d>;
+        handle_opcode_main[0xa3] = &Cpu::ex_and_byte<RegisterName::r_e>;
+        handle_opcode_main[0xa4] = &Cpu::ex_and_byte<RegisterName::r_h>;
+        handle_opcode_main[0xa5] = &Cpu::ex_and_byte<RegisterName::r_l>;
         handle_opcode_main[0xa6] = &Cpu::ex_and_hl_mem;
-        handle_opcode_main[0xa7] = &Cpu::ex_and_byte;
-        handle_opcode_main[0xa8] = &Cpu::ex_xor_byte;
-        handle_opcode_main[0xa9] = &Cpu::ex_xor_byte;
-        handle_opcode_main[0xaa] = &Cpu::ex_xor_byte;
-        handle_opcode_main[0xab] = &Cpu::ex_xor_byte;
-        handle_opcode_main[0xac] = &Cpu::ex_xor_byte;
-        handle_opcode_main[0xad] = &Cpu::ex_xor_byte;
+        handle_opcode_main[0xa7] = &Cpu::ex_and_byte<RegisterName::r_a>;
+        handle_opcode_main[0xa8] = &Cpu::ex_xor_byte<RegisterName::r_b>;
+        handle_opcode_main[0xa9] = &Cpu::ex_xor_byte<RegisterName::r_c>;
+        handle_opcode_main[0xaa] = &Cpu::ex_xor_byte<RegisterName::r_d>;
+        handle_opcode_main[0xab] = &Cpu::ex_xor_byte<RegisterName::r_e>;
+        handle_opcode_main[0xac] = &Cpu::ex_xor_byte<RegisterName::r_h>;
+        handle_opcode_main[0xad] = &Cpu::ex_xor_byte<RegisterName::r_l>;
         handle_opcode_main[0xae] = &Cpu::ex_xor_hl_mem;
-        handle_opcode_main[0xaf] = &Cpu::ex_xor_byte;
-
-        handle_opcode_main[0xb0] = &Cpu::ex_or_byte;
-        handle_opcode_main[0xb1] = &Cpu::ex_or_byte;
-        handle_opcode_main[0xb2] = &Cpu::ex_or_byte;
-        handle_opcode_main[0xb3] = &Cpu::ex_or_byte;
-        handle_opcode_main[0xb4] = &Cpu::ex_or_byte;
-        handle_opcode_main[0xb5] = &Cpu::ex_or_byte;
+        handle_opcode_main[0xaf] = &Cpu::ex_xor_byte<RegisterName::r_a>;
+
+        handle_opcode_main[0xb0] = &Cpu::ex_or_byte<RegisterName::r_b>;
+        handle_opcode_main[0xb1] = &Cpu::ex_or_byte<RegisterName::r_c>;
+        handle_opcode_main[0xb2] = &Cpu::ex_or_byte<RegisterName::r_d>;
+        handle_opcode_main[0xb3] = &Cpu::ex_or_byte<RegisterName::r_e>;
+        handle_opcode_main[0xb4] = &Cpu::ex_or_byte<RegisterName::r_h>;
+        handle_opcode_main[0xb5] = &Cpu::ex_or_byte<RegisterName::r_l>;
         handle_opcode_main[0xb6] = &Cpu::ex_or_hl_mem;
-        handle_opcode_main[0xb7] = &Cpu::ex_or_byte;
-        handle_opcode_main[0xb8] = &Cpu::ex_cp_byte;
-        handle_opcode_main[0xb9] = &Cpu::ex_cp_byte;
-        handle_opcode_main[0xba] = &Cpu::ex_cp_byte;
-        handle_opcode_main[0xbb] = &Cpu::ex_cp_byte;
-        handle_opcode_main[0xbc] = &Cpu::ex_cp_byte;
-        handle_opcode_main[0xbd] = &Cpu::ex_cp_byte;
+        handle_opcode_main[0xb7] = &Cpu::ex_or_byte<RegisterName::r_a>;
+        handle_opcode_main[0xb8] = &Cpu::ex_cp_byte<RegisterName::r_b>;
+        handle_opcode_main[0xb9] = &Cpu::ex_cp_byte<RegisterName::r_c>;
+        handle_opcode_main[0xba] = &Cpu::ex_cp_byte<RegisterName::r_d>;
+        handle_opcode_main[0xbb] = &Cpu::ex_cp_byte<RegisterName::r_e>;
+        handle_opcode_main[0xbc] = &Cpu::ex_cp_byte<RegisterName::r_h>;
+        handle_opcode_main[0xbd] = &Cpu::ex_cp_byte<RegisterName::r_l>;
         handle_opcode_main[0xbe] = &Cpu::ex_cp_hl_mem;
-        handle_opcode_main[0xbf] = &Cpu::ex_cp_byte;
+        handle_opcode_main[0xbf] = &Cpu::ex_cp_byte<RegisterName::r_a>;
 
         handle_opcode_main[0xc0] = &Cpu::ex_ret_nz;
-        handle_opcode_main[0xc1] = &Cpu::ex_pop_pair;
+        handle_opcode_main[0xc1] = &Cpu::ex_pop_pair<PairName::p_bc>;
         handle_opcode_main[0xc2] = &Cpu::ex_jp_nz;
         handle_opcode_main[0xc3] = &Cpu::ex_jp;
         handle_opcode_main[0xc4] = &Cpu::ex_call_nz;
-        handle_opcode_main[0xc5] = &Cpu::ex_push_pair;
+        handle_opcode_main[0xc5] = &Cpu::ex_push_pair<PairName::p_bc>;
         handle_opcode_main[0xc6] = &Cpu::ex_add_imm;
         handle_opcode_main[0xc7] = &Cpu::ex_rst_00;
         handle_opcode_main[0xc8] = &Cpu::ex_ret_z;
@@ -859,11 +355,11 @@ class Cpu
         handle_opcode_main[0xcf] = &Cpu::ex_rst_08;
 
         handle_opcode_main[0xd0] = &Cpu::ex_ret_nc;
-        handle_opcode_main[0xd1] = &Cpu::ex_pop_pair;
+        handle_opcode_main[0xd1] = &Cpu::ex_pop_pair<PairName::p_de>;
         handle_opcode_main[0xd2] = &Cpu::ex_jp_nc;
         handle_opcode_main[0xd3] = nullptr;
         handle_opcode_main[0xd4] = &Cpu::ex_call_nc;
-        handle_opcode_main[0xd5] = &Cpu::ex_push_pair;
+        handle_opcode_main[0xd5] = &Cpu::ex_push_pair<PairName::p_de>;
         handle_opcode_main[0xd6] = &Cpu::ex_sub_imm;
         handle_opcode_main[0xd7] = &Cpu::ex_rst_10;
         handle_opcode_main[0xd8] = &Cpu::ex_ret_c;
@@ -876,11 +372,11 @@ class Cpu
         handle_opcode_main[0xdf] = &Cpu::ex_rst_18;
 
         handle_opcode_main[0xe0] = &Cpu::ex_ldh_byte_to_n_zp;
-        handle_opcode_main[0xe1] = &Cpu::ex_pop_pair;
+        handle_opcode_main[0xe1] = &Cpu::ex_pop_pair<PairName::p_hl>;
         handle_opcode_main[0xe2] = &Cpu::ex_ld_byte_to_c_zp;
         handle_opcode_main[0xe3] = nullptr;
         handle_opcode_main[0xe4] = nullptr;
-        handle_opcode_main[0xe5] = &Cpu::ex_push_pair;
+        handle_opcode_main[0xe5] = &Cpu::ex_push_pair<PairName::p_hl>;
         handle_opcode_main[0xe6] = &Cpu::ex_and_imm;
         handle_opcode_main[0xe7] = &Cpu::ex_rst_20;
         handle_opcode_main[0xe8] = &Cpu::ex_add_r8_to_sp;
@@ -897,7 +393,7 @@ class Cpu
         handle_opcode_main[0xf2] = &Cpu::ex_ld_c_zp_to_byte;
         handle_opcode_main[0xf3] = &Cpu::ex_di;
         handle_opcode_main[0xf4] = nullptr;
-        handle_opcode_main[0xf5] = &Cpu::ex_push_pair;
+        handle_opcode_main[0xf5] = &Cpu::ex_push_pair<PairName::p_af>;
         handle_opcode_main[0xf6] = &Cpu::ex_or_imm;
         handle_opcode_main[0xf7] = &Cpu::ex_rst_30;
         handle_opcode_main[0xf8] = &Cpu::ex_ld_sp_r8_to_hl;
@@ -910,277 +406,277 @@ class Cpu
         handle_opcode_main[0xff] = &Cpu::ex_rst_38;
 
         // Prefix CB
-        handle_opcode_prefix_cb[0x00] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x01] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x02] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x03] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x04] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x05] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x06] = &Cpu::ex_rlc_hl_mem;
-        handle_opcode_prefix_cb[0x07] = &Cpu::ex_rlc_byte;
-        handle_opcode_prefix_cb[0x08] = &Cpu::ex_rrc_byte;
-        handle_opcode_prefix_cb[0x09] = &Cpu::ex_rrc_byte;
-        handle_opcode_prefix_cb[0x0a] = &Cpu::ex_rrc_byte;
-        handle_opcode_prefix_cb[0x0b] = &Cpu::ex_rrc_byte;
-        handle_opcode_prefix_cb[0x0c] = &Cpu::ex_rrc_byte;
-        handle_opcode_prefix_cb[0x0d] = &Cpu::ex_rrc_byte;
-        handle_opcode_prefix_cb[0x0e] = &Cpu::ex_rrc_hl_mem;
-        handle_opcode_prefix_cb[0x0f] = &Cpu::ex_rrc_byte;
-
-        handle_opcode_prefix_cb[0x10] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x11] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x12] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x13] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x14] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x15] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x16] = &Cpu::ex_rl_hl_mem;
-        handle_opcode_prefix_cb[0x17] = &Cpu::ex_rl_byte;
-        handle_opcode_prefix_cb[0x18] = &Cpu::ex_rr_byte;
-        handle_opcode_prefix_cb[0x19] = &Cpu::ex_rr_byte;
-        handle_opcode_prefix_cb[0x1a] = &Cpu::ex_rr_byte;
-        handle_opcode_prefix_cb[0x1b] = &Cpu::ex_rr_byte;
-        handle_opcode_prefix_cb[0x1c] = &Cpu::ex_rr_byte;
-        handle_opcode_prefix_cb[0x1d] = &Cpu::ex_rr_byte;
-        handle_opcode_prefix_cb[0x1e] = &Cpu::ex_rr_hl_mem;
-        handle_opcode_prefix_cb[0x1f] = &Cpu::ex_rr_byte;
-
-        handle_opcode_prefix_cb[0x20] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x21] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x22] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x23] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x24] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x25] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x26] = &Cpu::ex_sla_hl_mem;
-        handle_opcode_prefix_cb[0x27] = &Cpu::ex_sla_byte;
-        handle_opcode_prefix_cb[0x28] = &Cpu::ex_sra_byte;
-        handle_opcode_prefix_cb[0x29] = &Cpu::ex_sra_byte;
-        handle_opcode_prefix_cb[0x2a] = &Cpu::ex_sra_byte;
-        handle_opcode_prefix_cb[0x2b] = &Cpu::ex_sra_byte;
-        handle_opcode_prefix_cb[0x2c] = &Cpu::ex_sra_byte;
-        handle_opcode_prefix_cb[0x2d] = &Cpu::ex_sra_byte;
-        handle_opcode_prefix_cb[0x2e] = &Cpu::ex_sra_hl_mem;
-        handle_opcode_prefix_cb[0x2f] = &Cpu::ex_sra_byte;
-
-        handle_opcode_prefix_cb[0x30] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x31] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x32] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x33] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x34] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x35] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x36] = &Cpu::ex_swap_hl_mem;
-        handle_opcode_prefix_cb[0x37] = &Cpu::ex_swap_byte;
-        handle_opcode_prefix_cb[0x38] = &Cpu::ex_srl_byte;
-        handle_opcode_prefix_cb[0x39] = &Cpu::ex_srl_byte;
-        handle_opcode_prefix_cb[0x3a] = &Cpu::ex_srl_byte;
-        handle_opcode_prefix_cb[0x3b] = &Cpu::ex_srl_byte;
-        handle_opcode_prefix_cb[0x3c] = &Cpu::ex_srl_byte;
-        handle_opcode_prefix_cb[0x3d] = &Cpu::ex_srl_byte;
-        handle_opcode_prefix_cb[0x3e] = &Cpu::ex_srl_hl_mem;
-        handle_opcode_prefix_cb[0x3f] = &Cpu::ex_srl_byte;
+        handle_opcode_prefix_cb[0x00] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x01] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x02] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x03] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x04] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x05] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x06] = &Cpu::ex_cb_hl_mem<CbOperation::cb_rlc, 0>;
+        handle_opcode_prefix_cb[0x07] = &Cpu::ex_cb_byte<CbOperation::cb_rlc, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x08] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x09] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x0a] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x0b] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x0c] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x0d] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x0e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_rrc, 0>;
+        handle_opcode_prefix_cb[0x0f] = &Cpu::ex_cb_byte<CbOperation::cb_rrc, 0, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x10] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x11] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x12] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x13] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x14] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x15] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x16] = &Cpu::ex_cb_hl_mem<CbOperation::cb_rl, 0>;
+        handle_opcode_prefix_cb[0x17] = &Cpu::ex_cb_byte<CbOperation::cb_rl, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x18] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x19] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x1a] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x1b] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x1c] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x1d] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x1e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_rr, 0>;
+        handle_opcode_prefix_cb[0x1f] = &Cpu::ex_cb_byte<CbOperation::cb_rr, 0, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x20] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x21] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x22] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x23] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x24] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x25] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x26] = &Cpu::ex_cb_hl_mem<CbOperation::cb_sla, 0>;
+        handle_opcode_prefix_cb[0x27] = &Cpu::ex_cb_byte<CbOperation::cb_sla, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x28] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x29] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x2a] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x2b] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x2c] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x2d] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x2e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_sra, 0>;
+        handle_opcode_prefix_cb[0x2f] = &Cpu::ex_cb_byte<CbOperation::cb_sra, 0, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x30] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x31] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x32] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x33] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x34] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x35] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x36] = &Cpu::ex_cb_hl_mem<CbOperation::cb_swap, 0>;
+        handle_opcode_prefix_cb[0x37] = &Cpu::ex_cb_byte<CbOperation::cb_swap, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x38] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x39] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x3a] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x3b] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x3c] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x3d] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x3e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_srl, 0>;
+        handle_opcode_prefix_cb[0x3f] = &Cpu::ex_cb_byte<CbOperation::cb_srl, 0, RegisterName::r_a>;
         
-        handle_opcode_prefix_cb[0x40] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x41] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x42] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x43] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x44] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x45] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x46] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x47] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x48] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x49] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x4a] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x4b] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x4c] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x4d] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x4e] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x4f] = &Cpu::ex_bit_byte;
-
-        handle_opcode_prefix_cb[0x50] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x51] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x52] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x53] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x54] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x55] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x56] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x57] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x58] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x59] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x5a] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x5b] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x5c] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x5d] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x5e] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x5f] = &Cpu::ex_bit_byte;
-
-        handle_opcode_prefix_cb[0x60] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x61] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x62] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x63] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x64] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x65] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x66] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x67] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x68] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x69] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x6a] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x6b] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x6c] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x6d] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x6e] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x6f] = &Cpu::ex_bit_byte;
-
-        handle_opcode_prefix_cb[0x70] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x71] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x72] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x73] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x74] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x75] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x76] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x77] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x78] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x79] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x7a] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x7b] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x7c] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x7d] = &Cpu::ex_bit_byte;
-        handle_opcode_prefix_cb[0x7e] = &Cpu::ex_bit_hl_mem;
-        handle_opcode_prefix_cb[0x7f] = &Cpu::ex_bit_byte;
-
-        handle_opcode_prefix_cb[0x80] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x81] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x82] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x83] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x84] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x85] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x86] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0x87] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x88] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x89] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x8a] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x8b] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x8c] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x8d] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x8e] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0x8f] = &Cpu::ex_res_byte;
-
-        handle_opcode_prefix_cb[0x90] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x91] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x92] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x93] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x94] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x95] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x96] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0x97] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x98] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x99] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x9a] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x9b] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x9c] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x9d] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0x9e] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0x9f] = &Cpu::ex_res_byte;
-
-        handle_opcode_prefix_cb[0xa0] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa1] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa2] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa3] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa4] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa5] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa6] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0xa7] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa8] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xa9] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xaa] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xab] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xac] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xad] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xae] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0xaf] = &Cpu::ex_res_byte;
-
-        handle_opcode_prefix_cb[0xb0] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb1] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb2] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb3] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb4] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb5] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb6] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0xb7] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb8] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xb9] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xba] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xbb] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xbc] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xbd] = &Cpu::ex_res_byte;
-        handle_opcode_prefix_cb[0xbe] = &Cpu::ex_res_hl_mem;
-        handle_opcode_prefix_cb[0xbf] = &Cpu::ex_res_byte;
-
-        handle_opcode_prefix_cb[0xc0] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc1] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc2] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc3] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc4] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc5] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc6] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xc7] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc8] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xc9] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xca] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xcb] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xcc] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xcd] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xce] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xcf] = &Cpu::ex_set_byte;
-
-        handle_opcode_prefix_cb[0xd0] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd1] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd2] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd3] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd4] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd5] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd6] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xd7] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd8] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xd9] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xda] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xdb] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xdc] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xdd] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xde] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xdf] = &Cpu::ex_set_byte;
-
-        handle_opcode_prefix_cb[0xe0] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe1] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe2] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe3] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe4] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe5] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe6] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xe7] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe8] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xe9] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xea] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xeb] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xec] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xed] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xee] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xef] = &Cpu::ex_set_byte;
-
-        handle_opcode_prefix_cb[0xf0] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf1] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf2] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf3] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf4] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf5] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf6] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xf7] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf8] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xf9] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xfa] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xfb] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xfc] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xfd] = &Cpu::ex_set_byte;
-        handle_opcode_prefix_cb[0xfe] = &Cpu::ex_set_hl_mem;
-        handle_opcode_prefix_cb[0xff] = &Cpu::ex_set_byte;
+        handle_opcode_prefix_cb[0x40] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x41] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x42] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x43] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x44] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x45] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x46] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 0>;
+        handle_opcode_prefix_cb[0x47] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x48] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x49] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x4a] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x4b] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x4c] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x4d] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x4e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 1>;
+        handle_opcode_prefix_cb[0x4f] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 1, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x50] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x51] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x52] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x53] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x54] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x55] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x56] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 2>;
+        handle_opcode_prefix_cb[0x57] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 2, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x58] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x59] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x5a] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x5b] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x5c] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x5d] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x5e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 3>;
+        handle_opcode_prefix_cb[0x5f] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 3, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x60] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x61] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x62] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x63] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x64] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x65] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x66] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 4>;
+        handle_opcode_prefix_cb[0x67] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 4, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x68] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x69] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x6a] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x6b] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x6c] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x6d] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x6e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 5>;
+        handle_opcode_prefix_cb[0x6f] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 5, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x70] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x71] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x72] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x73] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x74] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x75] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x76] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 6>;
+        handle_opcode_prefix_cb[0x77] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 6, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x78] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x79] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x7a] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x7b] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x7c] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x7d] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x7e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_bit, 7>;
+        handle_opcode_prefix_cb[0x7f] = &Cpu::ex_cb_byte<CbOperation::cb_bit, 7, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x80] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x81] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x82] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x83] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x84] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x85] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x86] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 0>;
+        handle_opcode_prefix_cb[0x87] = &Cpu::ex_cb_byte<CbOperation::cb_res, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x88] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x89] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x8a] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x8b] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x8c] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x8d] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x8e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 1>;
+        handle_opcode_prefix_cb[0x8f] = &Cpu::ex_cb_byte<CbOperation::cb_res, 1, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0x90] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x91] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x92] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x93] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x94] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x95] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x96] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 2>;
+        handle_opcode_prefix_cb[0x97] = &Cpu::ex_cb_byte<CbOperation::cb_res, 2, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0x98] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0x99] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0x9a] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0x9b] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0x9c] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0x9d] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0x9e] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 3>;
+        handle_opcode_prefix_cb[0x9f] = &Cpu::ex_cb_byte<CbOperation::cb_res, 3, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0xa0] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xa1] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xa2] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xa3] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xa4] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xa5] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xa6] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 4>;
+        handle_opcode_prefix_cb[0xa7] = &Cpu::ex_cb_byte<CbOperation::cb_res, 4, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0xa8] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xa9] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xaa] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xab] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xac] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xad] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xae] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 5>;
+        handle_opcode_prefix_cb[0xaf] = &Cpu::ex_cb_byte<CbOperation::cb_res, 5, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0xb0] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xb1] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xb2] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xb3] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xb4] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xb5] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xb6] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 6>;
+        handle_opcode_prefix_cb[0xb7] = &Cpu::ex_cb_byte<CbOperation::cb_res, 6, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0xb8] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xb9] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xba] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xbb] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xbc] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xbd] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xbe] = &Cpu::ex_cb_hl_mem<CbOperation::cb_res, 7>;
+        handle_opcode_prefix_cb[0xbf] = &Cpu::ex_cb_byte<CbOperation::cb_res, 7, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0xc0] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xc1] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xc2] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xc3] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xc4] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xc5] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xc6] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 0>;
+        handle_opcode_prefix_cb[0xc7] = &Cpu::ex_cb_byte<CbOperation::cb_set, 0, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0xc8] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xc9] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xca] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xcb] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xcc] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xcd] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xce] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 1>;
+        handle_opcode_prefix_cb[0xcf] = &Cpu::ex_cb_byte<CbOperation::cb_set, 1, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0xd0] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xd1] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xd2] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xd3] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xd4] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xd5] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xd6] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 2>;
+        handle_opcode_prefix_cb[0xd7] = &Cpu::ex_cb_byte<CbOperation::cb_set, 2, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0xd8] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xd9] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xda] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xdb] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xdc] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xdd] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xde] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 3>;
+        handle_opcode_prefix_cb[0xdf] = &Cpu::ex_cb_byte<CbOperation::cb_set, 3, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0xe0] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xe1] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xe2] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xe3] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xe4] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xe5] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xe6] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 4>;
+        handle_opcode_prefix_cb[0xe7] = &Cpu::ex_cb_byte<CbOperation::cb_set, 4, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0xe8] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xe9] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xea] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xeb] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xec] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xed] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xee] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 5>;
+        handle_opcode_prefix_cb[0xef] = &Cpu::ex_cb_byte<CbOperation::cb_set, 5, RegisterName::r_a>;
+
+        handle_opcode_prefix_cb[0xf0] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xf1] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xf2] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xf3] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xf4] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xf5] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xf6] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 6>;
+        handle_opcode_prefix_cb[0xf7] = &Cpu::ex_cb_byte<CbOperation::cb_set, 6, RegisterName::r_a>;
+        handle_opcode_prefix_cb[0xf8] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_b>;
+        handle_opcode_prefix_cb[0xf9] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_c>;
+        handle_opcode_prefix_cb[0xfa] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_d>;
+        handle_opcode_prefix_cb[0xfb] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_e>;
+        handle_opcode_prefix_cb[0xfc] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_h>;
+        handle_opcode_prefix_cb[0xfd] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_l>;
+        handle_opcode_prefix_cb[0xfe] = &Cpu::ex_cb_hl_mem<CbOperation::cb_set, 7>;
+        handle_opcode_prefix_cb[0xff] = &Cpu::ex_cb_byte<CbOperation::cb_set, 7, RegisterName::r_a>;
     }
     // Initialize registers and flag status when power on
     Cpu &power_on();
@@ -1196,6 +692,92 @@ class Cpu
     // Return cycles in opcode_cycle_main or opcode_cycle_prefix_cb
     uint8_t execute(Memory &mem);
 
+    // Instructions executed since power on
+    uint64_t instruction_count = 0;
+
+    // Save states: A F B C D E H L SP PC, IME, HALT and the instruction count
+    // Decoded blocks stay, the ROM under them is the same
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
+    // Run until clock (in 4 MHz clocks) reaches deadline
+    // deadline is read again after every instruction,
+    // so an event scheduled by a memory write ends the run early
+    void run(Memory &mem, uint64_t &clock, const uint64_t &deadline);
+
+    // Portable core: dispatch through the function table (Cpu::next in a loop)
+    void run_table(Memory &mem, uint64_t &clock, const uint64_t &deadline);
+
+#ifdef GAMEBOY_THREADED_INTERPRETER
+    // Threaded core: src/cpu-threaded.cc
+    void run_threaded(Memory &mem, uint64_t &clock, const uint64_t &deadline);
+#endif
+
+#ifdef GAMEBOY_DYNAREC
+    // Dynarec core: run_table with hot blocks translated, src/dynarec.cc
+    void run_dynarec(Memory &mem, uint64_t &clock, const uint64_t &deadline);
+    Dynarec dynarec;
+#endif
+
+    // Basic blocks of ROM code, used by run_table and run_dynarec, see src/block-cache.h
+    BlockCache block_cache;
+    // Block at PC, decoded on the first visit
+    BasicBlock *get_block(Memory &mem)
+    {
+        uint16_t temp_r_pc_word = reg.register_word[RegisterName::r_pc];
+        BasicBlock *temp_block = block_cache.find(mem.get_mapped_rom_bank(temp_r_pc_word), temp_r_pc_word);
+        if (temp_block)
+        {
+            return temp_block;
+        }
+        return decode_block(mem, temp_r_pc_word);
+    }
+    // Decode the instructions from address to the end of the block into the cache
+    BasicBlock *decode_block(Memory &mem, uint16_t address);
+    // Run the instructions of a block, stop early on anything Cpu::next would
+    // handle between two instructions
+    void run_block(Memory &mem, const BasicBlock &block, uint64_t &clock, const uint64_t &deadline);
+
+    // Idle loop detection
+    // Games poll LY or a RAM flag in loops like LD A,(nn); CP n; JR NZ.
+    // If a short backward branch sees the same CPU state twice and memory
+    // was not written, every later iteration is the same until a scheduled
+    // event changes memory. Scheduled events only run between Cpu::run
+    // calls, so all whole iterations left before deadline can be skipped.
+    IdleLoopState idle_loop_state;
+    // set by a branch that found the saved state again, handled by the run loop
+    bool idle_loop_hit = false;
+    // one iteration measured in this run, from idle_loop_clock
+    bool idle_loop_armed = false;
+    uint64_t idle_loop_clock = 0;
+    uint64_t idle_loop_instruction = 0;
+    // Stats: skips and 4 MHz clocks skipped since power on
+    uint64_t idle_loop_skips = 0;
+    uint64_t idle_loop_skipped_clocks = 0;
+
+    // Called by taken JR / JP, from is the address after the branch
+    void branch_taken(Memory &mem, uint16_t from)
+    {
+        uint16_t temp_loop_bytes = from - reg.register_word[RegisterName::r_pc];
+        if (temp_loop_bytes != 0 && temp_loop_bytes <= IDLE_LOOP_MAX_BYTES)
+        {
+            check_idle_loop(mem);
+        }
+    }
+    // Compare the CPU state with the one saved at the last backward branch
+    void check_idle_loop(Memory &mem);
+    // Skip whole loop iterations up to deadline
+    void skip_idle_loop(uint64_t &clock, const uint64_t &deadline);
+
+    // HALT with no interrupt requested
+    // IF only changes in scheduled events, nothing wakes the CPU before deadline,
+    // so jump there at once instead of stepping one machine cycle (4 clocks) at a time
+    // clock stays a multiple of 4 clocks past where HALT started, like the steps it replaces
+    void skip_halt(uint64_t &clock, const uint64_t &deadline)
+    {
+        clock += (deadline - clock + 3) & ~static_cast<uint64_t>(3);
+    }
+
     // Read opcode
     uint8_t read_opcode_byte(Memory &mem);
     uint16_t read_opcode_word(Memory &mem);
@@ -1481,28 +1063,38 @@ class Cpu
     void ex_rra(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // 8-bit INC
+    template <RegisterName self>
     void ex_inc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit DEC
+    template <RegisterName self>
     void ex_dec_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit ADD
+    template <RegisterName from>
     void ex_add_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit ADC
+    template <RegisterName from>
     void ex_adc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit SUB
+    template <RegisterName from>
     void ex_sub_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit SBC
+    template <RegisterName from>
     void ex_sbc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit AND
+    template <RegisterName from>
     void ex_and_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit DAA
     void ex_daa_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit SCF
     void ex_scf_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit XOR
+    template <RegisterName from>
     void ex_xor_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit OR
+    template <RegisterName from>
     void ex_or_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit CP
+    template <RegisterName from>
     void ex_cp_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 8-bit CPL
     void ex_cpl_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
@@ -1549,6 +1141,7 @@ class Cpu
     void ex_cp_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // 16-bit paired registers to HL ADD 
+    template <PairName from>
     void ex_add_pair_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 16-bit SP to HL ADD 
     void ex_add_sp_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
@@ -1556,11 +1149,13 @@ class Cpu
     void ex_add_r8_to_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // 16-bit DEC (paired registers)
+    template <PairName self>
     void ex_dec_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 16-bit SP DEC
     void ex_dec_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // 16-bit INC (paired registers)
+    template <PairName self>
     void ex_inc_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 16-bit INC
     void ex_inc_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
@@ -1640,18 +1235,24 @@ class Cpu
     // LD
     // 8-bit LD
     // LD 8-bit register to 8-bit register
+    template <RegisterName to, RegisterName from>
     void ex_ld_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD 8-bit imm to 8-bit register
+    template <RegisterName to>
     void ex_ld_imm_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD 8-bit imm to (HL) in memory
     void ex_ld_imm_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD (BC or DE) in memory to A
+    template <PairName from>
     void ex_ld_pair_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD A to (BC or DE) in memory
+    template <PairName to>
     void ex_ld_byte_to_pair_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD 8-bit register to (HL) in memory
+    template <RegisterName from>
     void ex_ld_byte_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD (HL) in memory to 8-bit register
+    template <RegisterName to>
     void ex_ld_hl_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // LD (n) in memory to 8-bit A, n is 16-bit imm
@@ -1684,6 +1285,7 @@ class Cpu
 
     // 16-bit LD
     // LD 16-bit imm to 16-bit paired registers
+    template <PairName to>
     void ex_ld_imm_to_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // LD 16-bit imm to 16-bit SP
     void ex_ld_imm_to_sp(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
@@ -1695,61 +1297,275 @@ class Cpu
     void ex_ld_sp_r8_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // 16-bit PUSH
+    template <PairName self>
     void ex_push_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // 16-bit POP
+    template <PairName self>
     void ex_pop_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
     // POP AF
     void ex_pop_af(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 
     // Opcode Prefix CB
-    // 8-bit RLC
-    void ex_rlc_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit RRC
-    void ex_rrc_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit RL
-    void ex_rl_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit RR
-    void ex_rr_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit SLA
-    void ex_sla_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit SRA
-    void ex_sra_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit SWAP
-    void ex_swap_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit SRL
-    void ex_srl_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit BIT
-    void ex_bit_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit RES
-    void ex_res_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    // 8-bit SET
-    void ex_set_byte(Memory &mem, uint8_t opcode_prefix_cb);
-    
-    // 16-bit RLC for (HL) in memory
-    void ex_rlc_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit RRC for (HL) in memory
-    void ex_rrc_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit RL for (HL) in memory
-    void ex_rl_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit RR for (HL) in memory
-    void ex_rr_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit SLA for (HL) in memory
-    void ex_sla_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit SRA for (HL) in memory
-    void ex_sra_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit SWAP for (HL) in memory
-    void ex_swap_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit SRL for (HL) in memory
-    void ex_srl_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit BIT for (HL) in memory
-    void ex_bit_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit RES for (HL) in memory
-    void ex_res_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
-    // 16-bit SET for (HL) in memory
-    void ex_set_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
+    // RLC RRC RL RR SLA SRA SWAP SRL BIT RES SET on n, returns the new value of n
+    // BIT only sets flags, n is returned unchanged
+    template <CbOperation op, uint8_t bit>
+    uint8_t alu_prefix_cb(uint8_t n);
+    // 8-bit register
+    template <CbOperation op, uint8_t bit, RegisterName self>
+    void ex_cb_byte(Memory &mem, uint8_t opcode_prefix_cb);
+    // (HL) in memory
+    template <CbOperation op, uint8_t bit>
+    void ex_cb_hl_mem(Memory &mem, uint8_t opcode_prefix_cb);
 
     // Continue to decode and execute Opcode Prefix CB
     void ex_prefix_cb(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb);
 };
+
+// Handlers specialized per register
+// The register is a template argument, so every opcode gets its own copy with
+// a fixed offset into register_byte / register_pair, no table lookup at run time.
+// Defined here so both the function table and src/cpu-threaded.cc instantiate them.
+
+// 8-bit INC
+template <RegisterName self>
+void Cpu::ex_inc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint8_t temp_reg_byte = reg.get_register_byte(self);
+    temp_reg_byte = alu_inc(temp_reg_byte);
+    reg.set_register_byte(self, temp_reg_byte);
+}
+
+// 8-bit DEC
+template <RegisterName self>
+void Cpu::ex_dec_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint8_t temp_reg_byte = reg.get_register_byte(self);
+    temp_reg_byte = alu_dec(temp_reg_byte);
+    reg.set_register_byte(self, temp_reg_byte);
+}
+
+// 8-bit ADD
+template <RegisterName from>
+void Cpu::ex_add_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_add(reg.get_register_byte(from));
+}
+
+// 8-bit ADC
+template <RegisterName from>
+void Cpu::ex_adc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_adc(reg.get_register_byte(from));
+}
+
+// 8-bit SUB
+template <RegisterName from>
+void Cpu::ex_sub_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_sub(reg.get_register_byte(from));
+}
+
+// 8-bit SBC
+template <RegisterName from>
+void Cpu::ex_sbc_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_sbc(reg.get_register_byte(from));
+}
+
+// 8-bit AND
+template <RegisterName from>
+void Cpu::ex_and_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_and(reg.get_register_byte(from));
+}
+
+// 8-bit XOR
+template <RegisterName from>
+void Cpu::ex_xor_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_xor(reg.get_register_byte(from));
+}
+
+// 8-bit OR
+template <RegisterName from>
+void Cpu::ex_or_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_or(reg.get_register_byte(from));
+}
+
+// 8-bit CP
+template <RegisterName from>
+void Cpu::ex_cp_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_cp(reg.get_register_byte(from));
+}
+
+// 16-bit paired registers to HL ADD
+template <PairName from>
+void Cpu::ex_add_pair_to_hl(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    alu_add_hl(reg.get_pair(from));
+}
+
+// 16-bit paired registers DEC
+// Flags affected: None
+template <PairName self>
+void Cpu::ex_dec_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    reg.register_pair[self]--;
+}
+
+// 16-bit paired registers INC
+// Flags affected: None
+template <PairName self>
+void Cpu::ex_inc_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    reg.register_pair[self]++;
+}
+
+// LD 8-bit register to 8-bit register
+template <RegisterName to, RegisterName from>
+void Cpu::ex_ld_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    reg.set_register_byte(to, reg.get_register_byte(from));
+}
+
+// LD 8-bit imm to 8-bit register
+template <RegisterName to>
+void Cpu::ex_ld_imm_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint8_t temp_imm_byte = read_opcode_byte(mem);
+    reg.set_register_byte(to, temp_imm_byte);
+}
+
+// LD (BC or DE) in memory to A
+template <PairName from>
+void Cpu::ex_ld_pair_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint8_t temp_mem_byte = mem.get_memory_byte(reg.get_pair(from));
+    reg.set_register_byte(RegisterName::r_a, temp_mem_byte);
+}
+
+// LD A to (BC or DE) in memory
+template <PairName to>
+void Cpu::ex_ld_byte_to_pair_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    mem.set_memory_byte(reg.get_pair(to), reg.get_register_byte(RegisterName::r_a));
+}
+
+// LD 8-bit register to (HL) in memory
+template <RegisterName from>
+void Cpu::ex_ld_byte_to_hl_mem(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    mem.set_memory_byte(reg.get_pair(PairName::p_hl), reg.get_register_byte(from));
+}
+
+// LD (HL) in memory to 8-bit register
+template <RegisterName to>
+void Cpu::ex_ld_hl_mem_to_byte(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint8_t temp_mem_byte = mem.get_memory_byte(reg.get_pair(PairName::p_hl));
+    reg.set_register_byte(to, temp_mem_byte);
+}
+
+// LD 16-bit imm to 16-bit paired registers
+template <PairName to>
+void Cpu::ex_ld_imm_to_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint16_t temp_imm_word = read_opcode_word(mem);
+    reg.set_pair(to, temp_imm_word);
+}
+
+// 16-bit PUSH
+template <PairName self>
+void Cpu::ex_push_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    stack_add(mem, reg.get_pair(self));
+}
+
+// 16-bit POP
+template <PairName self>
+void Cpu::ex_pop_pair(Memory &mem, uint8_t opcode_main, uint8_t &ref_opcode_prefix_cb)
+{
+    uint16_t temp_mem_word = stack_pop(mem);
+    reg.set_pair(self, temp_mem_word);
+}
+
+// BIT, SET and RES, inline so the prefix CB handlers below fold the bit in
+inline void Cpu::alu_bit(uint8_t a, uint8_t b)
+{
+    uint8_t temp_reg_byte = (a & (0x01 << b));
+
+    // C is kept
+    reg.set_flags_result(temp_reg_byte, FlagName::f_h | (reg.get_carry() ? FlagName::f_c : 0));
+}
+
+inline uint8_t Cpu::alu_set(uint8_t a, uint8_t b)
+{
+    return (a | (0x01 << b));
+}
+
+inline uint8_t Cpu::alu_res(uint8_t a, uint8_t b)
+{
+    return (a & (~(0x01 << b)));
+}
+
+// Opcode Prefix CB
+// op and bit are constants, the switch is resolved at compile time
+template <CbOperation op, uint8_t bit>
+uint8_t Cpu::alu_prefix_cb(uint8_t n)
+{
+    switch (op)
+    {
+    case CbOperation::cb_rlc:
+        return alu_rlc(n);
+    case CbOperation::cb_rrc:
+        return alu_rrc(n);
+    case CbOperation::cb_rl:
+        return alu_rl(n);
+    case CbOperation::cb_rr:
+        return alu_rr(n);
+    case CbOperation::cb_sla:
+        return alu_sla(n);
+    case CbOperation::cb_sra:
+        return alu_sra(n);
+    case CbOperation::cb_swap:
+        return alu_swap(n);
+    case CbOperation::cb_srl:
+        return alu_srl(n);
+    case CbOperation::cb_bit:
+        alu_bit(n, bit);
+        return n;
+    case CbOperation::cb_res:
+        return alu_res(n, bit);
+    case CbOperation::cb_set:
+    default:
+        return alu_set(n, bit);
+    }
+}
+
+// 8-bit register
+template <CbOperation op, uint8_t bit, RegisterName self>
+void Cpu::ex_cb_byte(Memory &mem, uint8_t opcode_prefix_cb)
+{
+    uint8_t temp_reg_byte = alu_prefix_cb<op, bit>(reg.get_register_byte(self));
+    if (op != CbOperation::cb_bit)
+    {
+        reg.set_register_byte(self, temp_reg_byte);
+    }
+}
+
+// (HL) in memory, BIT only reads it
+template <CbOperation op, uint8_t bit>
+void Cpu::ex_cb_hl_mem(Memory &mem, uint8_t opcode_prefix_cb)
+{
+    uint16_t temp_r_hl_word = reg.get_pair(PairName::p_hl);
+    uint8_t temp_mem_byte = alu_prefix_cb<op, bit>(mem.get_memory_byte(temp_r_hl_word));
+    if (op != CbOperation::cb_bit)
+    {
+        mem.set_memory_byte(temp_r_hl_word, temp_mem_byte);
+    }
+}
+
 } // namespace gameboy
 #endif
\ No newline at end of file
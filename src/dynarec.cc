@@ -0,0 +1,732 @@
+// Dynamic recompiler: x86-64 code emitter, block translation and the dynarec core
+// See src/dynarec.h
+
+#include "cpu.h"
+
+#ifdef GAMEBOY_DYNAREC
+
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+
+using gameboy::BasicBlock;
+using gameboy::BlockInstruction;
+using gameboy::Cpu;
+using gameboy::Dynarec;
+using gameboy::FlagName;
+using gameboy::FlagOp;
+using gameboy::Memory;
+using gameboy::NativeBlock;
+using gameboy::PairName;
+using gameboy::Register;
+using gameboy::RegisterName;
+
+// Native registers in translated code
+// rbx: Cpu *, r12: Memory *, r13: uint64_t *clock, r14: const uint64_t *deadline
+// rax rcx rdx rsi rdi are scratch, helpers are free to change them
+
+// x86-64 machine code writer
+class Emitter
+{
+public:
+    explicit Emitter(uint8_t *start) : start(start), cursor(start) {}
+
+    uint8_t *start;
+    uint8_t *cursor;
+
+    size_t size(void)
+    {
+        return cursor - start;
+    }
+
+    void byte(uint8_t value)
+    {
+        *cursor++ = value;
+    }
+    void word(uint16_t value)
+    {
+        memcpy(cursor, &value, sizeof(value));
+        cursor += sizeof(value);
+    }
+    void dword(uint32_t value)
+    {
+        memcpy(cursor, &value, sizeof(value));
+        cursor += sizeof(value);
+    }
+    void qword(uint64_t value)
+    {
+        memcpy(cursor, &value, sizeof(value));
+        cursor += sizeof(value);
+    }
+
+    // Forward jumps: the jump is emitted with a zero offset, the returned
+    // pointer is patched once the target (the cursor) is known
+    uint8_t *jump_rel32(uint8_t opcode)
+    {
+        byte(opcode);
+        dword(0);
+        return cursor - 4;
+    }
+    uint8_t *jump_cc_rel32(uint8_t condition)
+    {
+        byte(0x0f);
+        byte(condition);
+        dword(0);
+        return cursor - 4;
+    }
+    uint8_t *jump_cc_rel8(uint8_t condition)
+    {
+        byte(condition);
+        byte(0);
+        return cursor - 1;
+    }
+    void patch_rel32(uint8_t *offset)
+    {
+        int32_t temp_offset = cursor - (offset + 4);
+        memcpy(offset, &temp_offset, sizeof(temp_offset));
+    }
+    void patch_rel8(uint8_t *offset)
+    {
+        *offset = (uint8_t)(cursor - (offset + 1));
+    }
+
+    // Cpu fields: [rbx + disp32]
+    // mov al, [rbx + disp]
+    void load_al(int32_t disp)
+    {
+        byte(0x8a);
+        byte(0x83);
+        dword(disp);
+    }
+    // mov cl, [rbx + disp]
+    void load_cl(int32_t disp)
+    {
+        byte(0x8a);
+        byte(0x8b);
+        dword(disp);
+    }
+    // mov [rbx + disp], al
+    void store_al(int32_t disp)
+    {
+        byte(0x88);
+        byte(0x83);
+        dword(disp);
+    }
+    // mov [rbx + disp], cl
+    void store_cl(int32_t disp)
+    {
+        byte(0x88);
+        byte(0x8b);
+        dword(disp);
+    }
+    // mov byte [rbx + disp], imm8
+    void store_imm8(int32_t disp, uint8_t value)
+    {
+        byte(0xc6);
+        byte(0x83);
+        dword(disp);
+        byte(value);
+    }
+    // mov word [rbx + disp], imm16
+    void store_imm16(int32_t disp, uint16_t value)
+    {
+        byte(0x66);
+        byte(0xc7);
+        byte(0x83);
+        dword(disp);
+        word(value);
+    }
+    // inc word [rbx + disp]
+    void inc_word(int32_t disp)
+    {
+        byte(0x66);
+        byte(0xff);
+        byte(0x83);
+        dword(disp);
+    }
+    // dec word [rbx + disp]
+    void dec_word(int32_t disp)
+    {
+        byte(0x66);
+        byte(0xff);
+        byte(0x8b);
+        dword(disp);
+    }
+    // cmp byte [rbx + disp], imm8
+    void compare_imm8(int32_t disp, uint8_t value)
+    {
+        byte(0x80);
+        byte(0xbb);
+        dword(disp);
+        byte(value);
+    }
+    // add qword [rbx + disp], imm32
+    void add_qword(int32_t disp, uint32_t value)
+    {
+        byte(0x48);
+        byte(0x81);
+        byte(0x83);
+        dword(disp);
+        dword(value);
+    }
+
+    // mov cl, imm8
+    void move_cl_imm8(uint8_t value)
+    {
+        byte(0xb1);
+        byte(value);
+    }
+    // 8-bit ALU op al, cl: 0x00 add, 0x28 sub, 0x20 and, 0x30 xor, 0x08 or
+    void alu_al_cl(uint8_t opcode)
+    {
+        byte(opcode);
+        byte(0xc8);
+    }
+    // inc al
+    void inc_al(void)
+    {
+        byte(0xfe);
+        byte(0xc0);
+    }
+    // dec al
+    void dec_al(void)
+    {
+        byte(0xfe);
+        byte(0xc8);
+    }
+    // and al, imm8
+    void and_al_imm8(uint8_t value)
+    {
+        byte(0x24);
+        byte(value);
+    }
+
+    // Call a C function, arguments are set by the caller
+    void call(const void *function)
+    {
+        // mov rax, imm64; call rax
+        byte(0x48);
+        byte(0xb8);
+        qword((uint64_t)function);
+        byte(0xff);
+        byte(0xd0);
+    }
+};
+
+// Offsets of the fields translated code works on
+// They are the same for every Cpu and Memory object
+struct DynarecLayout
+{
+    int32_t register_byte[8];
+    int32_t register_pair[4];
+    int32_t register_word[2];
+    int32_t reg;
+    int32_t flag_op;
+    int32_t flag_x;
+    int32_t flag_y;
+    int32_t flag_carry;
+    int32_t flag_result;
+    int32_t flag_fixed;
+    int32_t enable_interrupts;
+    int32_t instruction_count;
+    // Memory
+    int32_t interrupt_flag;
+    int32_t interrupt_enable;
+    // first page of each half of the ROM space
+    int32_t rom_bank_page[2];
+
+    DynarecLayout(Cpu &cpu, Memory &mem)
+    {
+        const uint8_t *temp_cpu = (const uint8_t *)&cpu;
+        const uint8_t *temp_mem = (const uint8_t *)&mem;
+        for (int i = 0; i < 8; i++)
+        {
+            register_byte[i] = (const uint8_t *)&cpu.reg.register_byte[i] - temp_cpu;
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            register_pair[i] = (const uint8_t *)&cpu.reg.register_pair[i] - temp_cpu;
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            register_word[i] = (const uint8_t *)&cpu.reg.register_word[i] - temp_cpu;
+        }
+        reg = (const uint8_t *)&cpu.reg - temp_cpu;
+        flag_op = &cpu.reg.flag_op - temp_cpu;
+        flag_x = &cpu.reg.flag_x - temp_cpu;
+        flag_y = &cpu.reg.flag_y - temp_cpu;
+        flag_carry = &cpu.reg.flag_carry - temp_cpu;
+        flag_result = &cpu.reg.flag_result - temp_cpu;
+        flag_fixed = &cpu.reg.flag_fixed - temp_cpu;
+        enable_interrupts = (const uint8_t *)&cpu.f_enable_interrupts - temp_cpu;
+        instruction_count = (const uint8_t *)&cpu.instruction_count - temp_cpu;
+        interrupt_flag = &mem.memory_byte[0xff0f] - temp_mem;
+        interrupt_enable = &mem.memory_byte[0xffff] - temp_mem;
+        for (int i = 0; i < 2; i++)
+        {
+            rom_bank_page[i] = (const uint8_t *)&mem.read_page[(i * BANK_SIZE) >> PAGE_SHIFT] - temp_mem;
+        }
+    }
+};
+
+// r in bits 0~2 or 3~5 of an opcode, -1 for (HL)
+static const int8_t opcode_register[8] = {
+    RegisterName::r_b, RegisterName::r_c, RegisterName::r_d, RegisterName::r_e,
+    RegisterName::r_h, RegisterName::r_l, -1, RegisterName::r_a};
+
+// Helpers called by translated code
+static void dynarec_call_main(Cpu *cpu, Memory *mem, uint32_t opcode_main)
+{
+    uint8_t temp_opcode_prefix_cb = 0x00;
+    (cpu->*cpu->handle_opcode_main[opcode_main])(*mem, opcode_main, temp_opcode_prefix_cb);
+}
+
+static void dynarec_call_prefix_cb(Cpu *cpu, Memory *mem, uint32_t opcode_prefix_cb)
+{
+    (cpu->*cpu->handle_opcode_prefix_cb[opcode_prefix_cb])(*mem, opcode_prefix_cb);
+}
+
+// C of a pending none/add/sub operation into flag_fixed
+static void dynarec_keep_carry(Register *reg)
+{
+    reg->flag_fixed = reg->get_carry() ? FlagName::f_c : 0;
+}
+
+// push rbx r12 r13 r14 r15 (r15 keeps the stack 16-byte aligned for calls),
+// then keep the arguments in rbx r12 r13 r14
+static void emit_prologue(Emitter &e)
+{
+    e.byte(0x53);
+    e.byte(0x41);
+    e.byte(0x54);
+    e.byte(0x41);
+    e.byte(0x55);
+    e.byte(0x41);
+    e.byte(0x56);
+    e.byte(0x41);
+    e.byte(0x57);
+    // mov rbx, rdi; mov r12, rsi; mov r13, rdx; mov r14, rcx
+    e.byte(0x48);
+    e.byte(0x89);
+    e.byte(0xfb);
+    e.byte(0x49);
+    e.byte(0x89);
+    e.byte(0xf4);
+    e.byte(0x49);
+    e.byte(0x89);
+    e.byte(0xd5);
+    e.byte(0x49);
+    e.byte(0x89);
+    e.byte(0xce);
+}
+
+// add qword [r13], 4 * cycles
+static void emit_add_clock(Emitter &e, uint32_t cycles)
+{
+    e.byte(0x49);
+    e.byte(0x81);
+    e.byte(0x45);
+    e.byte(0x00);
+    e.dword(4 * cycles);
+}
+
+// Add the cycles (not yet in [r13]) and instructions run so far, then return
+static void emit_exit(Emitter &e, const DynarecLayout &layout, uint32_t cycles, uint32_t instructions)
+{
+    if (cycles)
+    {
+        emit_add_clock(e, cycles);
+    }
+    e.add_qword(layout.instruction_count, instructions);
+
+    // pop r15 r14 r13 r12 rbx; ret
+    e.byte(0x41);
+    e.byte(0x5f);
+    e.byte(0x41);
+    e.byte(0x5e);
+    e.byte(0x41);
+    e.byte(0x5d);
+    e.byte(0x41);
+    e.byte(0x5c);
+    e.byte(0x5b);
+    e.byte(0xc3);
+}
+
+// After a memory write or EI, leave the block on the tests of Cpu::run_block:
+// deadline reached, interrupt to handle, or another bank mapped under the block
+// (rom_bank_page is the first page of the block's half when it was translated)
+// cycles are the ones not yet added to [r13]
+static void emit_check(Emitter &e, const DynarecLayout &layout, uint32_t cycles, uint32_t instructions,
+                       int half, const uint8_t *rom_bank_page)
+{
+    uint8_t *temp_exit[3];
+
+    // mov rax, [r13]; add rax, 4 * cycles; cmp rax, [r14]; jae exit
+    e.byte(0x49);
+    e.byte(0x8b);
+    e.byte(0x45);
+    e.byte(0x00);
+    e.byte(0x48);
+    e.byte(0x05);
+    e.dword(4 * cycles);
+    e.byte(0x49);
+    e.byte(0x3b);
+    e.byte(0x06);
+    temp_exit[0] = e.jump_cc_rel32(0x83);
+
+    // interrupts enabled and IF & IE: jnz exit
+    e.compare_imm8(layout.enable_interrupts, 0);
+    uint8_t *temp_disabled = e.jump_cc_rel8(0x74);
+    // mov al, [r12 + IF]; and al, [r12 + IE]
+    e.byte(0x41);
+    e.byte(0x8a);
+    e.byte(0x84);
+    e.byte(0x24);
+    e.dword(layout.interrupt_flag);
+    e.byte(0x41);
+    e.byte(0x22);
+    e.byte(0x84);
+    e.byte(0x24);
+    e.dword(layout.interrupt_enable);
+    temp_exit[1] = e.jump_cc_rel32(0x85);
+    e.patch_rel8(temp_disabled);
+
+    // mov rax, [r12 + read_page[0x00 or 0x40]]; mov rcx, imm64; cmp rax, rcx; jne exit
+    e.byte(0x49);
+    e.byte(0x8b);
+    e.byte(0x84);
+    e.byte(0x24);
+    e.dword(layout.rom_bank_page[half]);
+    e.byte(0x48);
+    e.byte(0xb9);
+    e.qword((uint64_t)rom_bank_page);
+    e.byte(0x48);
+    e.byte(0x39);
+    e.byte(0xc8);
+    temp_exit[2] = e.jump_cc_rel32(0x85);
+    uint8_t *temp_continue = e.jump_rel32(0xe9);
+
+    for (int i = 0; i < 3; i++)
+    {
+        e.patch_rel32(temp_exit[i]);
+    }
+    emit_exit(e, layout, cycles, instructions);
+    e.patch_rel32(temp_continue);
+}
+
+// 8-bit ALU on A and cl, lazy flags as in Cpu::alu_add and the others
+// group is bits 3~5 of the opcode: 0 ADD, 2 SUB, 4 AND, 5 XOR, 6 OR, 7 CP
+static void emit_alu(Emitter &e, const DynarecLayout &layout, uint8_t group)
+{
+    e.load_al(layout.register_byte[RegisterName::r_a]);
+    if (group == 0 || group == 2 || group == 7)
+    {
+        e.store_al(layout.flag_x);
+        e.store_cl(layout.flag_y);
+        e.store_imm8(layout.flag_carry, 0);
+        e.alu_al_cl(group == 0 ? 0x00 : 0x28);
+        e.store_al(layout.flag_result);
+        if (group != 7)
+        {
+            e.store_al(layout.register_byte[RegisterName::r_a]);
+        }
+        e.store_imm8(layout.flag_op, group == 0 ? FlagOp::flag_op_add : FlagOp::flag_op_sub);
+        return;
+    }
+
+    e.alu_al_cl(group == 4 ? 0x20 : (group == 5 ? 0x30 : 0x08));
+    e.store_al(layout.flag_result);
+    e.store_al(layout.register_byte[RegisterName::r_a]);
+    e.store_imm8(layout.flag_fixed, group == 4 ? FlagName::f_h : 0);
+    e.store_imm8(layout.flag_op, FlagOp::flag_op_result);
+}
+
+// Emit the native code of a main opcode at address
+// Return false if the interpreter handler has to run it
+static bool emit_native(Emitter &e, const DynarecLayout &layout, Memory &mem, uint8_t opcode_main, uint16_t address)
+{
+    // NOP
+    if (opcode_main == 0x00)
+    {
+        return true;
+    }
+
+    // LD r, n
+    if ((opcode_main & 0xc7) == 0x06 && opcode_main != 0x36)
+    {
+        int8_t temp_to = opcode_register[(opcode_main >> 3) & 0x07];
+        e.store_imm8(layout.register_byte[temp_to], mem.get_memory_byte(address + 1));
+        return true;
+    }
+
+    // LD rr, nn  INC rr  DEC rr
+    if ((opcode_main & 0xc0) == 0x00 && ((opcode_main & 0x0f) == 0x01 || (opcode_main & 0x07) == 0x03))
+    {
+        static const PairName temp_pairs[3] = {PairName::p_bc, PairName::p_de, PairName::p_hl};
+        uint8_t temp_index = (opcode_main >> 4) & 0x03;
+        int32_t temp_disp = (temp_index == 3) ? layout.register_word[RegisterName::r_sp]
+                                              : layout.register_pair[temp_pairs[temp_index]];
+        if ((opcode_main & 0x0f) == 0x01)
+        {
+            e.store_imm16(temp_disp, mem.get_memory_word(address + 1));
+        }
+        else if ((opcode_main & 0x0f) == 0x03)
+        {
+            e.inc_word(temp_disp);
+        }
+        else
+        {
+            e.dec_word(temp_disp);
+        }
+        return true;
+    }
+
+    // INC r  DEC r
+    if (((opcode_main & 0xc7) == 0x04 || (opcode_main & 0xc7) == 0x05) &&
+        opcode_main != 0x34 && opcode_main != 0x35)
+    {
+        int32_t temp_disp = layout.register_byte[opcode_register[(opcode_main >> 3) & 0x07]];
+        bool f_inc = (opcode_main & 0x07) == 0x04;
+
+        // C is kept, same as Register::set_flags_inc: after result/inc/dec it is
+        // already in flag_fixed, otherwise derive it there
+        e.compare_imm8(layout.flag_op, FlagOp::flag_op_result);
+        uint8_t *temp_in_fixed = e.jump_cc_rel8(0x73);
+        // lea rdi, [rbx + reg]
+        e.byte(0x48);
+        e.byte(0x8d);
+        e.byte(0xbb);
+        e.dword(layout.reg);
+        e.call((const void *)&dynarec_keep_carry);
+        e.patch_rel8(temp_in_fixed);
+
+        e.load_al(layout.flag_fixed);
+        e.and_al_imm8(FlagName::f_c);
+        e.store_al(layout.flag_fixed);
+        e.load_al(temp_disp);
+        if (f_inc)
+        {
+            e.inc_al();
+        }
+        else
+        {
+            e.dec_al();
+        }
+        e.store_al(temp_disp);
+        e.store_al(layout.flag_result);
+        e.store_imm8(layout.flag_op, f_inc ? FlagOp::flag_op_inc : FlagOp::flag_op_dec);
+        return true;
+    }
+
+    // LD r, r'
+    if (opcode_main >= 0x40 && opcode_main < 0x80)
+    {
+        int8_t temp_to = opcode_register[(opcode_main >> 3) & 0x07];
+        int8_t temp_from = opcode_register[opcode_main & 0x07];
+        if (temp_to < 0 || temp_from < 0)
+        {
+            return false;
+        }
+        if (temp_to != temp_from)
+        {
+            e.load_al(layout.register_byte[temp_from]);
+            e.store_al(layout.register_byte[temp_to]);
+        }
+        return true;
+    }
+
+    // ADD SUB AND XOR OR CP r, ADC and SBC are left to the interpreter
+    if (opcode_main >= 0x80 && opcode_main < 0xc0)
+    {
+        uint8_t temp_group = (opcode_main >> 3) & 0x07;
+        int8_t temp_from = opcode_register[opcode_main & 0x07];
+        if (temp_from < 0 || temp_group == 1 || temp_group == 3)
+        {
+            return false;
+        }
+        e.load_cl(layout.register_byte[temp_from]);
+        emit_alu(e, layout, temp_group);
+        return true;
+    }
+
+    // ADD SUB AND XOR OR CP n
+    switch (opcode_main)
+    {
+    case 0xc6: case 0xd6: case 0xe6: case 0xee: case 0xf6: case 0xfe:
+        e.move_cl_imm8(mem.get_memory_byte(address + 1));
+        emit_alu(e, layout, (opcode_main >> 3) & 0x07);
+        return true;
+    default:
+        return false;
+    }
+}
+
+Dynarec::~Dynarec()
+{
+    if (code)
+    {
+        munmap(code, DYNAREC_CODE_SIZE);
+    }
+}
+
+void Dynarec::clear(void)
+{
+    for (BasicBlock *temp_block : translated_blocks)
+    {
+        temp_block->native_code = nullptr;
+        temp_block->run_count = 0;
+    }
+    translated_blocks.clear();
+    code_used = 0;
+}
+
+bool Dynarec::translate(Cpu &cpu, Memory &mem, BasicBlock &block, uint16_t address)
+{
+    if (f_unavailable)
+    {
+        return false;
+    }
+    if (!code)
+    {
+        void *temp_code = mmap(nullptr, DYNAREC_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (temp_code == MAP_FAILED)
+        {
+            printf("Dynarec: no executable memory, ROM code stays interpreted\n");
+            f_unavailable = true;
+            return false;
+        }
+        code = (uint8_t *)temp_code;
+    }
+    // Full: start again, hot blocks are translated again on their next runs
+    if (code_used + DYNAREC_BLOCK_MAX_BYTES > DYNAREC_CODE_SIZE)
+    {
+        clear();
+    }
+
+    DynarecLayout temp_layout(cpu, mem);
+    // blocks leave when another bank is mapped under them, MBC1 and MBC5 can switch 0x0000~0x3FFF too
+    int temp_half = (address >= BANK_SIZE) ? 1 : 0;
+    const uint8_t *temp_rom_bank_page = mem.read_page[(temp_half * BANK_SIZE) >> PAGE_SHIFT];
+
+    Emitter e(code + code_used);
+    emit_prologue(e);
+
+    uint32_t temp_cycles = 0;
+    // cycles already added to [r13]
+    uint32_t temp_cycles_stored = 0;
+    uint32_t temp_address = address;
+    // PC is only written before a handler call and at the end
+    bool f_pc_stored = false;
+    for (size_t i = 0; i < block.instructions.size(); i++)
+    {
+        const BlockInstruction &temp_instruction = block.instructions[i];
+        uint8_t temp_opcode_main = temp_instruction.f_prefix_cb ? 0xcb : temp_instruction.opcode;
+
+        if (!temp_instruction.f_prefix_cb && emit_native(e, temp_layout, mem, temp_opcode_main, temp_address))
+        {
+            f_pc_stored = false;
+        }
+        else
+        {
+            // handlers expect PC after the opcode, as in Cpu::run_block
+            e.store_imm16(temp_layout.register_word[RegisterName::r_pc],
+                          temp_address + (temp_instruction.f_prefix_cb ? 2 : 1));
+            // a write may read the clock (MBC3 RTC latch, timer registers):
+            // bring [r13] to the start of this instruction, as Cpu::run_block has it
+            if (temp_instruction.f_check && temp_cycles > temp_cycles_stored)
+            {
+                emit_add_clock(e, temp_cycles - temp_cycles_stored);
+                temp_cycles_stored = temp_cycles;
+            }
+            // mov rdi, rbx; mov rsi, r12; mov edx, opcode
+            e.byte(0x48);
+            e.byte(0x89);
+            e.byte(0xdf);
+            e.byte(0x4c);
+            e.byte(0x89);
+            e.byte(0xe6);
+            e.byte(0xba);
+            e.dword(temp_instruction.opcode);
+            if (!temp_instruction.f_prefix_cb)
+            {
+                e.call((const void *)&dynarec_call_main);
+            }
+            else
+            {
+                e.call((const void *)&dynarec_call_prefix_cb);
+            }
+            f_pc_stored = true;
+        }
+        temp_cycles += temp_instruction.cycles;
+        temp_address += opcode_length_main[temp_opcode_main];
+
+        if (temp_instruction.f_check && i + 1 < block.instructions.size())
+        {
+            emit_check(e, temp_layout, temp_cycles - temp_cycles_stored, i + 1, temp_half, temp_rom_bank_page);
+        }
+    }
+    if (!f_pc_stored)
+    {
+        e.store_imm16(temp_layout.register_word[RegisterName::r_pc], temp_address);
+    }
+    emit_exit(e, temp_layout, temp_cycles - temp_cycles_stored, block.instructions.size());
+
+    block.native_code = (NativeBlock)(code + code_used);
+    // next block on a 16-byte boundary
+    code_used = (code_used + e.size() + 15) & ~(size_t)15;
+    translated_blocks.push_back(&block);
+    translated_count++;
+    return true;
+}
+
+// Dynarec core
+// Same loop as Cpu::run_table, a block that is hot and ends before deadline
+// runs its translated code
+void Cpu::run_dynarec(Memory &mem, uint64_t &clock, const uint64_t &deadline)
+{
+    // events may have changed memory since the last run
+    idle_loop_armed = false;
+    while (clock < deadline)
+    {
+        // halted and no interrupt to wake up, same test as handle_interrupts
+        if (f_halted && !(mem.memory_byte[0xff0f] & mem.memory_byte[0xffff]))
+        {
+            skip_halt(clock, deadline);
+            return;
+        }
+        BasicBlock *temp_block = nullptr;
+        if (!f_halted && reg.register_word[RegisterName::r_pc] < BLOCK_ROM_END_ADDRESS &&
+            !(f_enable_interrupts && (mem.memory_byte[0xff0f] & mem.memory_byte[0xffff])))
+        {
+            temp_block = get_block(mem);
+        }
+        if (temp_block && !temp_block->instructions.empty())
+        {
+            // translated at its entry, so the mapped bank is the one of the block
+            if (!temp_block->native_code && ++temp_block->run_count == DYNAREC_HOT_RUNS)
+            {
+                dynarec.translate(*this, mem, *temp_block, reg.register_word[RegisterName::r_pc]);
+            }
+            // translated code checks deadline after writes only
+            if (temp_block->native_code && clock + 4 * temp_block->cycles < deadline)
+            {
+                temp_block->native_code(this, &mem, &clock, &deadline);
+            }
+            else
+            {
+                run_block(mem, *temp_block, clock, deadline);
+            }
+        }
+        else
+        {
+            clock += 4 * next(mem);
+        }
+        if (idle_loop_hit)
+        {
+            skip_idle_loop(clock, deadline);
+        }
+    }
+}
+
+#endif
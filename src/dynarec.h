@@ -0,0 +1,66 @@
+// Dynamic recompiler for ROM code (x86-64)
+// A basic block of the block cache (src/block-cache.h) that ran DYNAREC_HOT_RUNS
+// times is translated into native code working on the Cpu fields directly.
+// NOP, 8-bit and 16-bit register loads, INC/DEC and the 8-bit ALU on registers
+// and immediates are native, every other instruction calls its interpreter handler.
+// Cycles and instructions are added at block exits: the end of the block, or an
+// early exit after a memory write or EI, on the same tests as Cpu::run_block.
+// Code in RAM and blocks that may reach deadline still run through the interpreter.
+// Build option: GAMEBOY_DYNAREC in CMakeLists.txt (off by default)
+
+#ifndef GAMEBOY_DYNAREC_H
+#define GAMEBOY_DYNAREC_H
+
+#include "block-cache.h"
+#include "memory.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Native code is emitted for x86-64 and needs mmap
+#if defined(GAMEBOY_DYNAREC) && !(defined(__x86_64__) && defined(__unix__))
+#undef GAMEBOY_DYNAREC
+#endif
+
+// Runs of a block through the interpreter before it is translated
+#define DYNAREC_HOT_RUNS 16
+// Executable memory of one CPU, flushed when full
+#define DYNAREC_CODE_SIZE (16 * 1024 * 1024)
+// Upper bound of the code of one block (BLOCK_MAX_INSTRUCTIONS instructions)
+#define DYNAREC_BLOCK_MAX_BYTES 16384
+
+namespace gameboy
+{
+
+class Cpu;
+
+class Dynarec
+{
+public:
+    Dynarec() = default;
+    ~Dynarec();
+    // translated code points into this object
+    Dynarec(const Dynarec &) = delete;
+    Dynarec &operator=(const Dynarec &) = delete;
+
+    // Translate block, decoded at address with the bank mapped now
+    // Return false if there is no executable memory, the block stays interpreted
+    bool translate(Cpu &cpu, Memory &mem, BasicBlock &block, uint16_t address);
+
+    // Drop every translation, called before the block cache is cleared
+    void clear(void);
+
+    // Blocks translated since power on
+    uint64_t translated_count = 0;
+
+private:
+    uint8_t *code = nullptr;
+    size_t code_used = 0;
+    // mmap failed once, do not try again
+    bool f_unavailable = false;
+    // blocks pointing into code
+    std::vector<BasicBlock *> translated_blocks;
+};
+} // namespace gameboy
+
+#endif
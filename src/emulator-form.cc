@@ -2,7 +2,7 @@
 
 using namespace gameboy;
 
-bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
+bool Emulatorform::get_joypad_input(JoypadInput &input)
 {
 
     // W-Up
@@ -18,12 +18,10 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
     // P-Quit and Save
     // L-Fast Foward
 
+    // Called once per input poll (see InputPollMode), not per instruction:
+    // only updates input, the motherboard latches it into the joypad
     while (SDL_PollEvent(&(Emulatorform::joypad_event)))
     {
-        joypad.temp_ff00 = mem.get_memory_byte(0xFF00);
-        joypad.temp_ff00 &= 0x30;
-        mem.set_memory_byte(0xFF00, joypad.temp_ff00);
-
         if (joypad_event.type == SDL_QUIT)
             return false;
 
@@ -41,70 +39,54 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
             // for column 1 (Directions)
             // hit RIGHT
             case SDLK_d:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions &= 0xE;
+                input.keys_directions &= 0xE;
                 break;
 
             // hit LEFT
             case SDLK_a:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions &= 0xD;
+                input.keys_directions &= 0xD;
                 break;
 
             // hit UP
             case SDLK_w:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions &= 0xB;
+                input.keys_directions &= 0xB;
                 break;
 
             // hit DOWN
             case SDLK_s:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions &= 0x7;
+                input.keys_directions &= 0x7;
                 break;
 
             // for column 0 (Controls)
             // hit A
             case SDLK_j:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0xE;
+                input.keys_controls &= 0xE;
                 break;
 
             // hit B
             case SDLK_k:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0xD;
+                input.keys_controls &= 0xD;
                 break;
 
             // hit SELECT
             case SDLK_t:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0xB;
+                input.keys_controls &= 0xB;
                 break;
 
             // hit START
             case SDLK_RETURN:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0x7;
+                input.keys_controls &= 0x7;
                 break;
 
             // hit Quick Save
             case SDLK_q:
-                joypad.save_flag = 1;
+                input.save_request = true;
                 printf("Will save before next poll...\n");
                 break;
 
             // hit Quick Load
             case SDLK_y:
-                joypad.load_flag = 1;
+                input.load_request = true;
                 printf("Will load before next poll...\n");
                 break;
 
@@ -114,10 +96,9 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
                 return false;
                 break;
 
-            // hit Fast Foward
+            // hold Fast Foward
             case SDLK_l:
-                joypad.fast_forward_flag = 1;
-                printf("Triggering fast foward...\n");
+                input.fast_forward = true;
                 break;
             }
             //joypad.joypad_interrupts(mem);
@@ -130,59 +111,48 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
             // for column 1 (Directions)
             // release RIGHT
             case SDLK_d:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions |= 0x1;
+                input.keys_directions |= 0x1;
                 break;
 
             // release LEFT
             case SDLK_a:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions |= 0x2;
+                input.keys_directions |= 0x2;
                 break;
 
             // release UP
             case SDLK_w:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions |= 0x4;
+                input.keys_directions |= 0x4;
                 break;
 
             // release DOWN
             case SDLK_s:
-                joypad.key_column = 0x20;
-                joypad.column_direction = 1;
-                joypad.keys_directions |= 0x8;
+                input.keys_directions |= 0x8;
                 break;
 
             // for column 0 (Controls)
             // release A
             case SDLK_j:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x1;
+                input.keys_controls |= 0x1;
                 break;
 
             // release B
             case SDLK_k:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x2;
+                input.keys_controls |= 0x2;
                 break;
 
             // release SELECT
             case SDLK_t:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x4;
+                input.keys_controls |= 0x4;
                 break;
 
             // release START
             case SDLK_RETURN:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x8;
+                input.keys_controls |= 0x8;
+                break;
+
+            // release Fast Foward
+            case SDLK_l:
+                input.fast_forward = false;
                 break;
             }
         }
@@ -197,25 +167,19 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
                     //Left of dead zone,
                     if( joypad_event.jaxis.value < -JOYSTICK_DEAD_ZONE )
                     {
-                        joypad.key_column = 0x20;
-                        joypad.column_direction = 1;
-                        joypad.keys_directions &= 0xD;
+                        input.keys_directions &= 0xD;
                         break;
                     }
                     //Right of dead zone
                     else if( joypad_event.jaxis.value > JOYSTICK_DEAD_ZONE )
                     {
-                        joypad.key_column = 0x20;
-                        joypad.column_direction = 1;
-                        joypad.keys_directions &= 0xE;
+                        input.keys_directions &= 0xE;
                         break;
                     }
                     else
                     {
-                        joypad.key_column = 0x20;
-                        joypad.column_direction = 1;
-                        joypad.keys_directions |= 0x2;
-                        joypad.keys_directions |= 0x1;
+                        input.keys_directions |= 0x2;
+                        input.keys_directions |= 0x1;
                     }
                 }
                 //Y axis motion
@@ -224,25 +188,19 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
                     //Below of dead zone
                     if( joypad_event.jaxis.value < -JOYSTICK_DEAD_ZONE )
                     {
-                        joypad.key_column = 0x20;
-                        joypad.column_direction = 1;
-                        joypad.keys_directions &= 0xB;
+                        input.keys_directions &= 0xB;
                         break;
                     }
                     //Above of dead zone
                     else if( joypad_event.jaxis.value > JOYSTICK_DEAD_ZONE )
                     {
-                        joypad.key_column = 0x20;
-                        joypad.column_direction = 1;
-                        joypad.keys_directions &= 0x7;
+                        input.keys_directions &= 0x7;
                         break;
                     }
                     else
                     {
-                        joypad.key_column = 0x20;
-                        joypad.column_direction = 1;
-                        joypad.keys_directions |= 0x8;
-                        joypad.keys_directions |= 0x4;
+                        input.keys_directions |= 0x8;
+                        input.keys_directions |= 0x4;
                     }
                 }
             }
@@ -252,32 +210,26 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
             switch (joypad_event.jbutton.button)
             {
             case SDL_CONTROLLER_BUTTON_A:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0xE;
+                input.keys_controls &= 0xE;
                 break;
 
             case SDL_CONTROLLER_BUTTON_B:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0xD;
+                input.keys_controls &= 0xD;
                 break;
 
             case SDL_CONTROLLER_BUTTON_START:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls &= 0x7;
+                input.keys_controls &= 0x7;
                 break;
 
             // hit Quick Save
             case SDL_CONTROLLER_BUTTON_X:
-                joypad.save_flag = 1;
+                input.save_request = true;
                 printf("Will save before next poll...\n");
                 break;
 
             // hit Quick Load
             case SDL_CONTROLLER_BUTTON_Y:
-                joypad.load_flag = 1;
+                input.load_request = true;
                 printf("Will load before next poll...\n");
                 break;
 
@@ -290,52 +242,63 @@ bool Emulatorform::get_joypad_input(Joypad &joypad, Memory &mem)
             switch (joypad_event.jbutton.button)
             {
             case SDL_CONTROLLER_BUTTON_A:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x1;
+                input.keys_controls |= 0x1;
                 break;
 
             case SDL_CONTROLLER_BUTTON_B:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x2;
+                input.keys_controls |= 0x2;
                 break;
 
             case SDL_CONTROLLER_BUTTON_START:
-                joypad.key_column = 0x10;
-                joypad.column_controls = 1;
-                joypad.keys_controls |= 0x8;
+                input.keys_controls |= 0x8;
                 break;
             default:
                 break;
             }
         }
     }
-    joypad.write_result(mem);
-    joypad.reset_joypad();
     return true;
 }
 
-bool Emulatorform::refresh_surface(void)
+void Emulatorform::draw_frame(uint8_t frame_buffer[SCREEN_HEIGHT][SCREEN_WIDTH], uint8_t scale)
 {
-    SDL_UpdateWindowSurface(Emulatorform::emulator_window);
-    return false;
-}
+    if (SDL_MUSTLOCK(Emulatorform::emulator_window_surface))
+    {
+        SDL_LockSurface(Emulatorform::emulator_window_surface);
+    }
+    uint8_t *pixels = (uint8_t *)Emulatorform::emulator_window_surface->pixels;
+    int pitch = Emulatorform::emulator_window_surface->pitch;
 
-void Emulatorform::set_pixel_color(uint8_t pos_x, uint8_t pos_y, uint8_t color, uint8_t scale)
-{
-    SDL_UnlockSurface(Emulatorform::emulator_window_surface);
-    auto format = Emulatorform::emulator_window_surface->format;
-    uint32_t *pixels = (Uint32 *)Emulatorform::emulator_window_surface->pixels;
-    for (int scale_x = 0; scale_x < scale; scale_x++)
+    for (int pos_y = 0; pos_y < SCREEN_HEIGHT; pos_y++)
     {
-        for (int scale_y = 0; scale_y < scale; scale_y++)
+        // scale the line once, then copy it to the other scaled lines
+        uint32_t *scaled_line = (uint32_t *)(pixels + pos_y * scale * pitch);
+        for (int pos_x = 0; pos_x < SCREEN_WIDTH; pos_x++)
         {
-            pixels[(pos_y * scale + scale_y) * (SCREEN_WIDTH * scale) + pos_x * scale + scale_x] = SDL_MapRGB(format, Emulatorform::color_palatte[color][0], Emulatorform::color_palatte[color][1], Emulatorform::color_palatte[color][2]);
+            uint32_t color = palette_lut[frame_buffer[pos_y][pos_x] & 0x03];
+            for (int scale_x = 0; scale_x < scale; scale_x++)
+            {
+                scaled_line[pos_x * scale + scale_x] = color;
+            }
         }
+        for (int scale_y = 1; scale_y < scale; scale_y++)
+        {
+            memcpy(pixels + (pos_y * scale + scale_y) * pitch, scaled_line, SCREEN_WIDTH * scale * sizeof(uint32_t));
+        }
+    }
+
+    if (SDL_MUSTLOCK(Emulatorform::emulator_window_surface))
+    {
+        SDL_UnlockSurface(Emulatorform::emulator_window_surface);
     }
 }
 
+bool Emulatorform::refresh_surface(void)
+{
+    SDL_UpdateWindowSurface(Emulatorform::emulator_window);
+    return false;
+}
+
 void Emulatorform::create_window(uint16_t on_screen_window_width, uint16_t on_screen_window_height, std::string on_screen_title, uint8_t rgb_red, uint8_t rgb_green, uint8_t rgb_blue, uint8_t scale)
 {
     // init video and joystick
@@ -356,6 +319,12 @@ void Emulatorform::create_window(uint16_t on_screen_window_width, uint16_t on_sc
     // get the surface
     Emulatorform::emulator_window_surface = SDL_GetWindowSurface(Emulatorform::emulator_window);
 
+    // map the 4 shades to the surface's pixel format once
+    for (int shade = 0; shade < 4; shade++)
+    {
+        palette_lut[shade] = SDL_MapRGB(Emulatorform::emulator_window_surface->format, color_palatte[shade][0], color_palatte[shade][1], color_palatte[shade][2]);
+    }
+
     // fill window with colors
     SDL_FillRect(Emulatorform::emulator_window_surface, NULL, SDL_MapRGB(Emulatorform::emulator_window_surface->format, rgb_red, rgb_green, rgb_blue));
 
@@ -0,0 +1,42 @@
+#include "frame-pacer.h"
+
+#include <thread>
+
+using gameboy::FramePacer;
+
+void FramePacer::reset(void)
+{
+    deadline = std::chrono::steady_clock::now();
+    remainder = 0;
+    advance_deadline();
+}
+
+void FramePacer::wait_next_frame(void)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto max_lag = std::chrono::nanoseconds((uint64_t)CLOCKS_PER_FRAME * 1000000000 / CLOCK_RATE * FRAME_PACER_MAX_LAG_FRAMES);
+    if (now - deadline > max_lag)
+    {
+        reset();
+        return;
+    }
+
+    auto spin_start = deadline - std::chrono::microseconds(FRAME_PACER_SPIN_MICROSECONDS);
+    if (now < spin_start)
+    {
+        std::this_thread::sleep_for(spin_start - now);
+    }
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    advance_deadline();
+}
+
+void FramePacer::advance_deadline(void)
+{
+    // 70224 * 10^9 / 4194304 = 16742706.3 ns
+    uint64_t temp_total = (uint64_t)CLOCKS_PER_FRAME * 1000000000 + remainder;
+    deadline += std::chrono::nanoseconds(temp_total / CLOCK_RATE);
+    remainder = temp_total % CLOCK_RATE;
+}
@@ -0,0 +1,45 @@
+// Frame pacing
+// A frame is 70224 clocks of emulated time, at 4194304 Hz that is 59.73 frames per second
+// The host sleeps until each frame's deadline, the last part is spun for precision
+
+#ifndef GAMEBOY_FRAME_PACER_H
+#define GAMEBOY_FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+
+#define CLOCK_RATE 4194304
+#define CLOCKS_PER_FRAME 70224
+// sleeping may overshoot by the OS timer slack, spin the rest
+#define FRAME_PACER_SPIN_MICROSECONDS 2000
+// start again from now when the host fell this far behind (paused, fast forward)
+#define FRAME_PACER_MAX_LAG_FRAMES 3
+
+namespace gameboy
+{
+
+class FramePacer
+{
+public:
+    FramePacer()
+    {
+        reset();
+    }
+
+    // First deadline is one frame from now
+    void reset(void);
+
+    // Block until the deadline of the frame just emulated
+    // Do not call it while fast forwarding, the next call resynchronizes
+    void wait_next_frame(void);
+
+private:
+    std::chrono::steady_clock::time_point deadline;
+    // nanoseconds per frame are not whole, carry the remainder (in 1/CLOCK_RATE ns)
+    uint64_t remainder = 0;
+
+    void advance_deadline(void);
+};
+} // namespace gameboy
+
+#endif
@@ -1,4 +1,5 @@
 #include "joypad.h"
+#include "memory.h"
 
 using namespace gameboy;
 
@@ -21,16 +22,9 @@ void Joypad::joypad_interrupts(Memory &mem)
 
 void Joypad::write_result(Memory &mem)
 {
-    uint8_t column_requested = mem.get_memory_byte(0xFF00) & 0x30;
-    if (column_requested == 0x10)
-    {
-        Joypad::temp_ff00 = 0x10 + Joypad::keys_controls;
-    }
-    if (column_requested == 0x20)
-    {
-        Joypad::temp_ff00 = 0x20 + Joypad::keys_directions;
-    }
-    mem.set_memory_byte(JOYPAD_ADDRESS, Joypad::temp_ff00);
+    // refresh FF00 for the column the game selected last time,
+    // so newly latched keys are visible without waiting for the next select write
+    mem.memory_byte[JOYPAD_ADDRESS] = select_column(mem.memory_byte[JOYPAD_ADDRESS]);
 }
 
 void Joypad::reset_joypad(void)
@@ -42,3 +36,40 @@ void Joypad::reset_joypad(void)
     Joypad::column_controls = 0;
     Joypad::column_direction = 0;
 }
+
+uint8_t Joypad::select_column(uint8_t byte)
+{
+    uint8_t column_requested = byte & 0x30;
+    uint8_t keys = 0x0F;
+    if (!(column_requested & 0x10))
+    {
+        keys &= Joypad::keys_directions;
+    }
+    if (!(column_requested & 0x20))
+    {
+        keys &= Joypad::keys_controls;
+    }
+    Joypad::temp_ff00 = column_requested | keys;
+    return Joypad::temp_ff00;
+}
+
+void Joypad::save_state(StateWriter &writer)
+{
+    writer.put_byte(key_column);
+    writer.put_byte(column_direction);
+    writer.put_byte(column_controls);
+    writer.put_byte(keys_directions);
+    writer.put_byte(keys_controls);
+    writer.put_byte(temp_ff00);
+}
+
+bool Joypad::load_state(StateReader &reader)
+{
+    key_column = reader.get_byte();
+    column_direction = reader.get_byte();
+    column_controls = reader.get_byte();
+    keys_directions = reader.get_byte() & 0x0F;
+    keys_controls = reader.get_byte() & 0x0F;
+    temp_ff00 = reader.get_byte();
+    return !reader.failed();
+}
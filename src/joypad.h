@@ -1,17 +1,36 @@
 // Joypad
-// read input from SDL and excute the functions here.
+// front ends fill a JoypadInput, the motherboard latches it here.
 
 #ifndef GAMEBOY_JOYPAD_H
 #define GAMEBOY_JOYPAD_H
+#include "save-state.h"
 #include <cstdint>
 #include <cstdio>
-#include "memory.h"
 
 #define JOYPAD_ADDRESS 0xFF00
 #define IF_ADDRESS 0xFF0F
 
 namespace gameboy
 {
+class Memory;
+
+// Host side buttons, kept by the front end between polls
+struct JoypadInput
+{
+    // same layout as FF00 bit 0~3, 0 means pressed
+    // Right Left Up Down
+    uint8_t keys_directions = 0x0F;
+    // A B Select Start
+    uint8_t keys_controls = 0x0F;
+
+    // one-shot requests, cleared once handled
+    bool save_request = false;
+    bool load_request = false;
+
+    // held on the host, the front end stops pacing frames while set
+    bool fast_forward = false;
+};
+
 class Joypad
 {
 public:
@@ -29,14 +48,17 @@ public:
     // temp FF00
     uint8_t temp_ff00 = 0x00;
 
-    uint8_t save_flag = 0x00;
-    uint8_t load_flag = 0x00;
-
-    uint8_t fast_forward_flag = 0x00;
-
     void joypad_interrupts(Memory &mem);
     void write_result(Memory &mem);
     void reset_joypad(void);
+
+    // Compose FF00 from the latched keys when the game writes the select bits
+    // bit 4 low: direction keys, bit 5 low: control keys
+    uint8_t select_column(uint8_t byte);
+
+    // Save states: the selected column and the latched keys
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
 };
 } // namespace gameboy
 
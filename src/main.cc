@@ -1,31 +1,125 @@
 // Init all and do the emulation
+// SDL front end of the core library (libnekomimi)
 
 #include "motherboard.h"
+#include "emulator-form.h"
+#include "frame-pacer.h"
+#include "benchmark.h"
+
 //#define DEBUG
 
+// while fast forwarding, draw and show one frame out of FAST_FORWARD_FRAMESKIP + 1
+#define FAST_FORWARD_FRAMESKIP 7
+
 using gameboy::Motherboard;
 using gameboy::Emulatorform;
-using gameboy::Joypad;
-
+using gameboy::FramePacer;
+using gameboy::InputPollMode;
+using gameboy::JoypadInput;
+using gameboy::parse_number;
 
-using std::thread;
 using std::string;
 
 gameboy::Motherboard motherboard;
 gameboy::Emulatorform form;
-gameboy::Joypad joypad;
+gameboy::FramePacer pacer;
 
+// Get ROM path from positional arguments, or ask for it
+std::string get_rom_file_path(int argc, char *argv[])
+{
+    std::string rom_file_path;
 
+    if (argc == 2) //get file by command
+    {
+        rom_file_path = std::string(argv[1]);
+    }
+    else if (argc == 4)
+    {
+        rom_file_path = std::string(argv[3]);
+    }
+    else if (argc == 1)
+    {
+        std::cout << "Please input relative path of the ROM:" << std::endl;
+        std::cin >> rom_file_path;
+    }
+    return rom_file_path;
+}
 
 int main(int argc, char *argv[])
 {
     uint8_t scale = 1;
+    bool benchmark = false;
+    uint64_t benchmark_frames = 0;
+    uint64_t benchmark_clocks = 0;
+    uint8_t frameskip = 0;
+
+    // long options (--xxx) can go anywhere, strip them before checking positional arguments
+    int positional_argc = 0;
+    for (int i = 0; i < argc; i++)
+    {
+        std::string option = std::string(argv[i]);
+        if (i > 0 && option == "--poll-scanline")
+        {
+            motherboard.input_poll_mode = InputPollMode::poll_per_scanline;
+            continue;
+        }
+        if (i > 0 && option == "--benchmark")
+        {
+            benchmark = true;
+            continue;
+        }
+        if (i > 0 && i + 1 < argc && option == "--save-flush")
+        {
+            // seconds of emulated time, 0 only flushes on exit
+            uint64_t value;
+            if (!parse_number(argv[++i], UINT64_MAX / CLOCK_RATE, value))
+            {
+                printf("Bad value %s for %s\n", argv[i], option.c_str());
+                return 0xFE;
+            }
+            motherboard.save_flush_period = value * CLOCK_RATE;
+            continue;
+        }
+        if (i > 0 && i + 1 < argc && option == "--frameskip")
+        {
+            uint64_t value;
+            if (!parse_number(argv[++i], UINT8_MAX, value))
+            {
+                printf("Bad value %s for %s\n", argv[i], option.c_str());
+                return 0xFE;
+            }
+            frameskip = value;
+            continue;
+        }
+        if (i > 0 && i + 1 < argc && (option == "--frames" || option == "--clocks"))
+        {
+            uint64_t value;
+            if (!parse_number(argv[++i], UINT64_MAX, value))
+            {
+                printf("Bad value %s for %s\n", argv[i], option.c_str());
+                return 0xFE;
+            }
+            if (option == "--frames")
+            {
+                benchmark_frames = value;
+            }
+            else
+            {
+                benchmark_clocks = value;
+            }
+            continue;
+        }
+        argv[positional_argc++] = argv[i];
+    }
+    argc = positional_argc;
+    // benchmark runs leave the game's .sav file alone
+    motherboard.mem.cartridge.save_file_enabled = !benchmark;
 
     switch (argc)
     {
     case 1:
     {
-        if (!motherboard.power_on(argc, argv))
+        if (!motherboard.power_on(get_rom_file_path(argc, argv)))
         {
             return 0xFF;
         }
@@ -34,7 +128,7 @@ int main(int argc, char *argv[])
     }
     case 2:
     {
-        if (!motherboard.power_on(argc, argv))
+        if (!motherboard.power_on(get_rom_file_path(argc, argv)))
         {
             return 0xFF;
         }
@@ -56,7 +150,7 @@ int main(int argc, char *argv[])
             printf("Using -sf to override.\n");
             return 0xDD;
         }
-        if (!motherboard.power_on(argc, argv))
+        if (!motherboard.power_on(get_rom_file_path(argc, argv)))
         {
             return 0xFF;
         }
@@ -69,16 +163,50 @@ int main(int argc, char *argv[])
         return 0xDE;
     }
     }
+
+    motherboard.ppu.frameskip = frameskip;
+
+    if (benchmark)
+    {
+        gameboy::run_benchmark(motherboard, benchmark_frames, benchmark_clocks);
+        motherboard.power_off();
+        return 0;
+    }
+
     // create a white window
     // r:255
     // g:255
     // b:255
     form.create_window(SCREEN_WIDTH, SCREEN_HEIGHT, motherboard.mem.cartridge.rom_name, 255, 255, 255, scale);
 
-    motherboard.original_speed = motherboard.mem.cartridge.auto_optimization;
-    motherboard.running_speed = motherboard.mem.cartridge.auto_optimization;
+    // buttons held on the host, updated at each poll
+    JoypadInput input;
+    pacer.reset();
+    while (form.get_joypad_input(input))
+    {
+        motherboard.apply_input(input);
+        // fast forward runs as fast as the host can, skipped frames are not even drawn
+        motherboard.ppu.frameskip = (input.fast_forward && frameskip < FAST_FORWARD_FRAMESKIP) ? FAST_FORWARD_FRAMESKIP : frameskip;
+        if (!motherboard.run_until_poll())
+        {
+            continue;
+        }
 
-    motherboard.loop(form, joypad, scale);
+        if (motherboard.ppu.frame_rendered)
+        {
+            form.draw_frame(motherboard.ppu.frame_buffer, scale);
+            form.refresh_surface();
+        }
+        if (!input.fast_forward)
+        {
+            pacer.wait_next_frame();
+        }
+    }
+    // quick save requested in the same poll as quit
+    if (input.save_request)
+    {
+        motherboard.save();
+    }
 
 #ifdef DEBUG
     FILE *out_ram = fopen("out_ram.gbram", "w+b");
@@ -87,7 +215,8 @@ int main(int argc, char *argv[])
     printf("Memory written to out_ram.gbram.\n");
     out_ram = nullptr;
 #endif
-    // quit
+    // quit, battery RAM goes to disk before the process ends
+    motherboard.power_off();
     form.destroy_window();
     return 0;
 }
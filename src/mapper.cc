@@ -0,0 +1,426 @@
+#include "mapper.h"
+#include <cstring>
+
+using gameboy::Mapper;
+using gameboy::MapperType;
+using gameboy::Mbc1Mapper;
+using gameboy::Mbc2Mapper;
+using gameboy::Mbc3Mapper;
+using gameboy::Mbc5Mapper;
+using gameboy::RomOnlyMapper;
+using gameboy::RtcRegister;
+using gameboy::StateReader;
+using gameboy::StateWriter;
+
+// Disabled or absent RAM reads 0xFF
+static uint8_t open_bus_page[256] = {
+#define OPEN_BUS_16 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16,
+    OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16, OPEN_BUS_16
+#undef OPEN_BUS_16
+};
+
+Mapper::Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size)
+    : rom_bytes(rom_bytes), rom_bank_count(rom_bank_count), ram_bytes(ram_bytes), ram_size(ram_size)
+{
+    map_rom(0, 1);
+    map_ram(false, 0);
+}
+
+std::unique_ptr<Mapper> Mapper::create(MapperType type, const uint8_t *rom_bytes, uint16_t rom_bank_count,
+                                       uint8_t *ram_bytes, uint32_t ram_size)
+{
+    switch (type)
+    {
+    case MapperType::mapper_mbc1:
+        return std::unique_ptr<Mapper>(new Mbc1Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size));
+    case MapperType::mapper_mbc2:
+        return std::unique_ptr<Mapper>(new Mbc2Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size));
+    case MapperType::mapper_mbc3:
+        return std::unique_ptr<Mapper>(new Mbc3Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size));
+    case MapperType::mapper_mbc5:
+        return std::unique_ptr<Mapper>(new Mbc5Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size));
+    default:
+        return std::unique_ptr<Mapper>(new RomOnlyMapper(rom_bytes, rom_bank_count, ram_bytes, ram_size));
+    }
+}
+
+void Mapper::write_ram(uint16_t address, uint8_t byte)
+{
+    // RAM disabled or absent
+}
+
+void Mapper::save_state(StateWriter &writer)
+{
+    // no registers
+}
+
+bool Mapper::load_state(StateReader &reader)
+{
+    return true;
+}
+
+void Mapper::map_rom(uint16_t bank_0, uint16_t bank_1)
+{
+    rom_bank_0 = bank_0 % rom_bank_count;
+    rom_bank_1 = bank_1 % rom_bank_count;
+    rom_bank_0_bytes = &rom_bytes[rom_bank_0 * BANK_SIZE];
+    rom_bank_1_bytes = &rom_bytes[rom_bank_1 * BANK_SIZE];
+}
+
+void Mapper::map_ram(bool enabled, uint16_t bank)
+{
+    if (!enabled || ram_size == 0)
+    {
+        map_ram_page(open_bus_page);
+        return;
+    }
+    // 2 KB RAM mirrors over the whole window
+    uint32_t temp_window_size = (ram_size < CARTRIDGE_RAM_BANK_SIZE) ? ram_size : CARTRIDGE_RAM_BANK_SIZE;
+    ram_window = &ram_bytes[(bank * CARTRIDGE_RAM_BANK_SIZE) % ram_size];
+    ram_window_mask = temp_window_size - 1;
+    ram_writable = true;
+}
+
+void Mapper::map_ram_page(uint8_t *page)
+{
+    ram_window = page;
+    ram_window_mask = 0xFF;
+    ram_writable = false;
+}
+
+// ROM only
+RomOnlyMapper::RomOnlyMapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size)
+    : Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size)
+{
+    map_ram(true, 0);
+}
+
+void RomOnlyMapper::write_register(uint16_t address, uint8_t byte)
+{
+    // nothing to switch
+}
+
+// MBC1
+// 0x0000~0x1FFF RAM enable (0x0A), 0x2000~0x3FFF ROM bank bits 0~4,
+// 0x4000~0x5FFF RAM bank or ROM bank bits 5~6, 0x6000~0x7FFF banking mode
+Mbc1Mapper::Mbc1Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size)
+    : Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size)
+{
+    update();
+}
+
+void Mbc1Mapper::write_register(uint16_t address, uint8_t byte)
+{
+    switch (address >> 13)
+    {
+    case 0:
+        ram_enabled = (byte & 0x0F) == 0x0A;
+        break;
+    case 1:
+        // Values of 0 and 1 do the same thing and point to ROM bank 1.
+        bank_low = byte & 0x1F;
+        if (bank_low == 0)
+        {
+            bank_low = 1;
+        }
+        break;
+    case 2:
+        bank_high = byte & 0x03;
+        break;
+    default:
+        mode_advanced = byte & 0x01;
+        break;
+    }
+    update();
+}
+
+void Mbc1Mapper::save_state(StateWriter &writer)
+{
+    writer.put_byte(ram_enabled);
+    writer.put_byte(bank_low);
+    writer.put_byte(bank_high);
+    writer.put_byte(mode_advanced);
+}
+
+bool Mbc1Mapper::load_state(StateReader &reader)
+{
+    ram_enabled = reader.get_byte();
+    bank_low = reader.get_byte() & 0x1F;
+    // same as write_register, bank 0 can not be mapped at 0x4000
+    if (bank_low == 0)
+    {
+        bank_low = 1;
+    }
+    bank_high = reader.get_byte() & 0x03;
+    mode_advanced = reader.get_byte();
+    update();
+    return !reader.failed();
+}
+
+void Mbc1Mapper::update(void)
+{
+    uint16_t temp_bank_0 = mode_advanced ? (bank_high << 5) : 0;
+    map_rom(temp_bank_0, (bank_high << 5) | bank_low);
+    map_ram(ram_enabled, mode_advanced ? bank_high : 0);
+}
+
+// MBC2
+// 0x0000~0x3FFF: address bit 8 clear RAM enable, set ROM bank (4 bits, 0 reads as 1)
+// RAM at 0xA000~0xA1FF repeats up to 0xBFFF
+Mbc2Mapper::Mbc2Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size)
+    : Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size)
+{
+    update();
+}
+
+void Mbc2Mapper::write_register(uint16_t address, uint8_t byte)
+{
+    if (address >= 0x4000)
+    {
+        return;
+    }
+    if (address & 0x0100)
+    {
+        rom_bank = byte & 0x0F;
+        if (rom_bank == 0)
+        {
+            rom_bank = 1;
+        }
+    }
+    else
+    {
+        ram_enabled = (byte & 0x0F) == 0x0A;
+    }
+    update();
+}
+
+void Mbc2Mapper::write_ram(uint16_t address, uint8_t byte)
+{
+    if (ram_enabled && ram_size)
+    {
+        ram_bytes[address & (MBC2_RAM_SIZE - 1)] = byte | 0xF0;
+    }
+}
+
+void Mbc2Mapper::save_state(StateWriter &writer)
+{
+    writer.put_byte(ram_enabled);
+    writer.put_byte(rom_bank);
+}
+
+bool Mbc2Mapper::load_state(StateReader &reader)
+{
+    ram_enabled = reader.get_byte();
+    rom_bank = reader.get_byte() & 0x0F;
+    // same as write_register, bank 0 can not be mapped at 0x4000
+    if (rom_bank == 0)
+    {
+        rom_bank = 1;
+    }
+    update();
+    return !reader.failed();
+}
+
+void Mbc2Mapper::update(void)
+{
+    map_rom(0, rom_bank);
+    if (ram_enabled && ram_size)
+    {
+        // reads straight from RAM, writes keep the high bits set through write_ram
+        ram_window = ram_bytes;
+        ram_window_mask = MBC2_RAM_SIZE - 1;
+        ram_writable = false;
+        return;
+    }
+    map_ram(false, 0);
+}
+
+// MBC3
+// 0x0000~0x1FFF RAM and RTC enable (0x0A), 0x2000~0x3FFF ROM bank (7 bits, 0 reads as 1),
+// 0x4000~0x5FFF RAM bank (0x00~0x03) or RTC register (0x08~0x0C), 0x6000~0x7FFF latch (0x00 then 0x01)
+// The RTC counts emulated time, so runs stay reproducible
+Mbc3Mapper::Mbc3Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size)
+    : Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size)
+{
+    memset(rtc_page, 0, sizeof(rtc_page));
+    update();
+}
+
+void Mbc3Mapper::write_register(uint16_t address, uint8_t byte)
+{
+    switch (address >> 13)
+    {
+    case 0:
+        ram_enabled = (byte & 0x0F) == 0x0A;
+        break;
+    case 1:
+        rom_bank = byte & 0x7F;
+        if (rom_bank == 0)
+        {
+            rom_bank = 1;
+        }
+        break;
+    case 2:
+        ram_select = byte & 0x0F;
+        break;
+    default:
+        if (latch_last == 0x00 && byte == 0x01)
+        {
+            rtc_update();
+            memcpy(rtc_latched, rtc_live, sizeof(rtc_latched));
+        }
+        latch_last = byte;
+        break;
+    }
+    update();
+}
+
+void Mbc3Mapper::write_ram(uint16_t address, uint8_t byte)
+{
+    if (!ram_enabled || ram_select < RtcRegister::rtc_seconds || ram_select > RtcRegister::rtc_day_high)
+    {
+        return;
+    }
+    static const uint8_t rtc_masks[5] = {0x3F, 0x3F, 0x1F, 0xFF, 0xC1};
+    rtc_update();
+    rtc_live[ram_select - RtcRegister::rtc_seconds] = byte & rtc_masks[ram_select - RtcRegister::rtc_seconds];
+    if (ram_select == RtcRegister::rtc_seconds)
+    {
+        // writing seconds restarts the second
+        rtc_clock = get_clock();
+    }
+}
+
+uint64_t Mbc3Mapper::get_clock(void)
+{
+    return clock ? *clock : 0;
+}
+
+void Mbc3Mapper::rtc_update(void)
+{
+    uint64_t temp_now = get_clock();
+    if (temp_now < rtc_clock || (rtc_live[4] & 0x40))
+    {
+        // halted, or the clock went back (new power on)
+        rtc_clock = temp_now;
+        return;
+    }
+    uint64_t temp_seconds = (temp_now - rtc_clock) / RTC_CLOCKS_PER_SECOND;
+    if (temp_seconds == 0)
+    {
+        return;
+    }
+    rtc_clock += temp_seconds * RTC_CLOCKS_PER_SECOND;
+
+    uint64_t temp_total = rtc_live[0] + 60 * rtc_live[1] + 3600 * rtc_live[2] + temp_seconds;
+    uint64_t temp_days = (((rtc_live[4] & 0x01) << 8) | rtc_live[3]) + temp_total / 86400;
+    temp_total %= 86400;
+    rtc_live[0] = temp_total % 60;
+    rtc_live[1] = (temp_total / 60) % 60;
+    rtc_live[2] = temp_total / 3600;
+    if (temp_days > 0x1FF)
+    {
+        // day counter overflow, the carry stays until the game clears it
+        rtc_live[4] |= 0x80;
+        temp_days &= 0x1FF;
+    }
+    rtc_live[3] = temp_days & 0xFF;
+    rtc_live[4] = (rtc_live[4] & 0xFE) | ((temp_days >> 8) & 0x01);
+}
+
+void Mbc3Mapper::save_state(StateWriter &writer)
+{
+    writer.put_byte(ram_enabled);
+    writer.put_byte(rom_bank);
+    writer.put_byte(ram_select);
+    writer.put_byte(latch_last);
+    writer.put_bytes(rtc_live, sizeof(rtc_live));
+    writer.put_bytes(rtc_latched, sizeof(rtc_latched));
+    writer.put_qword(rtc_clock);
+}
+
+bool Mbc3Mapper::load_state(StateReader &reader)
+{
+    ram_enabled = reader.get_byte();
+    rom_bank = reader.get_byte() & 0x7F;
+    // same as write_register, bank 0 can not be mapped at 0x4000
+    if (rom_bank == 0)
+    {
+        rom_bank = 1;
+    }
+    ram_select = reader.get_byte() & 0x0F;
+    latch_last = reader.get_byte();
+    reader.get_bytes(rtc_live, sizeof(rtc_live));
+    reader.get_bytes(rtc_latched, sizeof(rtc_latched));
+    rtc_clock = reader.get_qword();
+    update();
+    return !reader.failed();
+}
+
+void Mbc3Mapper::update(void)
+{
+    map_rom(0, rom_bank);
+    if (ram_enabled && ram_select >= RtcRegister::rtc_seconds && ram_select <= RtcRegister::rtc_day_high)
+    {
+        memset(rtc_page, rtc_latched[ram_select - RtcRegister::rtc_seconds], sizeof(rtc_page));
+        map_ram_page(rtc_page);
+        return;
+    }
+    map_ram(ram_enabled && ram_select <= 0x03, ram_select);
+}
+
+// MBC5
+// 0x0000~0x1FFF RAM enable (0x0A), 0x2000~0x2FFF ROM bank bits 0~7, 0x3000~0x3FFF ROM bank bit 8,
+// 0x4000~0x5FFF RAM bank (4 bits)
+Mbc5Mapper::Mbc5Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size)
+    : Mapper(rom_bytes, rom_bank_count, ram_bytes, ram_size)
+{
+    update();
+}
+
+void Mbc5Mapper::write_register(uint16_t address, uint8_t byte)
+{
+    switch (address >> 12)
+    {
+    case 0:
+    case 1:
+        ram_enabled = (byte & 0x0F) == 0x0A;
+        break;
+    case 2:
+        rom_bank = (rom_bank & 0x100) | byte;
+        break;
+    case 3:
+        rom_bank = (rom_bank & 0xFF) | ((byte & 0x01) << 8);
+        break;
+    case 4:
+    case 5:
+        ram_bank = byte & 0x0F;
+        break;
+    default:
+        break;
+    }
+    update();
+}
+
+void Mbc5Mapper::save_state(StateWriter &writer)
+{
+    writer.put_byte(ram_enabled);
+    writer.put_word(rom_bank);
+    writer.put_byte(ram_bank);
+}
+
+bool Mbc5Mapper::load_state(StateReader &reader)
+{
+    ram_enabled = reader.get_byte();
+    rom_bank = reader.get_word() & 0x1FF;
+    ram_bank = reader.get_byte() & 0x0F;
+    update();
+    return !reader.failed();
+}
+
+void Mbc5Mapper::update(void)
+{
+    map_rom(0, rom_bank);
+    map_ram(ram_enabled, ram_bank);
+}
@@ -0,0 +1,183 @@
+// Memory bank controllers
+// A mapper turns writes to 0x0000~0x7FFF into bank numbers and keeps the host
+// pointers of the banks mapped now. A bank write swaps those pointers once,
+// Memory::map_cartridge_pages copies them into the page tables, and reads stay
+// page pointer + offset. Writes to cartridge RAM go straight to the RAM page
+// unless the mapper has to see them (RTC registers, MBC2 nibbles, RAM disabled).
+
+#ifndef GAMEBOY_MAPPER_H
+#define GAMEBOY_MAPPER_H
+
+#include "save-state.h"
+#include <cstdint>
+#include <memory>
+
+#define BANK_SIZE 0x4000
+// 0xA000~0xBFFF
+#define CARTRIDGE_RAM_START_ADDRESS 0xA000
+#define CARTRIDGE_RAM_END_ADDRESS 0xBFFF
+#define CARTRIDGE_RAM_BANK_SIZE 0x2000
+// MBC2 RAM: 512 x 4 bits
+#define MBC2_RAM_SIZE 512
+// RTC seconds in 4 MHz clocks
+#define RTC_CLOCKS_PER_SECOND 4194304
+
+namespace gameboy
+{
+
+// Prefix mapper_ means memory bank controller
+enum MapperType
+{
+    mapper_rom_only = 0, // 32 KB, optional 8 KB RAM
+    mapper_mbc1 = 1,     // up to 2 MB ROM, 32 KB RAM
+    mapper_mbc2 = 2,     // up to 256 KB ROM, 512 x 4 bits RAM
+    mapper_mbc3 = 3,     // up to 2 MB ROM, 32 KB RAM, real time clock
+    mapper_mbc5 = 5      // up to 8 MB ROM, 128 KB RAM
+};
+
+class Mapper
+{
+public:
+    // rom_bytes holds rom_bank_count banks, ram_bytes ram_size bytes (may be 0)
+    Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size);
+    virtual ~Mapper() = default;
+
+    // Mapper of a cartridge type
+    static std::unique_ptr<Mapper> create(MapperType type, const uint8_t *rom_bytes, uint16_t rom_bank_count,
+                                          uint8_t *ram_bytes, uint32_t ram_size);
+
+    // Write to 0x0000~0x7FFF
+    virtual void write_register(uint16_t address, uint8_t byte) = 0;
+    // Write to 0xA000~0xBFFF while ram_writable is false
+    virtual void write_ram(uint16_t address, uint8_t byte);
+
+    // Save states: the bank registers, the banks are mapped again from them
+    virtual void save_state(StateWriter &writer);
+    virtual bool load_state(StateReader &reader);
+
+    // Mapped now, bank numbers are the block cache keys
+    const uint8_t *rom_bank_0_bytes = nullptr; // 0x0000~0x3FFF
+    const uint8_t *rom_bank_1_bytes = nullptr; // 0x4000~0x7FFF
+    uint16_t rom_bank_0 = 0;
+    uint16_t rom_bank_1 = 1;
+    // 0xA000~0xBFFF, page n reads ram_window + ((n << 8) & ram_window_mask)
+    uint8_t *ram_window = nullptr;
+    uint16_t ram_window_mask = 0;
+    bool ram_writable = false;
+
+    // Emulated time for the real time clock (Scheduler::now), nullptr stops it
+    const uint64_t *clock = nullptr;
+
+protected:
+    const uint8_t *rom_bytes;
+    uint16_t rom_bank_count;
+    uint8_t *ram_bytes;
+    uint32_t ram_size;
+
+    // Banks past the end wrap around, the unused bank bits are not wired
+    void map_rom(uint16_t bank_0, uint16_t bank_1);
+    // RAM bank of CARTRIDGE_RAM_BANK_SIZE, or open bus when disabled or absent
+    void map_ram(bool enabled, uint16_t bank);
+    // Reads of 0xA000~0xBFFF see page (256 bytes), writes go to write_ram
+    void map_ram_page(uint8_t *page);
+};
+
+// No controller, RAM (if any) always enabled
+class RomOnlyMapper : public Mapper
+{
+public:
+    RomOnlyMapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size);
+    void write_register(uint16_t address, uint8_t byte);
+};
+
+class Mbc1Mapper : public Mapper
+{
+public:
+    Mbc1Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size);
+    void write_register(uint16_t address, uint8_t byte);
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
+private:
+    bool ram_enabled = false;
+    uint8_t bank_low = 1;  // 0x2000~0x3FFF, 5 bits, 0 reads as 1
+    uint8_t bank_high = 0; // 0x4000~0x5FFF, 2 bits
+    // 0x6000~0x7FFF: bank_high also selects the RAM bank and the bank at 0x0000
+    bool mode_advanced = false;
+    void update(void);
+};
+
+class Mbc2Mapper : public Mapper
+{
+public:
+    Mbc2Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size);
+    void write_register(uint16_t address, uint8_t byte);
+    // Only the low 4 bits are stored, the high ones read as 1
+    void write_ram(uint16_t address, uint8_t byte);
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
+private:
+    bool ram_enabled = false;
+    uint8_t rom_bank = 1;
+    void update(void);
+};
+
+// Prefix rtc_ means real time clock register, the number is the select value
+enum RtcRegister
+{
+    rtc_seconds = 0x08,
+    rtc_minutes = 0x09,
+    rtc_hours = 0x0A,
+    rtc_day_low = 0x0B,
+    rtc_day_high = 0x0C // bit 0: day bit 8, bit 6: halt, bit 7: day carry
+};
+
+class Mbc3Mapper : public Mapper
+{
+public:
+    Mbc3Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size);
+    void write_register(uint16_t address, uint8_t byte);
+    // RTC register writes
+    void write_ram(uint16_t address, uint8_t byte);
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
+private:
+    bool ram_enabled = false;
+    uint8_t rom_bank = 1;
+    // 0x00~0x03 RAM bank, 0x08~0x0C RTC register
+    uint8_t ram_select = 0;
+    uint8_t latch_last = 0xFF;
+
+    // S M H DL DH counting, up to date at rtc_clock
+    uint8_t rtc_live[5] = {0};
+    // copied from rtc_live by a 0x00 0x01 latch, what the game reads
+    uint8_t rtc_latched[5] = {0};
+    uint64_t rtc_clock = 0;
+    // the selected latched register over a whole page
+    uint8_t rtc_page[256];
+
+    uint64_t get_clock(void);
+    // Add the whole seconds since rtc_clock to rtc_live
+    void rtc_update(void);
+    void update(void);
+};
+
+class Mbc5Mapper : public Mapper
+{
+public:
+    Mbc5Mapper(const uint8_t *rom_bytes, uint16_t rom_bank_count, uint8_t *ram_bytes, uint32_t ram_size);
+    void write_register(uint16_t address, uint8_t byte);
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
+private:
+    bool ram_enabled = false;
+    uint16_t rom_bank = 1; // 9 bits, bank 0 can be mapped at 0x4000
+    uint8_t ram_bank = 0;
+    void update(void);
+};
+} // namespace gameboy
+
+#endif
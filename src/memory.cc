@@ -1,50 +1,167 @@
 #include "memory.h"
+#include "ppu.h"
+using gameboy::EventName;
+using gameboy::Mapper;
 using gameboy::Memory;
+using gameboy::StateReader;
+using gameboy::StateWriter;
 
-// Getter and setter for memory (8-bit version)
-// Generally used to exchange data with 8-bit registers
-uint8_t Memory::get_memory_byte(uint16_t address)
+// Read by the page tables before a cartridge is loaded
+static uint8_t empty_rom_page[1 << PAGE_SHIFT];
+
+void Memory::map_pages(void)
 {
-    if (address <= 0x7fff) // 32 KB leading cartridge space
+    for (int page = 0; page < PAGE_COUNT; page++)
+    {
+        read_page[page] = &memory_byte[page << PAGE_SHIFT];
+        write_page[page] = &memory_byte[page << PAGE_SHIFT];
+    }
+
+    // 32 KB leading cartridge space, writes go to MBC registers
+    for (int page = 0; page < (0x8000 >> PAGE_SHIFT); page++)
+    {
+        write_page[page] = nullptr;
+    }
+    map_cartridge_pages();
+
+    // Echo RAM: 0xE000~0xFDFF mirrors 0xC000~0xDDFF
+    for (int page = (0xE000 >> PAGE_SHIFT); page < (0xFE00 >> PAGE_SHIFT); page++)
+    {
+        read_page[page] = &memory_byte[(page - 0x20) << PAGE_SHIFT];
+        write_page[page] = &memory_byte[(page - 0x20) << PAGE_SHIFT];
+    }
+
+    // tile data, the tile cache needs to know
+    for (int page = (TILE_DATA_START_ADDRESS >> PAGE_SHIFT); page <= (TILE_DATA_END_ADDRESS >> PAGE_SHIFT); page++)
     {
-        return (cartridge.get_cartridge_byte(address));
+        write_page[page] = nullptr;
     }
-    return memory_byte[address];
+
+    // OAM and I/O registers
+    write_page[0xFE] = nullptr;
+    write_page[0xFF] = nullptr;
 }
 
-void Memory::set_memory_byte(uint16_t address, uint8_t byte)
+void Memory::map_cartridge_pages(void)
 {
-    if (address <= 0x7fff) // 32 KB leading cartridge space
+    Mapper *temp_mapper = cartridge.mapper.get();
+    if (!temp_mapper)
     {
-        cartridge.set_cartridge_byte(address, byte);
+        // no cartridge yet: empty ROM, 0xA000~0xBFFF stays plain memory
+        for (int page = 0; page < (0x8000 >> PAGE_SHIFT); page++)
+        {
+            read_page[page] = empty_rom_page;
+        }
+        for (int page = (CARTRIDGE_RAM_START_ADDRESS >> PAGE_SHIFT); page <= (CARTRIDGE_RAM_END_ADDRESS >> PAGE_SHIFT); page++)
+        {
+            read_page[page] = &memory_byte[page << PAGE_SHIFT];
+            write_page[page] = &memory_byte[page << PAGE_SHIFT];
+        }
+        mapped_rom_bank[0] = 0;
+        mapped_rom_bank[1] = 1;
         return;
     }
-    memory_byte[address] = byte;
+
+    // the image is shared and read only: ROM write pages stay nullptr, so the
+    // const_cast pages are only ever read
+    for (int page = 0; page < (BANK_SIZE >> PAGE_SHIFT); page++)
+    {
+        read_page[page] = const_cast<uint8_t *>(&temp_mapper->rom_bank_0_bytes[page << PAGE_SHIFT]);
+        read_page[page + (BANK_SIZE >> PAGE_SHIFT)] = const_cast<uint8_t *>(&temp_mapper->rom_bank_1_bytes[page << PAGE_SHIFT]);
+    }
+    mapped_rom_bank[0] = temp_mapper->rom_bank_0;
+    mapped_rom_bank[1] = temp_mapper->rom_bank_1;
+
+    for (int page = (CARTRIDGE_RAM_START_ADDRESS >> PAGE_SHIFT); page <= (CARTRIDGE_RAM_END_ADDRESS >> PAGE_SHIFT); page++)
+    {
+        uint8_t *temp_page = &temp_mapper->ram_window[(page << PAGE_SHIFT) & temp_mapper->ram_window_mask];
+        read_page[page] = temp_page;
+        write_page[page] = temp_mapper->ram_writable ? temp_page : nullptr;
+    }
 }
 
-// Getter and setter for memory (16-bit version)
-// Used with 16-bit registers
-// Little Endian
-uint16_t Memory::get_memory_word(uint16_t address)
+// Address ranges in save states
+static const uint16_t state_ranges[3][2] = {
+    {0x8000, 0xA000}, // VRAM
+    {0xC000, 0xE000}, // WRAM
+    {0xFE00, 0x0000}, // OAM, unusable, I/O registers, HRAM, IE (to the end)
+};
+
+void Memory::save_state(StateWriter &writer)
 {
-    if (address <= 0x7fff) // 32 KB leading cartridge space
+    for (int i = 0; i < 3; i++)
+    {
+        uint32_t temp_end = state_ranges[i][1] ? state_ranges[i][1] : 0x10000;
+        writer.put_bytes(&memory_byte[state_ranges[i][0]], temp_end - state_ranges[i][0]);
+    }
+}
+
+bool Memory::load_state(StateReader &reader)
+{
+    for (int i = 0; i < 3; i++)
     {
-        return (cartridge.get_cartridge_word(address));
+        uint32_t temp_end = state_ranges[i][1] ? state_ranges[i][1] : 0x10000;
+        reader.get_bytes(&memory_byte[state_ranges[i][0]], temp_end - state_ranges[i][0]);
     }
-    uint16_t byte_low = (memory_byte[address] & 0xffff);
-    uint16_t byte_high = ((memory_byte[address + 1] << 8) & 0xffff);
-    return (byte_low | byte_high);
+    // decoded copies of VRAM and OAM
+    tile_cache.invalidate_all();
+    oam_dirty = true;
+    return !reader.failed();
 }
 
-void Memory::set_memory_word(uint16_t address, uint16_t word)
+void Memory::write_slow_byte(uint16_t address, uint8_t byte)
 {
     if (address <= 0x7fff) // 32 KB leading cartridge space
     {
-        cartridge.set_cartridge_word(address, word);
+        if (cartridge.write_register(address, byte))
+        {
+            map_cartridge_pages();
+        }
+        return;
+    }
+    if (address >= CARTRIDGE_RAM_START_ADDRESS && address <= CARTRIDGE_RAM_END_ADDRESS)
+    {
+        // RTC registers, MBC2 nibbles or disabled RAM
+        cartridge.write_ram(address, byte);
+        return;
+    }
+    if (address >= TILE_DATA_START_ADDRESS && address <= TILE_DATA_END_ADDRESS)
+    {
+        if (memory_byte[address] != byte)
+        {
+            memory_byte[address] = byte;
+            tile_cache.invalidate(address);
+        }
         return;
     }
-    uint8_t byte_low = (word & 0xff);
-    uint8_t byte_high = ((word >> 8) & 0xff);
-    memory_byte[address] = byte_low;
-    memory_byte[address + 1] = byte_high;
+    if (address >= OAM_TABLE_INITIAL_ADDDRESS && address < OAM_TABLE_INITIAL_ADDDRESS + OAM_TABLE_SIZE)
+    {
+        memory_byte[address] = byte;
+        oam_dirty = true;
+        return;
+    }
+    if (address == DMA_ADDRESS) // OAM DMA
+    {
+        // copy 0xA0 bytes from byte * 0x100, the source never crosses a page
+        memory_byte[address] = byte;
+        memcpy(&memory_byte[OAM_TABLE_INITIAL_ADDDRESS], read_page[byte], OAM_TABLE_SIZE);
+        oam_dirty = true;
+        return;
+    }
+    if (address == JOYPAD_ADDRESS) // game selects a key column
+    {
+        memory_byte[address] = joypad.select_column(byte);
+        return;
+    }
+    if (address == 0xFF04 || address == 0xFF07) // DIV reset or TAC change
+    {
+        // writing any value to DIV resets it
+        memory_byte[address] = (address == 0xFF04) ? 0x00 : byte;
+        if (scheduler)
+        {
+            scheduler->schedule(EventName::event_timer_write, scheduler->now);
+        }
+        return;
+    }
+    memory_byte[address] = byte;
 }
@@ -3,7 +3,16 @@
 #ifndef GAMEBOY_MEMORY_H
 #define GAMEBOY_MEMORY_H
 #include "cartridge.h"
+#include "joypad.h"
+#include "scheduler.h"
+#include "tile-cache.h"
 #include <cstdint>
+#include <cstring>
+
+// 256 pages of 256 bytes cover the address bus
+#define PAGE_COUNT 256
+#define PAGE_SHIFT 8
+#define PAGE_MASK 0xFF
 
 namespace gameboy
 {
@@ -11,18 +20,91 @@ namespace gameboy
 class Memory
 {
 public:
+    Memory()
+    {
+        tile_cache.tile_data = &memory_byte[TILE_DATA_START_ADDRESS];
+        map_pages();
+    }
+    // page tables point into this object
+    Memory(const Memory &) = delete;
+    Memory &operator=(const Memory &) = delete;
+
     gameboy::Cartridge cartridge;
+    gameboy::Joypad joypad;
     uint8_t memory_byte[65536]; // Entire Address Bus: 64 KB
 
+    // Decoded 0x8000~0x97FF, kept up to date by write_slow_byte
+    gameboy::TileCache tile_cache;
+    // OAM changed since the PPU decoded it
+    bool oam_dirty = true;
+    // Writes through set_memory_byte so far, the CPU idle loop detection compares it
+    uint64_t write_count = 0;
+
+    // Set by the motherboard, IO writes that move device deadlines notify it
+    gameboy::Scheduler *scheduler = nullptr;
+
+    // Host pointer of each 256-byte page
+    // Reads always go through read_page
+    // A nullptr in write_page sends the write to write_slow_byte:
+    // cartridge (MBC registers, RAM the mapper has to see), tile data, OAM and I/O registers
+    uint8_t *read_page[PAGE_COUNT];
+    uint8_t *write_page[PAGE_COUNT];
+
+    // Map every page, called on construction
+    void map_pages(void);
+    // Remap 0x0000~0x7FFF and 0xA000~0xBFFF from the cartridge mapper,
+    // called after loading a cartridge and after a bank switch
+    void map_cartridge_pages(void);
+    // ROM bank currently mapped at address (0x0000~0x7FFF)
+    uint16_t get_mapped_rom_bank(uint16_t address)
+    {
+        return mapped_rom_bank[(address >> 14) & 1];
+    }
+
+    // Save states: VRAM, WRAM, OAM, I/O registers and HRAM
+    // ROM, cartridge RAM and the echo of WRAM are not part of it
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
     // Getter and setter for memory (8-bit version)
     // Generally used to exchange data with 8-bit registers
-    uint8_t get_memory_byte(uint16_t address);
-    void set_memory_byte(uint16_t address, uint8_t byte);
+    uint8_t get_memory_byte(uint16_t address)
+    {
+        return read_page[address >> PAGE_SHIFT][address & PAGE_MASK];
+    }
+    void set_memory_byte(uint16_t address, uint8_t byte)
+    {
+        write_count++;
+        uint8_t *temp_page = write_page[address >> PAGE_SHIFT];
+        if (temp_page)
+        {
+            temp_page[address & PAGE_MASK] = byte;
+            return;
+        }
+        write_slow_byte(address, byte);
+    }
 
     // Getter and setter for memory (16-bit version)
     // Used with 16-bit registers
-    uint16_t get_memory_word(uint16_t address);
-    void set_memory_word(uint16_t address, uint16_t word);
+    // Little Endian, the two bytes may sit in different pages
+    uint16_t get_memory_word(uint16_t address)
+    {
+        uint16_t byte_low = get_memory_byte(address);
+        uint16_t byte_high = get_memory_byte(address + 1);
+        return (byte_low | (byte_high << 8));
+    }
+    void set_memory_word(uint16_t address, uint16_t word)
+    {
+        set_memory_byte(address, word & 0xff);
+        set_memory_byte(address + 1, (word >> 8) & 0xff);
+    }
+
+private:
+    // Banks currently mapped to 0x0000~0x3FFF and 0x4000~0x7FFF
+    uint16_t mapped_rom_bank[2] = {0, 1};
+
+    // Writes with side effects
+    void write_slow_byte(uint16_t address, uint8_t byte);
 };
 } // namespace gameboy
 
@@ -2,43 +2,24 @@
 
 using gameboy::Cartridge;
 using gameboy::Cpu;
+using gameboy::EventName;
 using gameboy::FlagName;
+using gameboy::JoypadInput;
 using gameboy::Memory;
 using gameboy::Motherboard;
 using gameboy::Register;
 using gameboy::RegisterName;
+using gameboy::StateReader;
+using gameboy::StateWriter;
 
 using std::cout;
 using std::endl;
 using std::hex;
 
-using std::this_thread::sleep_for;
-
-using std::milli;
-using std::chrono::duration;
-using std::chrono::high_resolution_clock;
-using std::chrono::milliseconds;
-
-bool Motherboard::power_on(int argc, char *argv[])
+bool Motherboard::power_on(std::string rom_file_path)
 {
     cpu.power_on();
 
-    std::string rom_file_path;
-
-    if (argc == 2) //get file by command
-    {
-        rom_file_path = std::string(argv[1]);
-    }
-    else if (argc == 4)
-    {
-        rom_file_path = std::string(argv[3]);
-    }
-    else if (argc == 1)
-    {
-        std::cout << "Please input relative path of the ROM:" << std::endl;
-        std::cin >> rom_file_path;
-    }
-
     // init RAM to 0x00
     // Please note that GameBoy internal RAM on power up contains random data.
     // All of the GameBoy emulators tend to set all RAM to value $00 on entry.
@@ -52,6 +33,8 @@ bool Motherboard::power_on(int argc, char *argv[])
     {
         return false;
     }
+    // ROM and RAM pages point into the cartridge just loaded
+    mem.map_cartridge_pages();
 
     mem.set_memory_byte(0xFF05, 0x00);
     mem.set_memory_byte(0xFF06, 0x00);
@@ -85,55 +68,262 @@ bool Motherboard::power_on(int argc, char *argv[])
     mem.set_memory_byte(0xFF4B, 0x00);
     mem.set_memory_byte(0xFFFF, 0x00);
 
+    last_polled_line = mem.get_memory_byte(LY_ADDRESS);
+    schedule_devices();
+
     return true;
 }
 
-void Motherboard::loop(Emulatorform &form, Joypad &joypad, uint8_t scale)
+bool Motherboard::run_until_poll(void)
 {
-    while (true)
+    while (!input_due)
     {
-        if (form.get_joypad_input(joypad, mem))
+        // nothing but the CPU changes state before the next deadline
+        cpu.run(mem, scheduler.now, scheduler.next_cycle);
+
+        EventName name;
+        while (scheduler.pop_due(name))
         {
-            uint8_t cpu_cycle = cpu.next(mem);
-            ppu.ppu_main(4 * cpu_cycle, running_speed, mem, form, scale);
-            timer.add_time(4 * cpu_cycle, mem);
-            //if(SDL_GetTicks()-fps_timer < FPS && ppu.ready_to_refresh)
-            if(ppu.ready_to_refresh)
-            {
-                ppu.ready_to_refresh = form.refresh_surface();
-                //SDL_Delay(FPS-SDL_GetTicks()+fps_timer);
-            }
-            //fps_timer=SDL_GetTicks();
-            if (joypad.save_flag)
-            {
-                save();
-                joypad.save_flag = 0;
-            }
-            if (joypad.load_flag)
-            {
-                load();
-                joypad.load_flag = 0;
-            }
-            if (joypad.fast_forward_flag)
-            {
-                fast_forward();
-                joypad.fast_forward_flag = 0;
-            }
-            else
+            handle_event(name);
+        }
+    }
+    input_due = false;
+
+    bool temp_frame_ready = ppu.ready_to_refresh;
+    ppu.ready_to_refresh = false;
+    return temp_frame_ready;
+}
+
+void Motherboard::schedule_devices(void)
+{
+    // PPU starts in H-Blank of line 0
+    scheduler.schedule(EventName::event_ppu_mode, scheduler.now + DOTS_HBLANK);
+    // DIV and TIMA
+    scheduler.schedule(EventName::event_timer_write, scheduler.now);
+    // battery RAM
+    if (mem.cartridge.save_ram.is_persistent() && save_flush_period)
+    {
+        scheduler.schedule(EventName::event_save_flush, scheduler.now + save_flush_period);
+    }
+}
+
+void Motherboard::handle_event(EventName name)
+{
+    switch (name)
+    {
+    case EventName::event_ppu_mode:
+    {
+        // 1 dot == 1 clock, a frame is CLOCKS_PER_FRAME
+        uint16_t temp_dots = ppu.next_mode(mem);
+        scheduler.schedule(EventName::event_ppu_mode, scheduler.event_cycle + temp_dots);
+
+        if (ppu.ready_to_refresh)
+        {
+            input_due = true;
+        }
+
+        if (input_poll_mode == InputPollMode::poll_per_scanline)
+        {
+            uint8_t ly_byte = mem.memory_byte[LY_ADDRESS];
+            if (ly_byte != last_polled_line)
             {
-                running_speed = original_speed;
+                last_polled_line = ly_byte;
+                input_due = true;
             }
         }
+        return;
+    }
+    case EventName::event_div_tick:
+        timer.div_tick(mem);
+        scheduler.schedule(EventName::event_div_tick, scheduler.event_cycle + DIV_PERIOD);
+        return;
+    case EventName::event_timer_tick:
+    {
+        timer.tima_tick(mem);
+        uint16_t temp_period = timer.tima_period(mem);
+        if (temp_period)
+        {
+            scheduler.schedule(EventName::event_timer_tick, scheduler.event_cycle + temp_period);
+        }
+        return;
+    }
+    case EventName::event_timer_write:
+    {
+        // DIV was reset or TAC changed, restart both counters from now
+        scheduler.schedule(EventName::event_div_tick, scheduler.now + DIV_PERIOD);
+        uint16_t temp_period = timer.tima_period(mem);
+        if (temp_period)
+        {
+            scheduler.schedule(EventName::event_timer_tick, scheduler.now + temp_period);
+        }
         else
         {
-            if (joypad.save_flag)
-            {
-                save();
-                joypad.save_flag = 0;
-            }
+            scheduler.cancel(EventName::event_timer_tick);
+        }
+        return;
+    }
+    case EventName::event_save_flush:
+        // the writes are already in the page cache, only start writing them to disk
+        mem.cartridge.save_ram.flush(false);
+        scheduler.schedule(EventName::event_save_flush, scheduler.event_cycle + save_flush_period);
+        return;
+    default:
+        return;
+    }
+}
+
+void Motherboard::apply_input(JoypadInput &input)
+{
+    mem.joypad.keys_directions = input.keys_directions;
+    mem.joypad.keys_controls = input.keys_controls;
+    mem.joypad.write_result(mem);
+
+    if (input.save_request)
+    {
+        save();
+        input.save_request = false;
+    }
+    if (input.load_request)
+    {
+        load();
+        input.load_request = false;
+    }
+}
+
+void Motherboard::power_off(void)
+{
+    mem.cartridge.save_ram.flush(true);
+}
+
+void Motherboard::save_state(std::vector<uint8_t> &state)
+{
+    state.clear();
+    state.reserve(SAVE_STATE_HEADER_SIZE + 0x4400 + mem.cartridge.ram_size + 0x100);
+    StateWriter writer(state);
+    writer.put_bytes((const uint8_t *)SAVE_STATE_MAGIC, 4);
+    writer.put_word(SAVE_STATE_VERSION);
+    writer.put_word(SAVE_STATE_HEADER_SIZE);
+    writer.put_dword(mem.cartridge.get_rom_checksum());
+
+    writer.begin_chunk("CPU ");
+    cpu.save_state(writer);
+    writer.end_chunk();
+    writer.begin_chunk("SCHD");
+    scheduler.save_state(writer);
+    writer.end_chunk();
+    writer.begin_chunk("PPU ");
+    ppu.save_state(writer);
+    writer.end_chunk();
+    writer.begin_chunk("MEM ");
+    mem.save_state(writer);
+    writer.end_chunk();
+    writer.begin_chunk("JOYP");
+    mem.joypad.save_state(writer);
+    writer.put_byte(last_polled_line);
+    writer.end_chunk();
+    writer.begin_chunk("CART");
+    mem.cartridge.save_state(writer);
+    writer.end_chunk();
+}
+
+bool Motherboard::load_state(const uint8_t *state, size_t size)
+{
+    StateReader reader(state, size);
+    char temp_magic[4];
+    reader.get_bytes((uint8_t *)temp_magic, 4);
+    uint16_t temp_version = reader.get_word();
+    uint16_t temp_header_size = reader.get_word();
+    uint32_t temp_checksum = reader.get_dword();
+    if (reader.failed() || memcmp(temp_magic, SAVE_STATE_MAGIC, 4) != 0)
+    {
+        printf("Not a save state.\n");
+        return false;
+    }
+    if (temp_version != SAVE_STATE_VERSION)
+    {
+        printf("Save state version %d not supported.\n", temp_version);
+        return false;
+    }
+    if (temp_checksum != mem.cartridge.get_rom_checksum())
+    {
+        printf("Save state of another ROM.\n");
+        return false;
+    }
+    if (temp_header_size < SAVE_STATE_HEADER_SIZE || temp_header_size > size)
+    {
+        printf("Save state header broken.\n");
+        return false;
+    }
+    reader.position = temp_header_size;
+
+    // a broken chunk puts the machine back as it was
+    std::vector<uint8_t> temp_backup;
+    save_state(temp_backup);
+
+    // every chunk exactly once, in any order; a missing one would keep part of the running machine
+    static const char chunk_ids[SAVE_STATE_CHUNK_COUNT][5] = {"CPU ", "SCHD", "PPU ", "MEM ", "JOYP", "CART"};
+    uint32_t temp_chunks_seen = 0;
+    bool temp_ok = true;
+    char temp_id[4];
+    StateReader chunk(nullptr, 0);
+    while (temp_ok && reader.next_chunk(temp_id, chunk))
+    {
+        int temp_index = 0;
+        while (temp_index < SAVE_STATE_CHUNK_COUNT && memcmp(temp_id, chunk_ids[temp_index], 4) != 0)
+        {
+            temp_index++;
+        }
+        if (temp_index == SAVE_STATE_CHUNK_COUNT)
+        {
+            // newer chunk, not needed by this version
+            continue;
+        }
+        if (temp_chunks_seen & (1 << temp_index))
+        {
+            temp_ok = false;
+            break;
+        }
+        temp_chunks_seen |= 1 << temp_index;
+
+        switch (temp_index)
+        {
+        case 0:
+            temp_ok = cpu.load_state(chunk);
+            break;
+        case 1:
+            temp_ok = scheduler.load_state(chunk);
+            break;
+        case 2:
+            temp_ok = ppu.load_state(chunk);
+            break;
+        case 3:
+            temp_ok = mem.load_state(chunk);
+            break;
+        case 4:
+            temp_ok = mem.joypad.load_state(chunk);
+            last_polled_line = chunk.get_byte();
+            temp_ok = temp_ok && !chunk.failed();
+            break;
+        default:
+            temp_ok = mem.cartridge.load_state(chunk);
+            mem.map_cartridge_pages();
             break;
         }
     }
+    if (!temp_ok || reader.failed() || temp_chunks_seen != (1 << SAVE_STATE_CHUNK_COUNT) - 1)
+    {
+        printf("Save state broken, not loaded.\n");
+        load_state(temp_backup.data(), temp_backup.size());
+        return false;
+    }
+
+    // the state may come from a run without a .sav file
+    if (mem.cartridge.save_ram.is_persistent() && save_flush_period &&
+        !scheduler.pending(EventName::event_save_flush))
+    {
+        scheduler.schedule(EventName::event_save_flush, scheduler.now + save_flush_period);
+    }
+    return true;
 }
 
 void Motherboard::save(void)
@@ -141,14 +331,18 @@ void Motherboard::save(void)
     char name_buffer[25];
     strcpy(name_buffer, mem.cartridge.rom_name);
     strcat(name_buffer, ".gbsave");
-    FILE *save_out = fopen(name_buffer, "w+b");
-    fwrite(mem.memory_byte, sizeof(uint8_t), 0x10000, save_out);
-    printf("Memory written to %s.\n", name_buffer);
-    fwrite(cpu.reg.register_byte, sizeof(uint8_t), 0x08, save_out);
-    fwrite(cpu.reg.register_word, sizeof(uint16_t), 0x02, save_out);
-    printf("Registers written to %s.\n", name_buffer);
+    std::vector<uint8_t> temp_state;
+    save_state(temp_state);
+    FILE *save_out = fopen(name_buffer, "wb");
+    if (!save_out)
+    {
+        printf("cannot write %s.\n", name_buffer);
+        return;
+    }
+    fwrite(temp_state.data(), sizeof(uint8_t), temp_state.size(), save_out);
     fclose(save_out);
     save_out = nullptr;
+    printf("State written to %s (%u bytes).\n", name_buffer, (unsigned)temp_state.size());
     printf("Successfully quick saved.\n\n");
 }
 
@@ -157,20 +351,25 @@ void Motherboard::load(void)
     char name_buffer[25];
     strcpy(name_buffer, mem.cartridge.rom_name);
     strcat(name_buffer, ".gbsave");
-    FILE *save_in = fopen(name_buffer, "r+b");
-    fread(mem.memory_byte, sizeof(uint8_t), 0x10000, save_in);
-    printf("Memory restored from %s.\n", name_buffer);
-    fread(cpu.reg.register_byte, sizeof(uint8_t), 0x08, save_in);
-    fread(cpu.reg.register_word, sizeof(uint16_t), 0x02, save_in);
-    printf("Registers restored from %s.\n", name_buffer);
+    FILE *save_in = fopen(name_buffer, "rb");
+    if (!save_in)
+    {
+        printf("cannot open %s.\n", name_buffer);
+        return;
+    }
+    std::vector<uint8_t> temp_state;
+    uint8_t temp_chunk[16384];
+    size_t read_byte;
+    while ((read_byte = fread(temp_chunk, sizeof(uint8_t), sizeof(temp_chunk), save_in)) > 0)
+    {
+        temp_state.insert(temp_state.end(), temp_chunk, temp_chunk + read_byte);
+    }
     fclose(save_in);
     save_in = nullptr;
-    running_speed = original_speed;
+    if (!load_state(temp_state.data(), temp_state.size()))
+    {
+        return;
+    }
+    printf("State restored from %s.\n", name_buffer);
     printf("Successfully quick loaded.\n\n");
 }
-
-void Motherboard::fast_forward(void)
-{
-    running_speed = 32;
-    printf("Configured fast forward.\n");
-}
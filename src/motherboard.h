@@ -10,40 +10,79 @@
 #include "joypad.h"
 #include "memory.h"
 #include "cartridge.h"
-#include "emulator-form.h"
-#include <SDL2/SDL_thread.h>
-#include <chrono>
-#include <thread>
+#include "frame-pacer.h"
+#include "scheduler.h"
 #include <cstdlib>
+#include <string>
+#include <vector>
 
-#define FPS 1000/59.7
+// Default battery RAM flush period: 5 seconds of emulated time
+#define SAVE_FLUSH_PERIOD (5ULL * CLOCK_RATE)
+// CPU SCHD PPU MEM JOYP CART
+#define SAVE_STATE_CHUNK_COUNT 6
 
 namespace gameboy
 {
 
+// How often host input is sampled and latched into the joypad
+enum InputPollMode
+{
+    poll_per_frame = 0x00,   // once per frame, at V-Blank
+    poll_per_scanline = 0x01 // once per LY change, for latency-sensitive titles
+};
+
 class Motherboard
 {
 public:
+    Motherboard()
+    {
+        mem.scheduler = &scheduler;
+        mem.cartridge.clock = &scheduler.now;
+    }
+    gameboy::Scheduler scheduler;
     gameboy::Cpu cpu;
     gameboy::Memory mem;
     gameboy::Ppu ppu;
     gameboy::Timer timer;
 
     // power on sequence
-    bool power_on(int argc, char *argv[]);
+    bool power_on(std::string rom_file_path);
 
     // main loop
-    void loop(Emulatorform &form, Joypad &joypad, uint8_t scale);
+    // Run the CPU until the earliest deadline, then handle due events,
+    // until input is due (see InputPollMode)
+    // Return true when ppu.frame_buffer holds a new frame
+    bool run_until_poll(void);
 
-    // save&load
-    void save(void);
-    void load(void);
+    // Schedule the first event of each device
+    void schedule_devices(void);
 
-    // fast forward
-    void fast_forward(void);
-    uint8_t original_speed;
-    uint8_t running_speed;
+    // Handle one due event and schedule its next occurrence
+    void handle_event(EventName name);
 
+    // input
+    InputPollMode input_poll_mode = InputPollMode::poll_per_frame;
+    uint8_t last_polled_line = 0;
+    bool input_due = false;
+    // Latch host buttons into the joypad and handle the one-shot requests
+    void apply_input(JoypadInput &input);
+
+    // Battery RAM is flushed to its .sav file every save_flush_period clocks
+    // of emulated time, 0 only flushes on exit
+    uint64_t save_flush_period = SAVE_FLUSH_PERIOD;
+    // Write battery RAM back to its file and wait for it, call before exiting
+    void power_off(void);
+
+    // Save states, see src/save-state.h
+    // state is cleared first, a few tens of KB with cartridge RAM
+    void save_state(std::vector<uint8_t> &state);
+    // Return false, and leave the machine as it was, if the state is broken,
+    // of another version or of another ROM
+    bool load_state(const uint8_t *state, size_t size);
+
+    // save&load: quick save file <ROM name>.gbsave
+    void save(void);
+    void load(void);
 };
 } // namespace gameboy
 #endif
@@ -1,16 +1,15 @@
 #include "ppu.h"
 
-using gameboy::Emulatorform;
+#include <algorithm>
+
 using gameboy::Memory;
 using gameboy::Ppu;
 using gameboy::PpuMode;
+using gameboy::StateReader;
+using gameboy::StateWriter;
 
-void Ppu::ppu_main(uint8_t clocks, uint8_t speed_hack, Memory &mem, Emulatorform &form, uint8_t scale)
+uint16_t Ppu::next_mode(Memory &mem)
 {
-    reset_interrupt_registers(mem);
-    // sync with system cycles
-    add_time(clocks * speed_hack);
-
     // 1 clock == 4 dots
     // 0~20*4-1 (0~79) OAM Search
     // 20*4~(20+43)*4-1 (80~251) Pixel Transfer
@@ -19,69 +18,56 @@ void Ppu::ppu_main(uint8_t clocks, uint8_t speed_hack, Memory &mem, Emulatorform
 
     if (current_mode == PpuMode::mode_oam_search)
     {
-        if (ppu_inner_clock >= 79)
+        // sprites are only needed to draw the line
+        if (rendering_frame)
         {
-            ppu_inner_clock = ppu_inner_clock - 79;
-            set_mode(PpuMode::mode_pixel_transfer, mem);
-            //oam_search(mem);
+            oam_search(mem);
         }
+        set_mode(PpuMode::mode_pixel_transfer, mem);
+        return DOTS_PIXEL_TRANSFER;
     }
 
-    else if (current_mode == PpuMode::mode_pixel_transfer)
+    if (current_mode == PpuMode::mode_pixel_transfer)
     {
-        if (ppu_inner_clock >= 172)
-        {
-            ppu_inner_clock = ppu_inner_clock - 172;
-            set_mode(PpuMode::mode_hblank, mem);
-            pixel_transfer(mem);
-        }
+        set_mode(PpuMode::mode_hblank, mem);
+        return DOTS_HBLANK;
     }
 
-    else if (current_mode == PpuMode::mode_hblank)
+    if (current_mode == PpuMode::mode_hblank)
     {
-        if (ppu_inner_clock >= 205)
-        {
-            ppu_inner_clock = ppu_inner_clock - 205;
-
-            h_blank(speed_hack, mem, form, scale);
-
-            uint8_t ly_byte = mem.get_memory_byte(LY_ADDRESS);
-            // if LY >= SCREEN_HEIGHT enter vblank in next loop, flush buffer to screen now
-            if (ly_byte >= SCREEN_HEIGHT)
-            {
-                set_mode(PpuMode::mode_vblank, mem);
-                //form.refresh_surface();
-                ready_to_refresh = true;
-            }
+        h_blank(mem);
+        update_lyc(mem);
 
-            //if not, go on to next line
-            else
-            {
-                set_mode(PpuMode::mode_oam_search, mem);
-            }
-        }
-    }
-    else if (current_mode == PpuMode::mode_vblank)
-    {
-        // enter 10 lines of v_blank
-        if (ppu_inner_clock < 4560)
+        uint8_t ly_byte = mem.get_memory_byte(LY_ADDRESS);
+        // if LY >= SCREEN_HEIGHT enter vblank, flush buffer to screen now
+        if (ly_byte >= SCREEN_HEIGHT)
         {
-            v_blank(mem);
+            set_mode(PpuMode::mode_vblank, mem);
+            ready_to_refresh = true;
+            frame_rendered = rendering_frame;
+
+            // decide whether the next frame is drawn
+            frameskip_counter = (frameskip_counter >= frameskip) ? 0 : frameskip_counter + 1;
+            rendering_frame = (frameskip_counter == 0);
+            return DOTS_PER_LINE;
         }
 
-        // when reach the end, move to OAM Search in the next loop
-        if (ppu_inner_clock >= 4560)
-        {
-            set_mode(PpuMode::mode_oam_search, mem);
-            ppu_inner_clock = ppu_inner_clock - 4560;
-
-            // reset ly
-            mem.set_memory_byte(LY_ADDRESS, 0);
-        }
+        //if not, go on to next line
+        set_mode(PpuMode::mode_oam_search, mem);
+        return DOTS_OAM_SEARCH;
     }
 
-    // update LYC at the end of each loop
+    // one of 10 lines of v_blank is over
+    v_blank(mem);
     update_lyc(mem);
+
+    // when reach the end, move to OAM Search
+    if (mem.get_memory_byte(LY_ADDRESS) == 0)
+    {
+        set_mode(PpuMode::mode_oam_search, mem);
+        return DOTS_OAM_SEARCH;
+    }
+    return DOTS_PER_LINE;
 }
 
 void Ppu::oam_search(Memory &mem)
@@ -89,22 +75,54 @@ void Ppu::oam_search(Memory &mem)
     // from OAM_TABLE_INITIAL_ADDDRESS to 0xFE9F
     // 40 sprites
     // each sprite occupy 4 bytes
+    if (mem.oam_dirty)
+    {
+        decode_oam(mem);
+    }
+
+    uint8_t ly_byte = mem.get_memory_byte(LY_ADDRESS);
+    uint8_t lcdc_byte = mem.get_memory_byte(LCDC_ADDRESS);
+    //sprite_height from LCDC bit 2
+    line_sprite_height = (lcdc_byte & 0x04) ? 16 : 8;
 
+    // first 10 sprites on this line in OAM order, X does not matter here
+    line_sprite_count = 0;
+    for (int sprite_id = 0; sprite_id < OAM_SPRITE_COUNT && line_sprite_count < SPRITES_PER_LINE; sprite_id++)
+    {
+        const Sprite &sprite = oam_sprites[sprite_id];
+        if (ly_byte >= sprite.y && ly_byte < sprite.y + line_sprite_height)
+        {
+            line_sprites[line_sprite_count++] = sprite;
+        }
+    }
 
+    // smaller X wins, then smaller OAM index
+    // sort lowest priority first, so draw_line paints the winner last
+    std::sort(line_sprites, line_sprites + line_sprite_count, [](const Sprite &left, const Sprite &right) {
+        if (left.x != right.x)
+        {
+            return left.x > right.x;
+        }
+        return left.oam_index > right.oam_index;
+    });
 }
 
-void Ppu::pixel_transfer(Memory &mem)
+void Ppu::decode_oam(Memory &mem)
 {
-    uint8_t dma_byte = mem.get_memory_byte(DMA_ADDRESS);
-    for (uint8_t bytes = 0; bytes <= 0xA0; bytes++)
+    for (int sprite_id = 0; sprite_id < OAM_SPRITE_COUNT; sprite_id++)
     {
-        uint16_t dma_address_source = dma_byte * 0x0100 + bytes;
-        uint16_t dma_address_destin = OAM_TABLE_INITIAL_ADDDRESS + bytes;
-        mem.set_memory_byte(dma_address_destin, mem.get_memory_byte(dma_address_source));
+        const uint8_t *sprite_bytes = &mem.memory_byte[OAM_TABLE_INITIAL_ADDDRESS + sprite_id * 4];
+        Sprite &sprite = oam_sprites[sprite_id];
+        sprite.y = sprite_bytes[0] - 16; // y-coordinate offset: 0x10
+        sprite.x = sprite_bytes[1] - 8;  // x-coordinate offset: 0x08
+        sprite.tile_index = sprite_bytes[2];
+        sprite.attributes = sprite_bytes[3];
+        sprite.oam_index = sprite_id;
     }
+    mem.oam_dirty = false;
 }
 
-void Ppu::h_blank(uint8_t speed_hack, Memory &mem, Emulatorform &form, uint8_t scale)
+void Ppu::h_blank(Memory &mem)
 {
     // get current line
     uint8_t ly_byte = mem.get_memory_byte(LY_ADDRESS);
@@ -112,8 +130,8 @@ void Ppu::h_blank(uint8_t speed_hack, Memory &mem, Emulatorform &form, uint8_t s
     uint8_t lcdc_byte = mem.get_memory_byte(LCDC_ADDRESS);
 
     // draw current line
-    if (lcdc_byte & 0x01)
-        draw_line(ly_byte, mem, form, scale);
+    if (rendering_frame && (lcdc_byte & 0x01))
+        draw_line(ly_byte, mem);
 
     // write LY value into memory
     ly_byte++;
@@ -122,7 +140,9 @@ void Ppu::h_blank(uint8_t speed_hack, Memory &mem, Emulatorform &form, uint8_t s
 
 void Ppu::v_blank(Memory &mem)
 {
-    uint8_t ly_byte = (ppu_inner_clock / 456 + SCREEN_HEIGHT);
+    // LY keeps counting through 144~153, then wraps to 0
+    uint8_t ly_byte = mem.get_memory_byte(LY_ADDRESS);
+    ly_byte = (ly_byte >= LAST_LINE) ? 0 : ly_byte + 1;
     mem.set_memory_byte(LY_ADDRESS, ly_byte);
 }
 
@@ -170,7 +190,7 @@ void Ppu::set_mode(PpuMode mode, Memory &mem)
     mem.set_memory_byte(STAT_ADDRESS, stat_byte);
 }
 
-void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint8_t scale)
+void Ppu::draw_line(uint8_t line_number_y, Memory &mem)
 {
     if (line_number_y >= SCREEN_HEIGHT)
     {
@@ -182,6 +202,16 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
     // judge bit 0 in LCDC (BG & Window Enable)
     bool render_background = lcdc_byte & 0x01;
 
+    // palettes for this line, color index (0~3) to shade (0~3, 0 is the lightest)
+    uint8_t background_shades[4];
+    uint8_t sprite_shades[2][4];
+    get_palette_shades(mem.get_memory_byte(BGP_ADDRESS), background_shades);
+    get_palette_shades(mem.get_memory_byte(OBP0_ADDRESS), sprite_shades[0]);
+    get_palette_shades(mem.get_memory_byte(OBP1_ADDRESS), sprite_shades[1]);
+
+    // background color index (before palette) of each pixel, for sprite priority
+    memset(line_background_colors, 0, sizeof(line_background_colors));
+
     // if bit 0 in LCDC (BG Enable) is true
     // put all background data into buffer
 
@@ -197,6 +227,8 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
     bool background_window_tile_data_address_flag = lcdc_byte & 0x10;
     // if the flag is false, use signed index
     uint16_t background_window_tile_data_start_address = (background_window_tile_data_address_flag) ? 0x8000 : 0x9000;
+    // tile number in the tile cache of index 0: 0x8000 is #0, 0x9000 is #256
+    int background_window_tile_number_base = (background_window_tile_data_start_address - TILE_DATA_START_ADDRESS) / TILE_BYTES;
 
     // render background
     if (render_background)
@@ -227,9 +259,8 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
         int y = (line_number_y + SCY) % 256; //locate background in background map
 
         int last_tile_x = -1;
-        //it is strange, this two should be put outside.
-        uint8_t tile_data_bytes_line_one = 0x00;
-        uint8_t tile_data_bytes_line_two = 0x00;
+        // decoded row of the current tile
+        const uint8_t *tile_row = nullptr;
 
         for (int i = 0; i < SCREEN_WIDTH; i++)
         {
@@ -237,7 +268,6 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
             int x = (i + SCX) % 256;
             int tile_x = x / 8; //8 pixels per tile
             int tile_y = y / 8;
-            int pixel_x = 8 - x % 8 - 1;
             int pixel_y = y % 8;
 
             // render a new tile unless we get to the last
@@ -255,16 +285,16 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
                     tile_index = (int8_t)tmp_tile_index;
                 }
 
-                // get tile data
-                tile_data_bytes_line_one = mem.get_memory_byte(background_window_tile_data_start_address + (tile_index * 16) + (pixel_y * 2));
-                tile_data_bytes_line_two = mem.get_memory_byte(background_window_tile_data_start_address + (tile_index * 16) + (pixel_y * 2) + 1);
+                // get decoded tile row
+                tile_row = mem.tile_cache.get_tile_row(background_window_tile_number_base + tile_index, pixel_y);
                 last_tile_x = tile_x;
             }
 
-            // mix pixel color of two lines
-            int color = mix_tile_colors(pixel_x, tile_data_bytes_line_one, tile_data_bytes_line_two);
-            // directly set color
-            form.set_pixel_color(i, line_number_y, color, scale);
+            // color from decoded tile
+            int color = tile_row[x % 8];
+            // write into frame buffer
+            frame_buffer[line_number_y][i] = background_shades[color];
+            line_background_colors[i] = color;
         }
     }
 
@@ -292,8 +322,8 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
             //WX is offset from absolute screen coordinates by 7.
             uint8_t absolute_WX = WX - 7;
 
-            uint8_t tile_data_bytes_line_one = 0x00;
-            uint8_t tile_data_bytes_line_two = 0x00;
+            // decoded row of the current tile
+            const uint8_t *tile_row = nullptr;
 
             int last_tile_x = -1;
 
@@ -306,7 +336,6 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
                 int x = i - absolute_WX;
                 int tile_x = x / 8; //8 pixels per tile
                 int tile_y = y / 8;
-                int pixel_x = 8 - x % 8 - 1;
                 int pixel_y = y % 8;
 
                 // render a new tile unless we get to the last
@@ -324,17 +353,17 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
                         tile_index = (int8_t)tmp_tile_index;
                     }
 
-                    // get tile data
-                    tile_data_bytes_line_one = mem.get_memory_byte(background_window_tile_data_start_address + (tile_index * 16) + (pixel_y * 2));
-                    tile_data_bytes_line_two = mem.get_memory_byte(background_window_tile_data_start_address + (tile_index * 16) + (pixel_y * 2) + 1);
+                    // get decoded tile row
+                    tile_row = mem.tile_cache.get_tile_row(background_window_tile_number_base + tile_index, pixel_y);
                     last_tile_x = tile_x;
                 }
 
-                // mix pixel color of two lines
-                int color = mix_tile_colors(pixel_x, tile_data_bytes_line_one, tile_data_bytes_line_two);
+                // color from decoded tile
+                int color = tile_row[x % 8];
 
-                // directly set color
-                form.set_pixel_color(i, line_number_y, color, scale);
+                // write into frame buffer
+                frame_buffer[line_number_y][i] = background_shades[color];
+                line_background_colors[i] = color;
             }
         }
     }
@@ -344,88 +373,57 @@ void Ppu::draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint
 
     if (OBJ_enable)
     {
-        //sprite_height from LCDC bit 2
-        uint8_t sprite_height = 8 * (((lcdc_byte & 0x04) >> 2) + 1);
-        // 40 sprites, without flitering
-        for (int sprite_id = 39; sprite_id >= 0; sprite_id--)
+        // sprites picked by oam_search, lowest priority first
+        for (int sprite_order = 0; sprite_order < line_sprite_count; sprite_order++)
         {
-            uint16_t current_oam_address = OAM_TABLE_INITIAL_ADDDRESS + sprite_id * 4;
-            uint8_t y_position = mem.get_memory_byte(current_oam_address);
-            uint8_t x_position = mem.get_memory_byte(current_oam_address + 1);
-            uint8_t tile_index = mem.get_memory_byte(current_oam_address + 2);
-            tile_index++;
-            //if (sprite_height == 16)
-            //{
-            //    // lsb of the sprite pattern number is ignored and treated as 0.
-            //    tile_index &= 0xFE;
-            //}
-            //else
-            //{
-            //    tile_index &= 0xFF;
-            //}
-            uint8_t temp_attritube = mem.get_memory_byte(current_oam_address + 3);
-            //bool attributes_priority = temp_attritube & 0x80;
-            bool attributes_y_flip = temp_attritube & 0x40;
-            bool attributes_x_flip = temp_attritube & 0x20;
-            //bool attributes_palette_number = temp_attritube & 0x10;
-
-            if (!(y_position | x_position))
-            {
-                continue;
-            }
-
-            int16_t sprite_y = y_position - 16; // y-coordinate offset: 0x10
-            int16_t sprite_x = x_position - 8;  // x-coordinate offset: 0x08
-            uint16_t line = line_number_y - sprite_y;
-            // if not in this line, dont render
-            if (line_number_y < sprite_y || line >= sprite_height)
+            const Sprite &sprite = line_sprites[sprite_order];
+            bool attributes_priority = sprite.attributes & 0x80;
+            bool attributes_y_flip = sprite.attributes & 0x40;
+            bool attributes_x_flip = sprite.attributes & 0x20;
+            bool attributes_palette_number = sprite.attributes & 0x10;
+
+            int line = line_number_y - sprite.y;
+            if (line < 0 || line >= line_sprite_height)
             {
                 continue;
             }
-            if (sprite_x < -7 || sprite_x >= (SCREEN_WIDTH))
+            if (attributes_y_flip)
             {
-                continue;
+                // flip vertically
+                line = line_sprite_height - line - 1;
             }
 
-            bool flip_x = attributes_x_flip;
-            bool flip_y = attributes_y_flip;
-
-            // actual position is attr_y -8
-            line -= 8;
-
-            if (flip_y)
+            // 8*16: lsb of the tile index is ignored, the second tile is the lower half
+            uint8_t tile_index = sprite.tile_index;
+            if (line_sprite_height == 16)
             {
-                // flip vertically
-                line = sprite_height - line - 1;
+                tile_index &= 0xFE;
             }
-
-            uint16_t tile_location = 0x8000 + tile_index * 16 + line * 2;
-            uint8_t sprite_tile_line_one = mem.get_memory_byte(tile_location);
-            uint8_t sprite_tile_line_two = mem.get_memory_byte(tile_location + 1);
+            const uint8_t *sprite_tile_row = mem.tile_cache.get_tile_row(tile_index + line / 8, line % 8);
 
             for (int x = 0; x < PIXELS_PER_TILELINE; x++)
             {
                 // if out of range, we dont need to render
-                if (sprite_x + x < 0 || sprite_x + x >= (SCREEN_WIDTH))
+                int pos_x = sprite.x + x;
+                if (pos_x < 0 || pos_x >= SCREEN_WIDTH)
                 {
                     continue;
                 }
 
-                int pixel_x_in_line = PIXELS_PER_TILELINE - x % PIXELS_PER_TILELINE - 1;
+                // flip horizontally
+                int color = sprite_tile_row[attributes_x_flip ? PIXELS_PER_TILELINE - x - 1 : x];
 
-                if (flip_x || flip_y)
+                // color 0 is transparent
+                if (!color)
                 {
-                    // flip horizontally
-                    pixel_x_in_line = PIXELS_PER_TILELINE - pixel_x_in_line - 1;
+                    continue;
                 }
-
-                int color = mix_tile_colors(pixel_x_in_line, sprite_tile_line_one, sprite_tile_line_two);
-
-                if (!color)
+                // behind background colors 1~3
+                if (attributes_priority && line_background_colors[pos_x])
                 {
                     continue;
                 }
-                form.set_pixel_color(sprite_x + x, line_number_y, color, scale);
+                frame_buffer[line_number_y][pos_x] = sprite_shades[attributes_palette_number][color];
             }
         }
     }
@@ -458,24 +456,72 @@ void Ppu::update_lyc(Memory &mem)
     mem.set_memory_byte(STAT_ADDRESS, stat_byte);
 }
 
-void Ppu::add_time(int add_clocks)
+void Ppu::get_palette_shades(uint8_t palette_byte, uint8_t shades[4])
 {
-    ppu_inner_clock += add_clocks;
+    // bit 1-0: shade of color 0, bit 3-2: color 1, bit 5-4: color 2, bit 7-6: color 3
+    for (int color = 0; color < 4; color++)
+    {
+        shades[color] = (palette_byte >> (color * 2)) & 0x03;
+    }
 }
 
-void Ppu::reset_interrupt_registers(Memory &mem)
+void Ppu::save_state(StateWriter &writer)
 {
-    // get current interrupt status
-    uint8_t interrupt_flag_byte = mem.get_memory_byte(IF_ADDRESS);
-
-    // change bit 0 (V-Blank) and bit 1 to 0 (LCDC Status)
-    interrupt_flag_byte &= 0xFC;
-
-    // write result to memory
-    mem.set_memory_byte(IF_ADDRESS, interrupt_flag_byte);
+    writer.put_byte(current_mode);
+    writer.put_byte(ready_to_refresh);
+    writer.put_byte(frameskip_counter);
+    writer.put_byte(rendering_frame);
+    writer.put_byte(frame_rendered);
+    writer.put_byte(line_sprite_height);
+    writer.put_byte(line_sprite_count);
+    for (int i = 0; i < line_sprite_count; i++)
+    {
+        writer.put_word(line_sprites[i].y);
+        writer.put_word(line_sprites[i].x);
+        writer.put_byte(line_sprites[i].tile_index);
+        writer.put_byte(line_sprites[i].attributes);
+        writer.put_byte(line_sprites[i].oam_index);
+    }
 }
 
-uint8_t Ppu::mix_tile_colors(int bit, uint8_t tile_data_bytes_line_one, uint8_t tile_data_bytes_line_two)
+bool Ppu::load_state(StateReader &reader)
 {
-    return (((tile_data_bytes_line_one >> bit) & 1) << 1) | ((tile_data_bytes_line_two >> bit) & 1);
+    uint8_t temp_mode = reader.get_byte();
+    bool temp_ready_to_refresh = reader.get_byte();
+    uint8_t temp_frameskip_counter = reader.get_byte();
+    bool temp_rendering_frame = reader.get_byte();
+    bool temp_frame_rendered = reader.get_byte();
+    uint8_t temp_sprite_height = reader.get_byte();
+    uint8_t temp_sprite_count = reader.get_byte();
+    if (reader.failed() || temp_mode > PpuMode::mode_pixel_transfer || temp_sprite_count > SPRITES_PER_LINE ||
+        (temp_sprite_height != 8 && temp_sprite_height != 16))
+    {
+        return false;
+    }
+    Sprite temp_sprites[SPRITES_PER_LINE];
+    for (int i = 0; i < temp_sprite_count; i++)
+    {
+        temp_sprites[i].y = (int16_t)reader.get_word();
+        temp_sprites[i].x = (int16_t)reader.get_word();
+        temp_sprites[i].tile_index = reader.get_byte();
+        temp_sprites[i].attributes = reader.get_byte();
+        temp_sprites[i].oam_index = reader.get_byte();
+    }
+    if (reader.failed())
+    {
+        return false;
+    }
+
+    current_mode = (PpuMode)temp_mode;
+    ready_to_refresh = temp_ready_to_refresh;
+    frameskip_counter = temp_frameskip_counter;
+    rendering_frame = temp_rendering_frame;
+    frame_rendered = temp_frame_rendered;
+    line_sprite_height = temp_sprite_height;
+    line_sprite_count = temp_sprite_count;
+    for (int i = 0; i < temp_sprite_count; i++)
+    {
+        line_sprites[i] = temp_sprites[i];
+    }
+    return true;
 }
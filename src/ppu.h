@@ -3,9 +3,15 @@
 
 #include <cstdint>
 #include "memory.h"
-#include "emulator-form.h"
 
+#define SCREEN_WIDTH 160
+#define SCREEN_HEIGHT 144
 #define PIXELS_PER_TILELINE 8
+#define DOTS_OAM_SEARCH 80
+#define DOTS_PIXEL_TRANSFER 172
+#define DOTS_HBLANK 204
+#define DOTS_PER_LINE 456
+#define LAST_LINE 153
 #define IF_ADDRESS 0xFF0F
 
 namespace gameboy
@@ -34,6 +40,19 @@ enum PpuMode
 #define WY_ADDRESS 0xFF4A
 #define WX_ADDRESS 0xFF4B
 #define OAM_TABLE_INITIAL_ADDDRESS 0xFE00
+#define OAM_TABLE_SIZE 0xA0
+#define OAM_SPRITE_COUNT 40
+#define SPRITES_PER_LINE 10
+
+// Sprite attributes in OAM, decoded to screen coordinates
+struct Sprite
+{
+    int16_t y; // top line on screen (OAM byte 0 - 16)
+    int16_t x; // left column on screen (OAM byte 1 - 8)
+    uint8_t tile_index;
+    uint8_t attributes; // bit 7: behind background, bit 6: y flip, bit 5: x flip, bit 4: palette
+    uint8_t oam_index;
+};
 
 class Ppu
 {
@@ -46,42 +65,63 @@ public:
 
     bool ready_to_refresh = false;
 
+    // frameskip: draw one frame out of frameskip + 1
+    // skipped frames still step LY, STAT and interrupts, only drawing is left out
+    uint8_t frameskip = 0;
+    uint8_t frameskip_counter = 0;
+    // the current frame is drawn
+    bool rendering_frame = true;
+    // the frame that set ready_to_refresh was drawn, frame_buffer is new
+    bool frame_rendered = false;
+
+    // screen buffer, drawn line by line
+    // 0~3 for 4 shades after palettes (0 is the lightest), front ends map them to colors
+    uint8_t frame_buffer[SCREEN_HEIGHT][SCREEN_WIDTH] = {{0}};
+
+    // decoded OAM
+    Sprite oam_sprites[OAM_SPRITE_COUNT];
+    // sprites on the current line, lowest priority first
+    Sprite line_sprites[SPRITES_PER_LINE];
+    int line_sprite_count = 0;
+    int line_sprite_height = 8;
+    // background color index of the current line, 0 lets background priority sprites show
+    uint8_t line_background_colors[SCREEN_WIDTH];
+
     // Main
-    void ppu_main(uint8_t clocks, uint8_t speed_hack, Memory &mem, Emulatorform &form, uint8_t scale);
+    // Called by the scheduler when the current mode ends
+    // Enter the next mode and return its length in dots
+    uint16_t next_mode(Memory &mem);
 
     // for each line in first 144 lines
     // 20 clocks for OAMSearch
+    // pick the sprites on the current line
     void oam_search(Memory &mem);
-    // 43 clocks for PixelTransfer (DMA)
-    void pixel_transfer(Memory &mem);
-    // 51 clock0s for HBlank
-    void h_blank(uint8_t speed_hack, Memory &mem, Emulatorform &form, uint8_t scale);
+    // rebuild oam_sprites after OAM changed
+    void decode_oam(Memory &mem);
+    // 43 clocks for PixelTransfer, nothing to do before H-Blank
+    // 51 clocks for HBlank
+    void h_blank(Memory &mem);
     // for last 10 lines * (20+43+51) clocks per line
-    // there's VBlank
+    // there's VBlank, one event per line
     void v_blank(Memory &mem);
 
     // set mode
     void set_mode(PpuMode mode, Memory &mem);
 
     // draw line y
-    void draw_line(uint8_t line_number_y, Memory &mem, Emulatorform &form, uint8_t scale);
+    void draw_line(uint8_t line_number_y, Memory &mem);
 
     // update lyc
     void update_lyc(Memory &mem);
 
-    // Ppu Clock
-    // Add AddClocks time to inner clocks
-    void add_time(int add_clocks);
-
-    // reset interrupt registers (IF)
-    void reset_interrupt_registers(Memory &mem);
+    // decode BGP / OBP0 / OBP1
+    void get_palette_shades(uint8_t palette_byte, uint8_t shades[4]);
 
-    // mix tile color
-    uint8_t mix_tile_colors(int bit, uint8_t tile_data_bytes_line_one, uint8_t tile_data_bytes_line_two);
+    // Save states: mode, frame skipping and the sprites picked for the current line
+    // The registers live in memory, oam_sprites is decoded again from OAM
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
 
-private:
-    // inner clock
-    uint16_t ppu_inner_clock = 0;
 };
 } // namespace gameboy
 
@@ -1,63 +1,74 @@
 #include "register.h"
 using gameboy::FlagName;
+using gameboy::FlagOp;
 using gameboy::Register;
 using gameboy::RegisterName;
 
-// Getter and setter for 8-bit registers: A F B C D E H L
-uint8_t Register::get_register_byte(RegisterName name)
-{
-    return register_byte[name];
-}
-
-void Register::set_register_byte(RegisterName name, uint8_t byte)
-{
-    register_byte[name] = byte;
-}
-
 // Getter and setter: F at register_byte[r_f], once a bit
-bool Register::get_flag(FlagName flag)
-{
-    return (register_byte[r_f] & flag);
-}
-
 void Register::set_flag(FlagName flag, bool flag_status)
 {
+    uint8_t temp_flags = get_flags();
     if (flag_status)
     {
-        register_byte[r_f] |= flag;
+        temp_flags |= flag;
     }
     else
     {
-        register_byte[r_f] &= (~flag);
+        temp_flags &= (~flag);
     }
+    register_byte[r_f] = temp_flags;
 }
 
-// Getter and setter for 16-bit registers: SP PC
-uint16_t Register::get_register_word(RegisterName name)
+void Register::materialize_flags(void)
 {
-    return register_word[name];
-}
+    uint8_t temp_flags = flag_result ? 0 : FlagName::f_z;
 
-void Register::set_register_word(RegisterName name, uint16_t word)
-{
-    register_word[name] = word;
-}
-
-// Some instructions allow you to use the registers A B C D E H L as 16-bit registers
-// by pairing them up in the following manner: AF BC DE HL
-uint16_t Register::get_register_byte_pair(RegisterName first, RegisterName second)
-{
-    uint16_t paired_first = ((register_byte[first] << 8) & 0xffff);
-    uint16_t paired_second = (register_byte[second] & 0xffff);
-    return (paired_first + paired_second);
-}
+    switch (flag_op)
+    {
+    case FlagOp::flag_op_add:
+    {
+        if ((flag_x & 0x0f) + (flag_y & 0x0f) + flag_carry > 0x0f)
+            temp_flags |= FlagName::f_h;
+        if (flag_x + flag_y + flag_carry > 0xff)
+            temp_flags |= FlagName::f_c;
+        break;
+    }
+    case FlagOp::flag_op_sub:
+    {
+        temp_flags |= FlagName::f_n;
+        // borrow from bit 4 and bit 8
+        if ((flag_x & 0x0f) < (flag_y & 0x0f) + flag_carry)
+            temp_flags |= FlagName::f_h;
+        if (flag_x < flag_y + flag_carry)
+            temp_flags |= FlagName::f_c;
+        break;
+    }
+    case FlagOp::flag_op_result:
+    {
+        temp_flags |= flag_fixed;
+        break;
+    }
+    case FlagOp::flag_op_inc:
+    {
+        if ((flag_result & 0x0f) == 0x00)
+            temp_flags |= FlagName::f_h;
+        temp_flags |= flag_fixed;
+        break;
+    }
+    case FlagOp::flag_op_dec:
+    {
+        temp_flags |= FlagName::f_n;
+        if ((flag_result & 0x0f) == 0x0f)
+            temp_flags |= FlagName::f_h;
+        temp_flags |= flag_fixed;
+        break;
+    }
+    default:
+        return;
+    }
 
-void Register::set_register_byte_pair(RegisterName first, RegisterName second, uint16_t word)
-{
-    uint8_t splited_first = ((word >> 8) & 0xff);
-    uint8_t splited_second = (word & 0xff);
-    register_byte[first] = splited_first;
-    register_byte[second] = splited_second;
+    register_byte[r_f] = temp_flags;
+    flag_op = FlagOp::flag_op_none;
 }
 
 // Initialize all register status when power on
@@ -20,6 +20,9 @@ enum FlagName
 };
 
 // Prefix r_ menas register
+// 8-bit registers are numbered so that the pairs AF BC DE HL are native 16-bit
+// words in register_pair: the low half (F C E L) comes first on little-endian hosts
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
 enum RegisterName
 {
     // 8-bit
@@ -36,31 +39,223 @@ enum RegisterName
     r_sp = 0, // Stack Pointer
     r_pc = 1  // Program Counter
 };
+#else
+enum RegisterName
+{
+    // 8-bit
+    r_f = 0, // Flags
+    r_a = 1, // Accumulator
+    r_c = 2,
+    r_b = 3,
+    r_e = 4,
+    r_d = 5,
+    r_l = 6,
+    r_h = 7,
+
+    // 16-bit
+    r_sp = 0, // Stack Pointer
+    r_pc = 1  // Program Counter
+};
+#endif
+
+// 16-bit register pairs, index in register_pair
+// Prefix p_ means pair
+enum PairName
+{
+    p_af = 0,
+    p_bc = 1,
+    p_de = 2,
+    p_hl = 3
+};
+
+// How the pending flags are computed from the last ALU operation
+// Z is always set if flag_result is zero, except for flag_op_none
+// Prefix flag_op_ means lazy flag operation
+enum FlagOp
+{
+    flag_op_none = 0,   // F in register_byte[r_f] is up to date
+    flag_op_add = 1,    // N reset, H and C from flag_x + flag_y + flag_carry
+    flag_op_sub = 2,    // N set, H and C from flag_x - flag_y - flag_carry
+    flag_op_result = 3, // N H C in flag_fixed (logic, rotate, shift, swap, bit)
+    flag_op_inc = 4,    // N reset, H from flag_result, C in flag_fixed
+    flag_op_dec = 5     // N set, H from flag_result, C in flag_fixed
+};
 
 class Register
 {
   public:
-    // 8-bit registers: A F B C D E H L
-    uint8_t register_byte[8];
+    // 8-bit registers: A F B C D E H L, indexed by RegisterName
+    // the same storage as pairs: AF BC DE HL, indexed by PairName
+    union
+    {
+        uint8_t register_byte[8];
+        uint16_t register_pair[4];
+    };
     // 16-bit registers: SP PC
     uint16_t register_word[2];
 
     // Getter and setter for 8-bit registers: A F B C D E H L
-    uint8_t get_register_byte(RegisterName name);
-    void set_register_byte(RegisterName name, uint8_t byte);
+    uint8_t get_register_byte(RegisterName name)
+    {
+        if (name == r_f)
+        {
+            return get_flags();
+        }
+        return register_byte[name];
+    }
+    void set_register_byte(RegisterName name, uint8_t byte)
+    {
+        if (name == r_f)
+        {
+            set_flags(byte);
+            return;
+        }
+        register_byte[name] = byte;
+    }
+
+    // Lazy flags
+    // ALU operations only record their operands and result, F is computed
+    // when an instruction reads it (conditions, PUSH AF, ADC/SBC, DAA...)
+    uint8_t flag_op = FlagOp::flag_op_none;
+    uint8_t flag_x = 0;
+    uint8_t flag_y = 0;
+    uint8_t flag_carry = 0;
+    uint8_t flag_result = 0;
+    uint8_t flag_fixed = 0;
+
+    // Compute F from the pending operation into register_byte[r_f]
+    void materialize_flags(void);
+
+    // F with all flags up to date
+    uint8_t get_flags(void)
+    {
+        if (flag_op != FlagOp::flag_op_none)
+        {
+            materialize_flags();
+        }
+        return register_byte[r_f];
+    }
+
+    // Set all flags at once, lower 4 bits are always 0
+    void set_flags(uint8_t flags)
+    {
+        register_byte[r_f] = flags & 0xf0;
+        flag_op = FlagOp::flag_op_none;
+    }
+
+    // Record an 8-bit add or subtract, with carry in for ADC/SBC
+    void set_flags_add(uint8_t x, uint8_t y, uint8_t carry, uint8_t result)
+    {
+        flag_op = FlagOp::flag_op_add;
+        flag_x = x;
+        flag_y = y;
+        flag_carry = carry;
+        flag_result = result;
+    }
+    void set_flags_sub(uint8_t x, uint8_t y, uint8_t carry, uint8_t result)
+    {
+        flag_op = FlagOp::flag_op_sub;
+        flag_x = x;
+        flag_y = y;
+        flag_carry = carry;
+        flag_result = result;
+    }
+
+    // Z from result, the other flags are known (f_n | f_h | f_c bits)
+    void set_flags_result(uint8_t result, uint8_t fixed)
+    {
+        flag_op = FlagOp::flag_op_result;
+        flag_result = result;
+        flag_fixed = fixed;
+    }
+
+    // C alone, from the pending operation without materializing F
+    bool get_carry(void)
+    {
+        switch (flag_op)
+        {
+        case FlagOp::flag_op_none:
+            return register_byte[r_f] & FlagName::f_c;
+        case FlagOp::flag_op_add:
+            return flag_x + flag_y + flag_carry > 0xff;
+        case FlagOp::flag_op_sub:
+            return flag_x < flag_y + flag_carry;
+        default:
+            // result, inc, dec
+            return flag_fixed & FlagName::f_c;
+        }
+    }
+
+    // INC and DEC keep C, carried over in flag_fixed
+    void set_flags_inc(uint8_t result)
+    {
+        flag_fixed = get_carry() ? FlagName::f_c : 0;
+        flag_op = FlagOp::flag_op_inc;
+        flag_result = result;
+    }
+    void set_flags_dec(uint8_t result)
+    {
+        flag_fixed = get_carry() ? FlagName::f_c : 0;
+        flag_op = FlagOp::flag_op_dec;
+        flag_result = result;
+    }
 
     // Getter and setter: F at register_byte[f], once a bit
-    bool get_flag(FlagName flag);
+    bool get_flag(FlagName flag)
+    {
+        // every pending operation sets Z from its result
+        if (flag == FlagName::f_z && flag_op != FlagOp::flag_op_none)
+        {
+            return !flag_result;
+        }
+        if (flag == FlagName::f_c)
+        {
+            return get_carry();
+        }
+        return get_flags() & flag;
+    }
     void set_flag(FlagName flag, bool flag_status);
 
     // Getter and setter for 16-bit registers: SP PC
-    uint16_t get_register_word(RegisterName name);
-    void set_register_word(RegisterName name, uint16_t word);
+    uint16_t get_register_word(RegisterName name)
+    {
+        return register_word[name];
+    }
+    void set_register_word(RegisterName name, uint16_t word)
+    {
+        register_word[name] = word;
+    }
 
     // Some instructions allow you to use the registers A B C D E H L as 16-bit registers
     // by pairing them up in the following manner: AF BC DE HL
-    uint16_t get_register_byte_pair(RegisterName first, RegisterName second);
-    void set_register_byte_pair(RegisterName first, RegisterName second, uint16_t word);
+    uint16_t get_pair(PairName pair)
+    {
+        // AF
+        if (pair == p_af)
+        {
+            get_flags();
+        }
+        return register_pair[pair];
+    }
+    void set_pair(PairName pair, uint16_t word)
+    {
+        // AF, lower 4 bits of F are always 0
+        if (pair == p_af)
+        {
+            set_flags(word & 0xff);
+            word = (word & 0xff00) | register_byte[r_f];
+        }
+        register_pair[pair] = word;
+    }
+    // first is the high half: (r_b, r_c) is BC
+    uint16_t get_register_byte_pair(RegisterName first, RegisterName second)
+    {
+        return get_pair(static_cast<PairName>(second >> 1));
+    }
+    void set_register_byte_pair(RegisterName first, RegisterName second, uint16_t word)
+    {
+        set_pair(static_cast<PairName>(second >> 1), word);
+    }
 
     // Initialize all register status when power on
     Register &power_on();
@@ -0,0 +1,114 @@
+#include "rom-image.h"
+#include "save-state.h"
+#include <cstdio>
+#include <map>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ROM_IMAGE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using gameboy::RomImage;
+
+// Images by path, an entry expires with the last cartridge holding it
+// Batch runner workers open ROMs at the same time
+static std::mutex rom_image_lock;
+static std::map<std::string, std::weak_ptr<const RomImage>> rom_image_cache;
+
+std::shared_ptr<const RomImage> RomImage::open(const std::string &path)
+{
+    std::lock_guard<std::mutex> rom_image_guard(rom_image_lock);
+
+    auto temp_entry = rom_image_cache.find(path);
+    if (temp_entry != rom_image_cache.end())
+    {
+        std::shared_ptr<const RomImage> temp_image = temp_entry->second.lock();
+        if (temp_image)
+        {
+            return temp_image;
+        }
+        rom_image_cache.erase(temp_entry);
+    }
+
+    std::shared_ptr<RomImage> temp_image(new RomImage);
+    if (!temp_image->load(path))
+    {
+        return nullptr;
+    }
+    rom_image_cache[path] = temp_image;
+    return temp_image;
+}
+
+RomImage::~RomImage()
+{
+#ifdef ROM_IMAGE_MMAP
+    if (mapping)
+    {
+        munmap(mapping, size);
+    }
+#endif
+}
+
+bool RomImage::load(const std::string &path)
+{
+#ifdef ROM_IMAGE_MMAP
+    // Map the file read-only: nothing is copied, and the pages come from the page cache
+    int rom_fd = ::open(path.c_str(), O_RDONLY);
+    if (rom_fd < 0)
+    {
+        printf("cannot open this file. Check your input.\n");
+        return false;
+    }
+    struct stat rom_stat;
+    if (fstat(rom_fd, &rom_stat) == 0 && S_ISREG(rom_stat.st_mode) && rom_stat.st_size > 0)
+    {
+        void *temp_mapping = mmap(nullptr, rom_stat.st_size, PROT_READ, MAP_PRIVATE, rom_fd, 0);
+        if (temp_mapping != MAP_FAILED)
+        {
+            mapping = temp_mapping;
+            bytes = (const uint8_t *)mapping;
+            size = rom_stat.st_size;
+        }
+    }
+    close(rom_fd);
+    if (bytes)
+    {
+        return true;
+    }
+#endif
+
+    // not mapped: read the whole file into a buffer of its size
+    FILE *rom_file = fopen(path.c_str(), "rb");
+    if (rom_file == NULL)
+    {
+        printf("cannot open this file. Check your input.\n");
+        return false;
+    }
+    uint8_t temp_chunk[16384];
+    size_t read_byte;
+    while ((read_byte = fread(temp_chunk, sizeof(uint8_t), sizeof(temp_chunk), rom_file)) > 0)
+    {
+        buffer.insert(buffer.end(), temp_chunk, temp_chunk + read_byte);
+    }
+    fclose(rom_file);
+    buffer.shrink_to_fit();
+    bytes = buffer.data();
+    size = buffer.size();
+    return true;
+}
+
+uint32_t RomImage::get_checksum(void) const
+{
+    // instances sharing the image may save states at the same time
+    std::lock_guard<std::mutex> rom_image_guard(rom_image_lock);
+    if (!f_checksum)
+    {
+        checksum = get_rom_checksum(bytes, size);
+        f_checksum = true;
+    }
+    return checksum;
+}
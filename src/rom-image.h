@@ -0,0 +1,60 @@
+// Immutable ROM image
+// The bytes of a ROM file, mapped read-only with mmap where available, read into
+// a buffer of the file size otherwise. RomImage::open hands out the image already
+// open for a path as long as any cartridge holds it, so every instance running
+// one game points at a single copy; bank registers and RAM stay per instance.
+
+#ifndef GAMEBOY_ROM_IMAGE_H
+#define GAMEBOY_ROM_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gameboy
+{
+
+class RomImage
+{
+public:
+    // Image of the file at path, shared with the other holders of the same path
+    // Return nullptr if the file can not be opened
+    static std::shared_ptr<const RomImage> open(const std::string &path);
+
+    ~RomImage();
+    RomImage(const RomImage &) = delete;
+    RomImage &operator=(const RomImage &) = delete;
+
+    const uint8_t *get_bytes(void) const
+    {
+        return bytes;
+    }
+    // File size, the header may use less
+    size_t get_size(void) const
+    {
+        return size;
+    }
+    // CRC-32 of the file, save states carry it
+    // Computed on the first call: it reads every page of the file, a ROM that
+    // is only run stays mapped lazily
+    uint32_t get_checksum(void) const;
+
+private:
+    RomImage() = default;
+    bool load(const std::string &path);
+
+    const uint8_t *bytes = nullptr;
+    size_t size = 0;
+    // filled by the first get_checksum, under the lock of RomImage::open
+    mutable uint32_t checksum = 0;
+    mutable bool f_checksum = false;
+    // mmap of the whole file, or nullptr
+    void *mapping = nullptr;
+    // the file read into memory when it can not be mapped
+    std::vector<uint8_t> buffer;
+};
+} // namespace gameboy
+
+#endif
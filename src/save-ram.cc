@@ -0,0 +1,146 @@
+#include "save-ram.h"
+#include <cerrno>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SAVE_RAM_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using gameboy::SaveRam;
+
+SaveRam::~SaveRam()
+{
+    close();
+}
+
+bool SaveRam::open(const std::string &path, uint32_t size, uint8_t fill)
+{
+    close();
+    if (size == 0)
+    {
+        return true;
+    }
+
+#ifdef SAVE_RAM_MMAP
+    int save_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (save_fd < 0)
+    {
+        printf("cannot open save file %s, RAM will not be saved.\n", path.c_str());
+        allocate(size, fill);
+        return false;
+    }
+    struct stat save_stat;
+    if (fstat(save_fd, &save_stat) != 0 || !S_ISREG(save_stat.st_mode))
+    {
+        ::close(save_fd);
+        printf("cannot open save file %s, RAM will not be saved.\n", path.c_str());
+        allocate(size, fill);
+        return false;
+    }
+    // a new or short file grows to the RAM size, a longer one (RTC data
+    // appended by other emulators) keeps its tail
+    uint32_t temp_file_size = (save_stat.st_size < size) ? save_stat.st_size : size;
+    if (save_stat.st_size < size && ftruncate(save_fd, size) != 0)
+    {
+        ::close(save_fd);
+        printf("cannot grow save file %s, RAM will not be saved.\n", path.c_str());
+        allocate(size, fill);
+        return false;
+    }
+    void *temp_mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, save_fd, 0);
+    ::close(save_fd);
+    if (temp_mapping != MAP_FAILED)
+    {
+        mapping = temp_mapping;
+        bytes = (uint8_t *)mapping;
+        this->size = size;
+        this->path = path;
+        for (uint32_t i = temp_file_size; i < size; i++)
+        {
+            bytes[i] = fill;
+        }
+        printf("Battery RAM in %s\n", path.c_str());
+        return true;
+    }
+#endif
+
+    // not mapped: read the file into a buffer, flush writes it back
+    allocate(size, fill);
+    FILE *save_file = fopen(path.c_str(), "rb");
+    if (!save_file && errno != ENOENT)
+    {
+        printf("cannot read save file %s, RAM will not be saved.\n", path.c_str());
+        return false;
+    }
+    if (save_file)
+    {
+        // a short read would leave fill bytes that the next flush writes over the save
+        long temp_file_size = (fseek(save_file, 0, SEEK_END) == 0) ? ftell(save_file) : -1;
+        size_t temp_expected = (temp_file_size >= 0 && (uint64_t)temp_file_size < size) ? temp_file_size : size;
+        rewind(save_file);
+        size_t temp_read = (temp_file_size >= 0) ? fread(bytes, sizeof(uint8_t), temp_expected, save_file) : 0;
+        fclose(save_file);
+        if (temp_file_size < 0 || temp_read != temp_expected)
+        {
+            printf("short read of save file %s, RAM will not be saved.\n", path.c_str());
+            return false;
+        }
+    }
+    this->path = path;
+    printf("Battery RAM in %s\n", path.c_str());
+    return true;
+}
+
+void SaveRam::allocate(uint32_t size, uint8_t fill)
+{
+    close();
+    buffer.assign(size, fill);
+    bytes = buffer.data();
+    this->size = size;
+}
+
+void SaveRam::close(void)
+{
+    flush(true);
+#ifdef SAVE_RAM_MMAP
+    if (mapping)
+    {
+        munmap(mapping, size);
+        mapping = nullptr;
+    }
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+    bytes = nullptr;
+    size = 0;
+    path.clear();
+}
+
+void SaveRam::flush(bool wait)
+{
+    if (path.empty())
+    {
+        return;
+    }
+#ifdef SAVE_RAM_MMAP
+    if (mapping)
+    {
+        msync(mapping, size, wait ? MS_SYNC : MS_ASYNC);
+        return;
+    }
+#endif
+    FILE *save_file = fopen(path.c_str(), "r+b");
+    if (!save_file)
+    {
+        save_file = fopen(path.c_str(), "wb");
+    }
+    if (save_file)
+    {
+        fwrite(bytes, sizeof(uint8_t), size, save_file);
+        fclose(save_file);
+    }
+}
@@ -0,0 +1,66 @@
+// Battery-backed cartridge RAM
+// The RAM of a cartridge with a battery is the .sav file next to the ROM, mapped
+// shared with mmap where available: game writes land in the page cache at once,
+// so they survive a crash of the emulator, and flush only asks the kernel to
+// write them back (msync) without waiting on the disk. Without mmap the file is
+// read into a buffer and written back by flush. Cartridges without a battery
+// (or with save files disabled) get a plain buffer.
+
+#ifndef GAMEBOY_SAVE_RAM_H
+#define GAMEBOY_SAVE_RAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gameboy
+{
+
+class SaveRam
+{
+public:
+    SaveRam() = default;
+    ~SaveRam();
+    SaveRam(const SaveRam &) = delete;
+    SaveRam &operator=(const SaveRam &) = delete;
+
+    // size bytes backed by the file at path, created or grown with fill bytes
+    // Return false if the file can not be opened or read, the RAM is then a plain buffer
+    // and the file is left untouched
+    bool open(const std::string &path, uint32_t size, uint8_t fill);
+    // size bytes of fill, not backed by a file
+    void allocate(uint32_t size, uint8_t fill);
+    // Flush and drop the RAM
+    void close(void);
+
+    // Write the RAM back to its file, if any
+    // wait: return once it is on disk (on exit), otherwise only start the write
+    void flush(bool wait);
+
+    uint8_t *get_bytes(void)
+    {
+        return bytes;
+    }
+    uint32_t get_size(void)
+    {
+        return size;
+    }
+    // Backed by a file
+    bool is_persistent(void)
+    {
+        return !path.empty();
+    }
+
+private:
+    uint8_t *bytes = nullptr;
+    uint32_t size = 0;
+    // file of the RAM, empty for a plain buffer
+    std::string path;
+    // mmap of the file, or nullptr
+    void *mapping = nullptr;
+    // the RAM when it is not mapped
+    std::vector<uint8_t> buffer;
+};
+} // namespace gameboy
+
+#endif
@@ -0,0 +1,69 @@
+#include "save-state.h"
+
+using gameboy::StateReader;
+using gameboy::StateWriter;
+
+void StateWriter::begin_chunk(const char id[4])
+{
+    chunk_start = bytes.size();
+    put_bytes((const uint8_t *)id, 4);
+    put_dword(0);
+}
+
+void StateWriter::end_chunk(void)
+{
+    uint32_t temp_size = bytes.size() - chunk_start - SAVE_STATE_CHUNK_HEADER_SIZE;
+    for (int i = 0; i < 4; i++)
+    {
+        bytes[chunk_start + 4 + i] = (temp_size >> (8 * i)) & 0xff;
+    }
+}
+
+bool StateReader::next_chunk(char id[4], StateReader &chunk)
+{
+    if (at_end())
+    {
+        return false;
+    }
+    get_bytes((uint8_t *)id, 4);
+    uint32_t temp_size = get_dword();
+    if (f_failed || temp_size > size - position)
+    {
+        f_failed = true;
+        return false;
+    }
+    chunk = StateReader(&bytes[position], temp_size);
+    position += temp_size;
+    return true;
+}
+
+// Reflected CRC-32 (zlib) table
+struct CrcTable
+{
+    uint32_t entries[256];
+
+    CrcTable()
+    {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t temp_crc = n;
+            for (int k = 0; k < 8; k++)
+            {
+                temp_crc = (temp_crc & 1) ? (0xedb88320 ^ (temp_crc >> 1)) : (temp_crc >> 1);
+            }
+            entries[n] = temp_crc;
+        }
+    }
+};
+
+uint32_t gameboy::get_rom_checksum(const uint8_t *bytes, size_t size)
+{
+    // built on first use, batch runner workers may get here at the same time
+    static const CrcTable crc_table;
+    uint32_t temp_crc = 0xffffffff;
+    for (size_t i = 0; i < size; i++)
+    {
+        temp_crc = crc_table.entries[(temp_crc ^ bytes[i]) & 0xff] ^ (temp_crc >> 8);
+    }
+    return temp_crc ^ 0xffffffff;
+}
@@ -0,0 +1,150 @@
+// Save states
+// A state is a header and a list of chunks, one per component:
+//   header: "GBSS", version (16 bits), header size (16 bits), ROM checksum (32 bits)
+//   chunk:  4-character id, payload size (32 bits), payload
+// Numbers are little endian. Components write their own chunk (Cpu::save_state,
+// Ppu::save_state, ...) and only the parts of memory that hold state: VRAM, WRAM,
+// OAM, I/O, HRAM and cartridge RAM, not ROM or the echo of WRAM. Readers skip
+// chunks they do not know, so a newer version can add chunks; a change to an
+// existing chunk needs a new version. States live in memory (rewind, search),
+// Motherboard::save writes one to a file.
+
+#ifndef GAMEBOY_SAVE_STATE_H
+#define GAMEBOY_SAVE_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#define SAVE_STATE_MAGIC "GBSS"
+#define SAVE_STATE_VERSION 1
+// magic, version, header size, ROM checksum
+#define SAVE_STATE_HEADER_SIZE 12
+// chunk id and payload size
+#define SAVE_STATE_CHUNK_HEADER_SIZE 8
+
+namespace gameboy
+{
+
+// Appends to a state
+class StateWriter
+{
+public:
+    explicit StateWriter(std::vector<uint8_t> &bytes) : bytes(bytes)
+    {
+    }
+
+    // Start a chunk, the size is filled in by end_chunk
+    void begin_chunk(const char id[4]);
+    void end_chunk(void);
+
+    void put_byte(uint8_t byte)
+    {
+        bytes.push_back(byte);
+    }
+    void put_word(uint16_t word)
+    {
+        put_byte(word & 0xff);
+        put_byte(word >> 8);
+    }
+    void put_dword(uint32_t dword)
+    {
+        put_word(dword & 0xffff);
+        put_word(dword >> 16);
+    }
+    void put_qword(uint64_t qword)
+    {
+        put_dword(qword & 0xffffffff);
+        put_dword(qword >> 32);
+    }
+    void put_bytes(const uint8_t *source, size_t size)
+    {
+        // resize and copy: GCC 12 warns about vector::insert once inlined here
+        if (size == 0)
+        {
+            return;
+        }
+        size_t temp_end = bytes.size();
+        bytes.resize(temp_end + size);
+        memcpy(&bytes[temp_end], source, size);
+    }
+
+private:
+    std::vector<uint8_t> &bytes;
+    // offset of the open chunk
+    size_t chunk_start = 0;
+};
+
+// Reads a chunk payload, or a whole state
+// Reading past the end returns zeros and marks the reader failed
+class StateReader
+{
+public:
+    StateReader(const uint8_t *bytes, size_t size) : bytes(bytes), size(size)
+    {
+    }
+
+    uint8_t get_byte(void)
+    {
+        if (position + 1 > size)
+        {
+            f_failed = true;
+            return 0;
+        }
+        return bytes[position++];
+    }
+    uint16_t get_word(void)
+    {
+        uint16_t temp_low = get_byte();
+        return temp_low | (get_byte() << 8);
+    }
+    uint32_t get_dword(void)
+    {
+        uint32_t temp_low = get_word();
+        return temp_low | ((uint32_t)get_word() << 16);
+    }
+    uint64_t get_qword(void)
+    {
+        uint64_t temp_low = get_dword();
+        return temp_low | ((uint64_t)get_dword() << 32);
+    }
+    void get_bytes(uint8_t *destination, size_t count)
+    {
+        if (position + count > size)
+        {
+            f_failed = true;
+            return;
+        }
+        memcpy(destination, &bytes[position], count);
+        position += count;
+    }
+
+    // Next chunk of a state, after the header
+    // Return false at the end, or if the chunk runs past it (failed)
+    bool next_chunk(char id[4], StateReader &chunk);
+
+    // A read ran past the end
+    bool failed(void) const
+    {
+        return f_failed;
+    }
+    // Every byte was read
+    bool at_end(void) const
+    {
+        return position == size;
+    }
+
+    size_t position = 0;
+
+private:
+    const uint8_t *bytes;
+    size_t size;
+    bool f_failed = false;
+};
+
+// CRC-32 of a ROM, saved in the header so a state only loads with its game
+uint32_t get_rom_checksum(const uint8_t *bytes, size_t size);
+} // namespace gameboy
+
+#endif
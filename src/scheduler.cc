@@ -0,0 +1,118 @@
+#include "scheduler.h"
+
+using gameboy::EventName;
+using gameboy::ScheduledEvent;
+using gameboy::Scheduler;
+using gameboy::StateReader;
+using gameboy::StateWriter;
+
+void Scheduler::schedule(EventName name, uint64_t cycle)
+{
+    // older entries of this event become stale
+    event_generation[name]++;
+    event_pending[name] = true;
+    event_deadline[name] = cycle;
+    event_queue.push(ScheduledEvent{cycle, name, event_generation[name]});
+
+    if (cycle < next_cycle)
+    {
+        next_cycle = cycle;
+    }
+}
+
+void Scheduler::cancel(EventName name)
+{
+    if (!event_pending[name])
+    {
+        return;
+    }
+    event_generation[name]++;
+    event_pending[name] = false;
+    refresh_next_cycle();
+}
+
+bool Scheduler::pending(EventName name)
+{
+    return event_pending[name];
+}
+
+bool Scheduler::pop_due(EventName &name)
+{
+    refresh_next_cycle();
+    if (next_cycle > now)
+    {
+        return false;
+    }
+
+    name = event_queue.top().name;
+    event_cycle = event_queue.top().cycle;
+    event_queue.pop();
+    event_pending[name] = false;
+    refresh_next_cycle();
+    return true;
+}
+
+void Scheduler::refresh_next_cycle(void)
+{
+    // drop stale entries on top of the heap
+    while (!event_queue.empty())
+    {
+        const ScheduledEvent &top = event_queue.top();
+        if (event_pending[top.name] && top.generation == event_generation[top.name])
+        {
+            break;
+        }
+        event_queue.pop();
+    }
+    next_cycle = event_queue.empty() ? UINT64_MAX : event_queue.top().cycle;
+}
+
+void Scheduler::save_state(StateWriter &writer)
+{
+    writer.put_qword(now);
+    writer.put_qword(event_cycle);
+    writer.put_byte(event_count);
+    for (int name = 0; name < event_count; name++)
+    {
+        writer.put_byte(event_pending[name]);
+        writer.put_qword(event_deadline[name]);
+    }
+}
+
+bool Scheduler::load_state(StateReader &reader)
+{
+    uint64_t temp_now = reader.get_qword();
+    uint64_t temp_event_cycle = reader.get_qword();
+    if (reader.get_byte() != event_count)
+    {
+        return false;
+    }
+    bool temp_pending[event_count];
+    uint64_t temp_deadline[event_count];
+    for (int name = 0; name < event_count; name++)
+    {
+        temp_pending[name] = reader.get_byte();
+        temp_deadline[name] = reader.get_qword();
+    }
+    if (reader.failed())
+    {
+        return false;
+    }
+
+    event_queue = decltype(event_queue)();
+    for (int name = 0; name < event_count; name++)
+    {
+        event_pending[name] = false;
+    }
+    now = temp_now;
+    event_cycle = temp_event_cycle;
+    next_cycle = UINT64_MAX;
+    for (int name = 0; name < event_count; name++)
+    {
+        if (temp_pending[name])
+        {
+            schedule((EventName)name, temp_deadline[name]);
+        }
+    }
+    return true;
+}
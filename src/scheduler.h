@@ -0,0 +1,81 @@
+// Global event scheduler
+// Devices schedule their next state change at an absolute clock,
+// the CPU runs uninterrupted until the earliest deadline.
+
+#ifndef GAMEBOY_SCHEDULER_H
+#define GAMEBOY_SCHEDULER_H
+
+#include "save-state.h"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace gameboy
+{
+
+// Prefix event_ means scheduled event
+// Each event is pending at most once, scheduling it again moves the deadline
+enum EventName
+{
+    event_ppu_mode = 0,    // PPU mode transition (OAM Search, Pixel Transfer, H-Blank, V-Blank line)
+    event_div_tick = 1,    // DIV (FF04) increment
+    event_timer_tick = 2,  // TIMA (FF05) increment, may overflow and request interrupt
+    event_timer_write = 3, // game wrote DIV or TAC, timer events need to be rescheduled
+    event_save_flush = 4,  // battery RAM written back to its .sav file
+    event_count = 5
+};
+
+struct ScheduledEvent
+{
+    uint64_t cycle;
+    EventName name;
+    uint32_t generation;
+
+    // events due at the same clock run in EventName order, so a state
+    // restored by load_state runs them in the same order
+    bool operator>(const ScheduledEvent &other) const
+    {
+        return cycle > other.cycle || (cycle == other.cycle && name > other.name);
+    }
+};
+
+class Scheduler
+{
+public:
+    // Absolute time in clocks (4 MHz), advanced by the main loop
+    uint64_t now = 0;
+
+    // Earliest pending deadline, the main loop only compares now against it
+    uint64_t next_cycle = UINT64_MAX;
+
+    // Deadline of the last popped event
+    // Periodic events count from it, so the CPU running past a deadline does not stretch the period
+    uint64_t event_cycle = 0;
+
+    // Schedule (or move) an event to an absolute clock
+    void schedule(EventName name, uint64_t cycle);
+    void cancel(EventName name);
+    bool pending(EventName name);
+
+    // Pop the earliest event if it is due
+    // Return false when nothing is due
+    bool pop_due(EventName &name);
+
+    // Save states: now, event_cycle and the pending events
+    void save_state(StateWriter &writer);
+    bool load_state(StateReader &reader);
+
+private:
+    // min-heap on cycle, entries made stale by schedule/cancel are skipped lazily
+    std::priority_queue<ScheduledEvent, std::vector<ScheduledEvent>, std::greater<ScheduledEvent>> event_queue;
+    uint32_t event_generation[event_count] = {0};
+    bool event_pending[event_count] = {false};
+    // deadline of each pending event
+    uint64_t event_deadline[event_count] = {0};
+
+    void refresh_next_cycle(void);
+};
+} // namespace gameboy
+
+#endif
@@ -0,0 +1,130 @@
+#include "thread-pool.h"
+
+using gameboy::ThreadPool;
+
+ThreadPool::ThreadPool(unsigned thread_count)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::thread::hardware_concurrency();
+    }
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    for (unsigned i = 0; i < thread_count; i++)
+    {
+        worker_queues.emplace_back(new WorkerQueue);
+    }
+    for (unsigned i = 0; i < thread_count; i++)
+    {
+        workers.emplace_back(&ThreadPool::worker_main, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> state_guard(state_lock);
+        stopping = true;
+    }
+    task_queued.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    unsigned temp_queue_index;
+    {
+        std::lock_guard<std::mutex> state_guard(state_lock);
+        temp_queue_index = next_queue;
+        next_queue = (next_queue + 1) % worker_queues.size();
+    }
+    {
+        WorkerQueue &worker_queue = *worker_queues[temp_queue_index];
+        std::lock_guard<std::mutex> queue_guard(worker_queue.queue_lock);
+        worker_queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> state_guard(state_lock);
+        queued++;
+        unfinished++;
+    }
+    task_queued.notify_one();
+}
+
+void ThreadPool::wait(void)
+{
+    std::unique_lock<std::mutex> state_guard(state_lock);
+    task_finished.wait(state_guard, [this] { return unfinished == 0; });
+}
+
+unsigned ThreadPool::get_thread_count(void)
+{
+    return workers.size();
+}
+
+void ThreadPool::worker_main(unsigned worker_index)
+{
+    while (true)
+    {
+        {
+            // claim one task, it is in some queue until taken
+            std::unique_lock<std::mutex> state_guard(state_lock);
+            task_queued.wait(state_guard, [this] { return stopping || queued > 0; });
+            if (queued == 0)
+            {
+                return;
+            }
+            queued--;
+        }
+
+        std::function<void()> task = take_task(worker_index);
+        task();
+
+        {
+            std::lock_guard<std::mutex> state_guard(state_lock);
+            unfinished--;
+        }
+        task_finished.notify_all();
+    }
+}
+
+std::function<void()> ThreadPool::take_task(unsigned worker_index)
+{
+    unsigned temp_queue_count = worker_queues.size();
+    while (true)
+    {
+        // own queue, newest first
+        {
+            WorkerQueue &own_queue = *worker_queues[worker_index];
+            std::lock_guard<std::mutex> queue_guard(own_queue.queue_lock);
+            if (!own_queue.tasks.empty())
+            {
+                std::function<void()> task = std::move(own_queue.tasks.back());
+                own_queue.tasks.pop_back();
+                return task;
+            }
+        }
+
+        // steal from the others, oldest first
+        for (unsigned offset = 1; offset < temp_queue_count; offset++)
+        {
+            WorkerQueue &victim_queue = *worker_queues[(worker_index + offset) % temp_queue_count];
+            std::lock_guard<std::mutex> queue_guard(victim_queue.queue_lock);
+            if (!victim_queue.tasks.empty())
+            {
+                std::function<void()> task = std::move(victim_queue.tasks.front());
+                victim_queue.tasks.pop_front();
+                return task;
+            }
+        }
+
+        // another worker took the task we saw first, the claimed one is still queued
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,65 @@
+// Work-stealing thread pool
+// Each worker owns a queue and takes tasks from its back,
+// an idle worker steals from the front of the others
+
+#ifndef GAMEBOY_THREAD_POOL_H
+#define GAMEBOY_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gameboy
+{
+
+class ThreadPool
+{
+public:
+    // thread_count 0 means one thread per hardware thread
+    explicit ThreadPool(unsigned thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Queue a task, tasks are spread over the workers round robin
+    void submit(std::function<void()> task);
+
+    // Block until every submitted task has finished
+    void wait(void);
+
+    unsigned get_thread_count(void);
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex queue_lock;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> worker_queues;
+    std::vector<std::thread> workers;
+
+    // queued: tasks not claimed by a worker yet
+    // unfinished: tasks submitted but not finished yet
+    std::mutex state_lock;
+    std::condition_variable task_queued;
+    std::condition_variable task_finished;
+    uint64_t queued = 0;
+    uint64_t unfinished = 0;
+    unsigned next_queue = 0;
+    bool stopping = false;
+
+    void worker_main(unsigned worker_index);
+
+    // Take a claimed task: own queue first, then steal
+    std::function<void()> take_task(unsigned worker_index);
+};
+} // namespace gameboy
+
+#endif
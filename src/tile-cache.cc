@@ -0,0 +1,21 @@
+#include "tile-cache.h"
+
+using gameboy::TileCache;
+
+void TileCache::decode_tile(uint16_t tile_number)
+{
+    const uint8_t *tile_bytes = tile_data + tile_number * TILE_BYTES;
+    for (int row = 0; row < 8; row++)
+    {
+        // 2 bytes per line
+        // first byte holds bit 0 of each color, second byte holds bit 1
+        uint8_t tile_data_bytes_line_one = tile_bytes[row * 2];
+        uint8_t tile_data_bytes_line_two = tile_bytes[row * 2 + 1];
+        for (int pixel_x = 0; pixel_x < 8; pixel_x++)
+        {
+            int bit = 7 - pixel_x;
+            tile_pixels[tile_number][row][pixel_x] = (((tile_data_bytes_line_two >> bit) & 1) << 1) | ((tile_data_bytes_line_one >> bit) & 1);
+        }
+    }
+    tile_dirty[tile_number] = false;
+}
@@ -0,0 +1,61 @@
+// Decoded tile cache
+// 384 tiles in 0x8000~0x97FF, 16 bytes each, decoded into 8*8 color indices (0~3)
+// A write into tile data marks the tile, it is decoded again on the next lookup
+
+#ifndef GAMEBOY_TILE_CACHE_H
+#define GAMEBOY_TILE_CACHE_H
+
+#include <cstdint>
+#include <cstring>
+
+#define TILE_DATA_START_ADDRESS 0x8000
+#define TILE_DATA_END_ADDRESS 0x97FF
+#define TILE_COUNT 384
+#define TILE_BYTES 16
+
+namespace gameboy
+{
+
+class TileCache
+{
+public:
+    TileCache()
+    {
+        invalidate_all();
+    }
+
+    // Tile data in memory, set by Memory
+    const uint8_t *tile_data = nullptr;
+
+    // A byte of tile data changed
+    void invalidate(uint16_t address)
+    {
+        tile_dirty[(address - TILE_DATA_START_ADDRESS) / TILE_BYTES] = true;
+    }
+
+    // Tile data changed behind our back (load)
+    void invalidate_all(void)
+    {
+        memset(tile_dirty, true, sizeof(tile_dirty));
+    }
+
+    // Tile number of a tile data address: (address - 0x8000) / 16
+    // Return 8 color indices, leftmost pixel first
+    const uint8_t *get_tile_row(uint16_t tile_number, uint8_t row)
+    {
+        if (tile_dirty[tile_number])
+        {
+            decode_tile(tile_number);
+        }
+        return tile_pixels[tile_number][row];
+    }
+
+private:
+    uint8_t tile_pixels[TILE_COUNT][8][8];
+    bool tile_dirty[TILE_COUNT];
+
+    void decode_tile(uint16_t tile_number);
+};
+} // namespace gameboy
+
+#endif
@@ -1,71 +1,50 @@
 #include "timer.h"
 
+using gameboy::Memory;
 using gameboy::Timer;
 
-void Timer::add_time(uint8_t cycle, Memory &mem)
+void Timer::div_tick(Memory &mem)
 {
-    Timer::refresh_timer_register(mem);
-    divider += cycle;
-    if(divider >= 256)
+    mem.memory_byte[DIV_ADDRESS]++;
+}
+
+void Timer::tima_tick(Memory &mem)
+{
+    uint8_t temp_tima = mem.get_memory_byte(TIMA_ADDRESS);
+    if (temp_tima == 0xFF)
     {
-        divider -=256;
-        reg_div++;
+        // request interrupt!
+        uint8_t temp_interrupt_flag = mem.get_memory_byte(IF_ADDRESS);
+        temp_interrupt_flag |= 0x04;
+        mem.set_memory_byte(IF_ADDRESS, temp_interrupt_flag);
+
+        // reset tima to tma
+        temp_tima = mem.get_memory_byte(TMA_ADDRESS);
     }
+    else
+    {
+        temp_tima++;
+    }
+    mem.set_memory_byte(TIMA_ADDRESS, temp_tima);
+}
 
-    if((reg_tac & 0x04)==0) // timer enabled
+uint16_t Timer::tima_period(Memory &mem)
+{
+    uint8_t temp_tac = mem.get_memory_byte(TAC_ADDRESS);
+    if ((temp_tac & 0x04) == 0) // timer disabled
     {
-        return;
+        return 0;
     }
-    counter+=cycle;
-    uint64_t current_clock_threshold;
-    switch(reg_tac & 0x3)
+
+    switch (temp_tac & 0x03)
     {
     case 0:
-        current_clock_threshold=1024;
-        break;
+        return 1024;
     case 1:
-        current_clock_threshold=16;
-        break;
+        return 16;
     case 2:
-        current_clock_threshold=64;
-        break;
-    case 3:
-        current_clock_threshold=256;
+        return 64;
+    default:
+        return 256;
     }
-    while (counter >= current_clock_threshold)
-    {
-        counter-=current_clock_threshold;
-        // counter=0;
-        if(reg_tima==0xFF)
-        {
-            // request interrupt!
-            uint8_t temp_interrupt_flag = mem.get_memory_byte(IF_ADDRESS);
-            temp_interrupt_flag |= 0x04;
-            mem.set_memory_byte(IF_ADDRESS, temp_interrupt_flag);
-
-            // rest tima to tma
-            reg_tima=reg_tma;
-        }
-        else
-        {
-            reg_tima++;
-        }
-    }
-    Timer::set_timer_register(mem);
-}
-
-void Timer::refresh_timer_register(Memory &mem)
-{
-    Timer::reg_div = mem.get_memory_byte(0xFF04);
-    Timer::reg_tima = mem.get_memory_byte(0xFF05);
-    Timer::reg_tma = mem.get_memory_byte(0xFF06);
-    Timer::reg_tac = mem.get_memory_byte(0xFF07);
-}
-
-void Timer::set_timer_register(Memory &mem)
-{
-    mem.set_memory_byte(0xFF04, Timer::reg_div);
-    mem.set_memory_byte(0xFF05, Timer::reg_tima);
-    mem.set_memory_byte(0xFF06, Timer::reg_tma);
-    mem.set_memory_byte(0xFF07, Timer::reg_tac);
 }
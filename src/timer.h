@@ -6,32 +6,31 @@
 #include "memory.h"
 
 #define IF_ADDRESS 0xFF0F
+#define DIV_ADDRESS 0xFF04
+#define TIMA_ADDRESS 0xFF05
+#define TMA_ADDRESS 0xFF06
+#define TAC_ADDRESS 0xFF07
+
+// DIV counts at 16384 Hz
+#define DIV_PERIOD 256
 
 namespace gameboy
 {
 
+// Driven by the scheduler, the registers live in memory
+// Each tick is one event instead of counting clocks after every instruction
 class Timer
 {
 public:
-    Timer()
-    {
-        counter = 0;
-        divider = 0;
-        reg_div = 0;  //reg means register divider ff04
-        reg_tima = 0; //counter ff05
-        reg_tma = 0;  //modulator ff06
-        reg_tac = 0;  //control ff07
-    };
-    uint64_t counter;
-    uint64_t divider;
-    uint8_t reg_div;  //reg means register divider ff04
-    uint8_t reg_tima; //counter ff05
-    uint8_t reg_tma;  //modulator ff06
-    uint8_t reg_tac;  //control ff07
-    // 4 * cycle!
-    void add_time(uint8_t cycle, Memory &mem);
-    void refresh_timer_register(Memory &mem);
-    void set_timer_register(Memory &mem);
+    // DIV (FF04) tick
+    void div_tick(Memory &mem);
+
+    // TIMA (FF05) tick, reload TMA (FF06) and request interrupt on overflow
+    void tima_tick(Memory &mem);
+
+    // Clocks between two TIMA ticks, selected by TAC (FF07) bit 0-1
+    // Return 0 when the timer is stopped (TAC bit 2)
+    uint16_t tima_period(Memory &mem);
 };
 } // namespace gameboy
 
@@ -0,0 +1,88 @@
+#include "../src/cpu.h"
+#include "../src/memory.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace gameboy;
+
+// Compare MIPS of the function table core, the threaded core and the dynarec on the same ROM
+// Only CPU and memory run, LY is stepped once per 456 clocks so games waiting for a line can go on
+
+// build command
+// g++ -std=c++11 -O2 -DGAMEBOY_THREADED_INTERPRETER -DGAMEBOY_DYNAREC ./src/cpu.cc ./src/cpu-threaded.cc ./src/dynarec.cc ./src/register.cc ./src/memory.cc ./src/cartridge.cc ./src/mapper.cc ./src/rom-image.cc ./src/save-ram.cc ./src/save-state.cc ./src/joypad.cc ./src/scheduler.cc ./src/tile-cache.cc ./src/block-cache.cc ./test/cpu-bench.cc -o cpu_bench.out
+
+// usage
+// ./cpu_bench.out <rom> [seconds of GameBoy time, default 60]
+
+#define BENCH_CLOCK_RATE 4194304
+#define BENCH_LINE_CLOCKS 456
+#define BENCH_LY_ADDRESS 0xFF44
+
+typedef void (Cpu::*func_run)(Memory &mem, uint64_t &clock, const uint64_t &deadline);
+
+bool bench_core(const char *core_name, func_run run, const char *rom_path, uint64_t clocks)
+{
+    // Memory is too large for the stack
+    Memory *mem = new Memory;
+    Cpu *cpu = new Cpu;
+    if (!mem->cartridge.power_on(rom_path))
+    {
+        delete mem;
+        delete cpu;
+        return false;
+    }
+    mem->map_cartridge_pages();
+    cpu->power_on();
+
+    uint64_t clock = 0;
+    uint64_t deadline = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (clock < clocks)
+    {
+        deadline += BENCH_LINE_CLOCKS;
+        (cpu->*run)(*mem, clock, deadline);
+        mem->memory_byte[BENCH_LY_ADDRESS] = (mem->memory_byte[BENCH_LY_ADDRESS] + 1) % 154;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    printf("%-8s %12llu instructions %8.3f s %10.2f MIPS %8.1fx realtime\n",
+           core_name,
+           (unsigned long long)cpu->instruction_count,
+           seconds,
+           cpu->instruction_count / seconds / 1e6,
+           (double)clocks / BENCH_CLOCK_RATE / seconds);
+
+    delete mem;
+    delete cpu;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <rom> [seconds]\n", argv[0]);
+        return 1;
+    }
+    uint64_t seconds = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 60;
+    uint64_t clocks = seconds * BENCH_CLOCK_RATE;
+
+    if (!bench_core("table", &Cpu::run_table, argv[1], clocks))
+    {
+        return 1;
+    }
+#ifdef GAMEBOY_THREADED_INTERPRETER
+    bench_core("threaded", &Cpu::run_threaded, argv[1], clocks);
+#else
+    printf("threaded core not built, define GAMEBOY_THREADED_INTERPRETER\n");
+#endif
+#ifdef GAMEBOY_DYNAREC
+    bench_core("dynarec", &Cpu::run_dynarec, argv[1], clocks);
+#else
+    printf("dynarec not built, define GAMEBOY_DYNAREC (x86-64)\n");
+#endif
+    return 0;
+}
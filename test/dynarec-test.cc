@@ -0,0 +1,418 @@
+#include "../src/cpu.h"
+#include "../src/memory.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace gameboy;
+
+// Differential test of the dynarec against the interpreter (Cpu::next in a loop)
+// Two machines start from the same state, run to the same deadlines and are compared
+// after every run: registers, flags, PC, SP, IME, HALT, clock, instruction count,
+// mapped bank and 0x8000~0xFFFF.
+// 1. every opcode, repeated in a hot loop, from random register values
+// 2. random ROMs, with random interrupt requests between runs
+// 3. MBC3 real time clock latched and set from translated code
+// 4. ROM files given on the command line, LY stepped as in test/cpu-bench.cc
+
+// build command
+// g++ -std=c++11 -O2 -DGAMEBOY_DYNAREC ./src/cpu.cc ./src/dynarec.cc ./src/register.cc ./src/memory.cc ./src/cartridge.cc ./src/mapper.cc ./src/rom-image.cc ./src/save-ram.cc ./src/save-state.cc ./src/joypad.cc ./src/scheduler.cc ./src/tile-cache.cc ./src/block-cache.cc ./test/dynarec-test.cc -o dynarec_test.out
+
+// usage
+// ./dynarec_test.out [rom ...]
+
+#define TEST_LINE_CLOCKS 456
+#define TEST_LY_ADDRESS 0xFF44
+#define TEST_CODE_ADDRESS 0x0150
+
+#ifdef GAMEBOY_DYNAREC
+
+// Reference: one instruction at a time
+void run_interpreter(Cpu &cpu, Memory &mem, uint64_t &clock, const uint64_t &deadline)
+{
+    cpu.idle_loop_armed = false;
+    while (clock < deadline)
+    {
+        if (cpu.f_halted && !(mem.memory_byte[0xff0f] & mem.memory_byte[0xffff]))
+        {
+            cpu.skip_halt(clock, deadline);
+            return;
+        }
+        clock += 4 * cpu.next(mem);
+        if (cpu.idle_loop_hit)
+        {
+            cpu.skip_idle_loop(clock, deadline);
+        }
+    }
+}
+
+// Two machines, [0] runs the dynarec and [1] the interpreter
+struct TestPair
+{
+    Memory *mem[2];
+    Cpu *cpu[2];
+    uint64_t clock[2] = {0, 0};
+
+    TestPair()
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            // Memory is too large for the stack
+            mem[i] = new Memory;
+            cpu[i] = new Cpu;
+            memset(mem[i]->memory_byte, 0, sizeof(mem[i]->memory_byte));
+            // illegal opcodes lock up the real CPU, run them as NOP on both sides
+            for (int opcode = 0; opcode < 256; opcode++)
+            {
+                if (!cpu[i]->handle_opcode_main[opcode])
+                {
+                    cpu[i]->handle_opcode_main[opcode] = &Cpu::ex_nop;
+                }
+            }
+        }
+    }
+    ~TestPair()
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            delete mem[i];
+            delete cpu[i];
+        }
+    }
+
+    // 32 KB ROM, without MBC by default, rom lives until the test ends
+    void load_rom(uint8_t *rom, MapperType type = MapperType::mapper_rom_only)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            mem[i]->cartridge.mapper_type = type;
+            mem[i]->cartridge.rom_bytes = rom;
+            mem[i]->cartridge.rom_size = ROM_MIN_SIZE;
+            mem[i]->cartridge.rom_attributes_bank_count = 2;
+            mem[i]->cartridge.create_mapper();
+            // the real time clock counts this machine's clock
+            mem[i]->cartridge.mapper->clock = &clock[i];
+            mem[i]->map_cartridge_pages();
+            cpu[i]->power_on();
+        }
+    }
+
+    void run(uint64_t deadline)
+    {
+        cpu[0]->run_dynarec(*mem[0], clock[0], deadline);
+        run_interpreter(*cpu[1], *mem[1], clock[1], deadline);
+    }
+
+    // Print the first difference, return true if both machines are the same
+    bool compare(const char *name)
+    {
+        static const RegisterName names[8] = {r_a, r_f, r_b, r_c, r_d, r_e, r_h, r_l};
+        static const char *labels[8] = {"A", "F", "B", "C", "D", "E", "H", "L"};
+        for (int r = 0; r < 8; r++)
+        {
+            uint8_t temp_dynarec = cpu[0]->reg.get_register_byte(names[r]);
+            uint8_t temp_interpreter = cpu[1]->reg.get_register_byte(names[r]);
+            if (temp_dynarec != temp_interpreter)
+            {
+                printf("%s: %s %02x, interpreter %02x\n", name, labels[r], temp_dynarec, temp_interpreter);
+                return false;
+            }
+        }
+        if (cpu[0]->reg.register_word[r_pc] != cpu[1]->reg.register_word[r_pc] ||
+            cpu[0]->reg.register_word[r_sp] != cpu[1]->reg.register_word[r_sp])
+        {
+            printf("%s: PC %04x SP %04x, interpreter PC %04x SP %04x\n", name,
+                   cpu[0]->reg.register_word[r_pc], cpu[0]->reg.register_word[r_sp],
+                   cpu[1]->reg.register_word[r_pc], cpu[1]->reg.register_word[r_sp]);
+            return false;
+        }
+        if (clock[0] != clock[1] || cpu[0]->instruction_count != cpu[1]->instruction_count)
+        {
+            printf("%s: clock %llu instructions %llu, interpreter clock %llu instructions %llu\n", name,
+                   (unsigned long long)clock[0], (unsigned long long)cpu[0]->instruction_count,
+                   (unsigned long long)clock[1], (unsigned long long)cpu[1]->instruction_count);
+            return false;
+        }
+        if (cpu[0]->f_enable_interrupts != cpu[1]->f_enable_interrupts || cpu[0]->f_halted != cpu[1]->f_halted ||
+            mem[0]->get_mapped_rom_bank(0x0000) != mem[1]->get_mapped_rom_bank(0x0000) ||
+            mem[0]->get_mapped_rom_bank(0x4000) != mem[1]->get_mapped_rom_bank(0x4000))
+        {
+            printf("%s: IME, HALT or ROM bank differs\n", name);
+            return false;
+        }
+        for (int address = 0x8000; address < 0x10000; address++)
+        {
+            if (mem[0]->memory_byte[address] != mem[1]->memory_byte[address])
+            {
+                printf("%s: (%04x) %02x, interpreter %02x\n", name, address,
+                       mem[0]->memory_byte[address], mem[1]->memory_byte[address]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Random registers, pairs point into work RAM
+void randomize_registers(TestPair &pair, std::mt19937 &rng)
+{
+    uint8_t temp_bytes[8];
+    for (int r = 0; r < 8; r++)
+    {
+        temp_bytes[r] = rng();
+    }
+    uint16_t temp_r_sp_word = 0xd000 + (rng() & 0x0ffe);
+    for (int i = 0; i < 2; i++)
+    {
+        Register &reg = pair.cpu[i]->reg;
+        reg.set_register_byte(r_a, temp_bytes[0]);
+        reg.set_register_byte(r_f, temp_bytes[1]);
+        reg.set_register_byte(r_b, 0xc0 | (temp_bytes[2] & 0x1f));
+        reg.set_register_byte(r_c, temp_bytes[3]);
+        reg.set_register_byte(r_d, 0xc0 | (temp_bytes[4] & 0x1f));
+        reg.set_register_byte(r_e, temp_bytes[5]);
+        reg.set_register_byte(r_h, 0xc0 | (temp_bytes[6] & 0x1f));
+        reg.set_register_byte(r_l, temp_bytes[7]);
+        reg.set_register_word(r_sp, temp_r_sp_word);
+    }
+}
+
+// An opcode (main, or prefix CB with cb set) 8 times in a loop at TEST_CODE_ADDRESS,
+// from several register values, long enough for the loop block to be translated
+int test_opcode(uint8_t opcode, bool cb, std::mt19937 &rng)
+{
+    static uint8_t rom[ROM_MIN_SIZE];
+    memset(rom, 0, sizeof(rom));
+    int temp_failed = 0;
+    for (int seed = 0; seed < 8; seed++)
+    {
+        uint16_t temp_address = TEST_CODE_ADDRESS;
+        for (int i = 0; i < 8; i++)
+        {
+            if (cb)
+            {
+                rom[temp_address++] = 0xcb;
+                rom[temp_address++] = opcode;
+                continue;
+            }
+            rom[temp_address++] = opcode;
+            for (int k = 1; k < opcode_length_main[opcode]; k++)
+            {
+                rom[temp_address++] = rng();
+            }
+        }
+        // JP TEST_CODE_ADDRESS
+        rom[temp_address++] = 0xc3;
+        rom[temp_address++] = TEST_CODE_ADDRESS & 0xff;
+        rom[temp_address++] = TEST_CODE_ADDRESS >> 8;
+
+        TestPair pair;
+        pair.load_rom(rom);
+        randomize_registers(pair, rng);
+        for (int i = 0; i < 2; i++)
+        {
+            pair.cpu[i]->reg.set_register_word(r_pc, TEST_CODE_ADDRESS);
+            pair.cpu[i]->f_enable_interrupts = false;
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), cb ? "CB %02x seed %d" : "opcode %02x seed %d", opcode, seed);
+        uint64_t deadline = 0;
+        for (int step = 0; step < 64; step++)
+        {
+            deadline += 1 + rng() % TEST_LINE_CLOCKS;
+            pair.run(deadline);
+            if (!pair.compare(name))
+            {
+                temp_failed++;
+                break;
+            }
+        }
+    }
+    return temp_failed;
+}
+
+// Random code, illegal opcodes run as NOP
+int test_random_rom(int seed)
+{
+    std::mt19937 rng(seed);
+    static uint8_t rom[ROM_MIN_SIZE];
+    for (int i = 0; i < ROM_MIN_SIZE; i++)
+    {
+        rom[i] = rng();
+    }
+
+    TestPair pair;
+    pair.load_rom(rom);
+    char name[32];
+    snprintf(name, sizeof(name), "random ROM %d", seed);
+    uint64_t deadline = 0;
+    for (int step = 0; step < 2000; step++)
+    {
+        deadline += 1 + rng() % TEST_LINE_CLOCKS;
+        // wake up HALT and take interrupts now and then
+        if (rng() % 4 == 0)
+        {
+            uint8_t temp_bit = 1 << (rng() % 5);
+            pair.mem[0]->memory_byte[0xff0f] |= temp_bit;
+            pair.mem[1]->memory_byte[0xff0f] |= temp_bit;
+        }
+        pair.run(deadline);
+        if (!pair.compare(name))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Latch the MBC3 clock and write its seconds late in a block, again and again
+// The mapper sees the clock at the start of the instruction, the translated
+// block has to bring it up to date before the write (mapper state compared)
+int test_mbc3_rtc(void)
+{
+    static uint8_t rom[ROM_MIN_SIZE];
+    memset(rom, 0, sizeof(rom));
+    uint16_t temp_address = TEST_CODE_ADDRESS;
+    // write value to nn: LD A, value; LD (nn), A, after count NOPs
+    auto emit_write = [&](int count, uint16_t nn, uint8_t value) {
+        temp_address += count;
+        rom[temp_address++] = 0x3e;
+        rom[temp_address++] = value;
+        rom[temp_address++] = 0xea;
+        rom[temp_address++] = nn & 0xff;
+        rom[temp_address++] = nn >> 8;
+    };
+    // RAM and RTC enable, then the loop
+    emit_write(0, 0x0000, 0x0a);
+    uint16_t temp_loop = temp_address;
+    emit_write(16, 0x4000, RtcRegister::rtc_seconds);
+    emit_write(24, 0x6000, 0x00);
+    emit_write(0, 0x6000, 0x01);
+    emit_write(32, 0xa000, 0x05);
+    // LD A, (0xA000); LD (0xC000), A
+    temp_address += 8;
+    rom[temp_address++] = 0xfa;
+    rom[temp_address++] = 0x00;
+    rom[temp_address++] = 0xa0;
+    rom[temp_address++] = 0xea;
+    rom[temp_address++] = 0x00;
+    rom[temp_address++] = 0xc0;
+    // JP loop
+    rom[temp_address++] = 0xc3;
+    rom[temp_address++] = temp_loop & 0xff;
+    rom[temp_address++] = temp_loop >> 8;
+
+    TestPair pair;
+    pair.load_rom(rom, MapperType::mapper_mbc3);
+    std::mt19937 rng(3);
+    uint64_t deadline = 0;
+    for (int step = 0; step < 20000; step++)
+    {
+        deadline += 1 + rng() % TEST_LINE_CLOCKS;
+        pair.run(deadline);
+        std::vector<uint8_t> temp_state[2];
+        for (int i = 0; i < 2; i++)
+        {
+            StateWriter writer(temp_state[i]);
+            pair.mem[i]->cartridge.mapper->save_state(writer);
+        }
+        if (!pair.compare("MBC3 RTC"))
+        {
+            return 1;
+        }
+        if (temp_state[0] != temp_state[1])
+        {
+            printf("MBC3 RTC: mapper state differs at clock %llu\n", (unsigned long long)pair.clock[0]);
+            return 1;
+        }
+    }
+    printf("MBC3 RTC: %llu blocks translated\n", (unsigned long long)pair.cpu[0]->dynarec.translated_count);
+    return 0;
+}
+
+// A ROM file for 60 seconds of GameBoy time
+int test_rom_file(const char *rom_path)
+{
+    TestPair pair;
+    for (int i = 0; i < 2; i++)
+    {
+        if (!pair.mem[i]->cartridge.power_on(rom_path))
+        {
+            printf("%s: can not load\n", rom_path);
+            return 1;
+        }
+        pair.mem[i]->map_cartridge_pages();
+        pair.cpu[i]->power_on();
+    }
+
+    uint64_t deadline = 0;
+    for (int line = 0; line < 60 * 60 * 154; line++)
+    {
+        deadline += TEST_LINE_CLOCKS;
+        pair.run(deadline);
+        if (!pair.compare(rom_path))
+        {
+            return 1;
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            pair.mem[i]->memory_byte[TEST_LY_ADDRESS] = (pair.mem[i]->memory_byte[TEST_LY_ADDRESS] + 1) % 154;
+        }
+    }
+    printf("%s: %llu instructions, %llu blocks translated\n", rom_path,
+           (unsigned long long)pair.cpu[0]->instruction_count,
+           (unsigned long long)pair.cpu[0]->dynarec.translated_count);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    std::mt19937 rng(1);
+
+    for (int opcode = 0; opcode < 256; opcode++)
+    {
+        // HALT waits for an interrupt that never comes, STOP waits for a button
+        if (opcode == 0x76 || opcode == 0x10 || opcode == 0xcb)
+        {
+            continue;
+        }
+        failed += test_opcode(opcode, false, rng);
+    }
+    for (int opcode = 0; opcode < 256; opcode++)
+    {
+        failed += test_opcode(opcode, true, rng);
+    }
+    printf("opcodes: %d failed\n", failed);
+
+    int temp_random_failed = 0;
+    for (int seed = 0; seed < 64; seed++)
+    {
+        temp_random_failed += test_random_rom(seed);
+    }
+    printf("random ROMs: %d failed\n", temp_random_failed);
+    failed += temp_random_failed;
+
+    failed += test_mbc3_rtc();
+
+    for (int i = 1; i < argc; i++)
+    {
+        failed += test_rom_file(argv[i]);
+    }
+
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed ? 1 : 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("dynarec not built, define GAMEBOY_DYNAREC (x86-64)\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include "../src/memory.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace gameboy;
+
+// Bank switching through the page tables, for every mapper
+// Each ROM bank holds its number in its first two bytes, so a read of
+// 0x0000 or 0x4000 tells which bank is mapped there.
+
+// build command
+// g++ -std=c++11 -O2 ./src/memory.cc ./src/cartridge.cc ./src/mapper.cc ./src/rom-image.cc ./src/save-ram.cc ./src/save-state.cc ./src/joypad.cc ./src/scheduler.cc ./src/tile-cache.cc ./test/mapper-test.cc -o mapper_test.out
+
+int failed = 0;
+
+void expect(const char *name, unsigned value, unsigned expected)
+{
+    if (value != expected)
+    {
+        printf("%s: %x, expected %x\n", name, value, expected);
+        failed++;
+    }
+}
+
+// Memory with a cartridge of bank_count banks and ram_size bytes of RAM
+// rom lives until the test ends
+Memory *create_memory(MapperType type, std::vector<uint8_t> &rom, uint16_t bank_count, uint32_t ram_size)
+{
+    rom.assign(bank_count * BANK_SIZE, 0x00);
+    for (uint32_t bank = 0; bank < bank_count; bank++)
+    {
+        rom[bank * BANK_SIZE] = bank & 0xff;
+        rom[bank * BANK_SIZE + 1] = bank >> 8;
+    }
+    // Memory is too large for the stack
+    Memory *mem = new Memory;
+    mem->cartridge.mapper_type = type;
+    mem->cartridge.rom_bytes = rom.data();
+    mem->cartridge.rom_size = rom.size();
+    mem->cartridge.rom_attributes_bank_count = bank_count;
+    mem->cartridge.ram_size = ram_size;
+    mem->cartridge.open_ram("");
+    mem->cartridge.create_mapper();
+    mem->map_cartridge_pages();
+    return mem;
+}
+
+void expect_banks(const char *name, Memory *mem, unsigned bank_0, unsigned bank_1)
+{
+    expect(name, mem->get_memory_word(0x0000), bank_0);
+    expect(name, mem->get_memory_word(0x4000), bank_1);
+    expect(name, mem->get_mapped_rom_bank(0x0000), bank_0);
+    expect(name, mem->get_mapped_rom_bank(0x7fff), bank_1);
+}
+
+void test_mbc1(void)
+{
+    std::vector<uint8_t> rom;
+    Memory *mem = create_memory(MapperType::mapper_mbc1, rom, 128, 0x8000);
+    expect_banks("MBC1 power on", mem, 0, 1);
+    mem->set_memory_byte(0x2000, 0x00);
+    expect_banks("MBC1 bank 0 reads as 1", mem, 0, 1);
+    mem->set_memory_byte(0x2000, 0x1f);
+    expect_banks("MBC1 bank 0x1f", mem, 0, 0x1f);
+    mem->set_memory_byte(0x4000, 0x02);
+    expect_banks("MBC1 bank 0x5f", mem, 0, 0x5f);
+    mem->set_memory_byte(0x2000, 0x20);
+    expect_banks("MBC1 bank 0x41", mem, 0, 0x41);
+    mem->set_memory_byte(0x6000, 0x01);
+    expect_banks("MBC1 mode 1", mem, 0x40, 0x41);
+
+    // RAM: disabled reads 0xFF, mode 1 banks it with 0x4000
+    expect("MBC1 RAM disabled", mem->get_memory_byte(0xa000), 0xff);
+    mem->set_memory_byte(0xa000, 0x12);
+    expect("MBC1 RAM disabled write", mem->cartridge.ram_bytes[0x4000], 0x00);
+    mem->set_memory_byte(0x0000, 0x0a);
+    mem->set_memory_byte(0xa000, 0x12);
+    expect("MBC1 RAM bank 2", mem->cartridge.ram_bytes[0x4000], 0x12);
+    mem->set_memory_byte(0x6000, 0x00);
+    expect("MBC1 mode 0 RAM bank 0", mem->get_memory_byte(0xa000), 0x00);
+    mem->set_memory_byte(0x0000, 0x00);
+    expect("MBC1 RAM disabled again", mem->get_memory_byte(0xa000), 0xff);
+    delete mem;
+
+    // banks past the end wrap around
+    mem = create_memory(MapperType::mapper_mbc1, rom, 8, 0);
+    mem->set_memory_byte(0x2000, 0x0b);
+    expect_banks("MBC1 bank 0x0b of 8", mem, 0, 0x03);
+    delete mem;
+}
+
+void test_mbc2(void)
+{
+    std::vector<uint8_t> rom;
+    Memory *mem = create_memory(MapperType::mapper_mbc2, rom, 16, MBC2_RAM_SIZE);
+    mem->set_memory_byte(0x2100, 0x0f);
+    expect_banks("MBC2 bank 0x0f", mem, 0, 0x0f);
+    // address bit 8 clear: RAM enable, the ROM bank stays
+    mem->set_memory_byte(0x2000, 0x0a);
+    expect_banks("MBC2 RAM enable", mem, 0, 0x0f);
+    mem->set_memory_byte(0xa001, 0x35);
+    expect("MBC2 RAM nibble", mem->get_memory_byte(0xa001), 0xf5);
+    expect("MBC2 RAM echo", mem->get_memory_byte(0xa201), 0xf5);
+    expect("MBC2 RAM echo 0xBFxx", mem->get_memory_byte(0xbe01), 0xf5);
+    mem->set_memory_byte(0x0000, 0x00);
+    expect("MBC2 RAM disabled", mem->get_memory_byte(0xa001), 0xff);
+    delete mem;
+}
+
+void test_mbc3(void)
+{
+    std::vector<uint8_t> rom;
+    uint64_t clock = 0;
+    Memory *mem = create_memory(MapperType::mapper_mbc3, rom, 128, 0x8000);
+    mem->cartridge.mapper->clock = &clock;
+    mem->set_memory_byte(0x2000, 0x7f);
+    expect_banks("MBC3 bank 0x7f", mem, 0, 0x7f);
+    mem->set_memory_byte(0x2000, 0x00);
+    expect_banks("MBC3 bank 0 reads as 1", mem, 0, 1);
+
+    mem->set_memory_byte(0x0000, 0x0a);
+    mem->set_memory_byte(0x4000, 0x03);
+    mem->set_memory_byte(0xa123, 0x56);
+    expect("MBC3 RAM bank 3", mem->cartridge.ram_bytes[0x6123], 0x56);
+
+    // 1 day, 2 hours, 3 minutes and 4 seconds later
+    clock = (uint64_t)(86400 + 2 * 3600 + 3 * 60 + 4) * RTC_CLOCKS_PER_SECOND;
+    mem->set_memory_byte(0x6000, 0x00);
+    mem->set_memory_byte(0x6000, 0x01);
+    static const uint8_t expected[5] = {4, 3, 2, 1, 0};
+    for (int r = 0; r < 5; r++)
+    {
+        mem->set_memory_byte(0x4000, RtcRegister::rtc_seconds + r);
+        expect("MBC3 RTC latch", mem->get_memory_byte(0xa000), expected[r]);
+    }
+    // latched values hold until the next latch
+    clock += 10 * RTC_CLOCKS_PER_SECOND;
+    mem->set_memory_byte(0x4000, RtcRegister::rtc_seconds);
+    expect("MBC3 RTC latched", mem->get_memory_byte(0xa000), 4);
+
+    // halt, set the seconds, the clock stands still
+    mem->set_memory_byte(0x4000, RtcRegister::rtc_day_high);
+    mem->set_memory_byte(0xa000, 0x40);
+    mem->set_memory_byte(0x4000, RtcRegister::rtc_seconds);
+    mem->set_memory_byte(0xa000, 30);
+    clock += 100 * RTC_CLOCKS_PER_SECOND;
+    mem->set_memory_byte(0x6000, 0x00);
+    mem->set_memory_byte(0x6000, 0x01);
+    expect("MBC3 RTC halted", mem->get_memory_byte(0xa000), 30);
+    delete mem;
+}
+
+void test_mbc5(void)
+{
+    std::vector<uint8_t> rom;
+    Memory *mem = create_memory(MapperType::mapper_mbc5, rom, 512, 0x20000);
+    mem->set_memory_byte(0x2000, 0x00);
+    expect_banks("MBC5 bank 0", mem, 0, 0);
+    mem->set_memory_byte(0x2000, 0xff);
+    mem->set_memory_byte(0x3000, 0x01);
+    expect_banks("MBC5 bank 0x1ff", mem, 0, 0x1ff);
+    mem->set_memory_byte(0x3000, 0x00);
+    expect_banks("MBC5 bank 0xff", mem, 0, 0xff);
+
+    mem->set_memory_byte(0x0000, 0x0a);
+    mem->set_memory_byte(0x4000, 0x0f);
+    mem->set_memory_byte(0xbfff, 0x9a);
+    expect("MBC5 RAM bank 0x0f", mem->cartridge.ram_bytes[0x1ffff], 0x9a);
+    mem->set_memory_byte(0x4000, 0x00);
+    expect("MBC5 RAM bank 0", mem->get_memory_byte(0xbfff), 0x00);
+    delete mem;
+}
+
+void test_rom_only(void)
+{
+    std::vector<uint8_t> rom;
+    Memory *mem = create_memory(MapperType::mapper_rom_only, rom, 2, 0x800);
+    mem->set_memory_byte(0x2000, 0x05);
+    expect_banks("ROM only", mem, 0, 1);
+    // 2 KB RAM repeats over 0xA000~0xBFFF
+    mem->set_memory_byte(0xa010, 0x77);
+    expect("ROM + RAM echo", mem->get_memory_byte(0xa810), 0x77);
+    delete mem;
+}
+
+// A state with ROM bank 0 at 0x4000 maps bank 1, as a register write would
+void test_load_state(void)
+{
+    std::vector<uint8_t> rom;
+    static const MapperType types[3] = {MapperType::mapper_mbc1, MapperType::mapper_mbc2, MapperType::mapper_mbc3};
+    static const char *names[3] = {"MBC1 state bank 0", "MBC2 state bank 0", "MBC3 state bank 0"};
+    // RAM enable, ROM bank 0, the rest zero
+    uint8_t temp_state[32] = {0};
+    for (int i = 0; i < 3; i++)
+    {
+        Memory *mem = create_memory(types[i], rom, 16, 0);
+        mem->set_memory_byte(0x2100, 0x05);
+        StateReader reader(temp_state, sizeof(temp_state));
+        mem->cartridge.mapper->load_state(reader);
+        mem->map_cartridge_pages();
+        expect_banks(names[i], mem, 0, 1);
+        delete mem;
+    }
+}
+
+// Battery RAM written through the page tables is in the .sav file after a power cycle
+void test_save_file(void)
+{
+    const char *save_path = "mapper_test.sav";
+    remove(save_path);
+    std::vector<uint8_t> rom;
+    Memory *mem = create_memory(MapperType::mapper_mbc5, rom, 4, 0x8000);
+    mem->cartridge.mapper.reset();
+    mem->cartridge.open_ram(save_path);
+    mem->cartridge.create_mapper();
+    mem->map_cartridge_pages();
+    mem->set_memory_byte(0x0000, 0x0a);
+    mem->set_memory_byte(0x4000, 0x03);
+    mem->set_memory_byte(0xa456, 0xc3);
+    delete mem;
+
+    FILE *save_file = fopen(save_path, "rb");
+    uint8_t temp_bytes[0x8000] = {0};
+    size_t temp_size = save_file ? fread(temp_bytes, 1, sizeof(temp_bytes) + 1, save_file) : 0;
+    if (save_file)
+    {
+        fclose(save_file);
+    }
+    expect("save file size", temp_size, 0x8000);
+    expect("save file byte", temp_bytes[0x6456], 0xc3);
+
+    mem = create_memory(MapperType::mapper_mbc5, rom, 4, 0x8000);
+    mem->cartridge.mapper.reset();
+    mem->cartridge.open_ram(save_path);
+    mem->cartridge.create_mapper();
+    mem->map_cartridge_pages();
+    mem->set_memory_byte(0x0000, 0x0a);
+    mem->set_memory_byte(0x4000, 0x03);
+    expect("save file reload", mem->get_memory_byte(0xa456), 0xc3);
+    delete mem;
+    remove(save_path);
+}
+
+int main(void)
+{
+    test_rom_only();
+    test_mbc1();
+    test_mbc2();
+    test_mbc3();
+    test_mbc5();
+    test_load_state();
+    test_save_file();
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+#include "../src/motherboard.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace gameboy;
+
+// Save state round trip
+// For each ROM: run 300 frames, save, run 300 more and keep the result; load the
+// state, run the same 300 frames again and compare frame buffer, memory, cartridge
+// RAM, CPU registers and clocks. Then time save_state and load_state.
+
+// build command
+// g++ -std=c++11 -O2 ./src/motherboard.cc ./src/cpu.cc ./src/cpu-threaded.cc ./src/dynarec.cc ./src/register.cc ./src/memory.cc ./src/ppu.cc ./src/cartridge.cc ./src/mapper.cc ./src/rom-image.cc ./src/save-ram.cc ./src/save-state.cc ./src/joypad.cc ./src/scheduler.cc ./src/tile-cache.cc ./src/block-cache.cc ./src/frame-pacer.cc ./src/timer.cc ./test/save-state-test.cc -o save_state_test.out
+
+// usage
+// ./save_state_test.out rom ...
+
+#define TEST_FRAMES 300
+#define TEST_TIMING_RUNS 1000
+
+// Everything the game can observe, and the frame
+struct Snapshot
+{
+    std::vector<uint8_t> memory;
+    std::vector<uint8_t> cartridge_ram;
+    std::vector<uint8_t> frame;
+    uint8_t registers[8];
+    uint16_t r_sp_word;
+    uint16_t r_pc_word;
+    uint64_t clock;
+    uint64_t instruction_count;
+
+    void take(Motherboard &motherboard)
+    {
+        memory.resize(0x10000);
+        for (uint32_t address = 0; address < 0x10000; address++)
+        {
+            memory[address] = motherboard.mem.get_memory_byte(address);
+        }
+        cartridge_ram.assign(motherboard.mem.cartridge.ram_bytes,
+                             motherboard.mem.cartridge.ram_bytes + motherboard.mem.cartridge.ram_size);
+        frame.assign(&motherboard.ppu.frame_buffer[0][0], &motherboard.ppu.frame_buffer[0][0] + SCREEN_WIDTH * SCREEN_HEIGHT);
+        static const RegisterName names[8] = {r_a, r_f, r_b, r_c, r_d, r_e, r_h, r_l};
+        for (int r = 0; r < 8; r++)
+        {
+            registers[r] = motherboard.cpu.reg.get_register_byte(names[r]);
+        }
+        r_sp_word = motherboard.cpu.reg.register_word[r_sp];
+        r_pc_word = motherboard.cpu.reg.register_word[r_pc];
+        clock = motherboard.scheduler.now;
+        instruction_count = motherboard.cpu.instruction_count;
+    }
+
+    bool operator==(const Snapshot &other) const
+    {
+        return memory == other.memory && cartridge_ram == other.cartridge_ram && frame == other.frame &&
+               memcmp(registers, other.registers, sizeof(registers)) == 0 && r_sp_word == other.r_sp_word &&
+               r_pc_word == other.r_pc_word && clock == other.clock && instruction_count == other.instruction_count;
+    }
+};
+
+void run_frames(Motherboard &motherboard, int frames)
+{
+    while (frames > 0)
+    {
+        if (motherboard.run_until_poll())
+        {
+            frames--;
+        }
+    }
+}
+
+int test_rom(const char *rom_path)
+{
+    // Motherboard is too large for the stack
+    std::unique_ptr<Motherboard> motherboard(new Motherboard);
+    motherboard->mem.cartridge.save_file_enabled = false;
+    if (!motherboard->power_on(rom_path))
+    {
+        printf("%s: can not load\n", rom_path);
+        return 1;
+    }
+    JoypadInput input;
+    motherboard->apply_input(input);
+    run_frames(*motherboard, TEST_FRAMES);
+
+    std::vector<uint8_t> state;
+    motherboard->save_state(state);
+    run_frames(*motherboard, TEST_FRAMES);
+    Snapshot expected;
+    expected.take(*motherboard);
+
+    if (!motherboard->load_state(state.data(), state.size()))
+    {
+        printf("%s: state not loaded\n", rom_path);
+        return 1;
+    }
+    run_frames(*motherboard, TEST_FRAMES);
+    Snapshot result;
+    result.take(*motherboard);
+    if (!(result == expected))
+    {
+        printf("%s: run after load differs\n", rom_path);
+        return 1;
+    }
+
+    // a state of another ROM, cut short, or with a chunk missing is refused and changes nothing
+    std::vector<uint8_t> broken = state;
+    broken[8] ^= 0xff;
+    bool temp_refused = !motherboard->load_state(broken.data(), broken.size());
+    broken = state;
+    broken.resize(state.size() - 1);
+    temp_refused = temp_refused && !motherboard->load_state(broken.data(), broken.size());
+    // whole chunks, but the first one twice and the last one ("CART") missing
+    size_t temp_first_end = SAVE_STATE_HEADER_SIZE + SAVE_STATE_CHUNK_HEADER_SIZE;
+    size_t temp_last = SAVE_STATE_HEADER_SIZE;
+    for (size_t position = SAVE_STATE_HEADER_SIZE; position < state.size();)
+    {
+        uint32_t temp_size = state[position + 4] | (state[position + 5] << 8) | (state[position + 6] << 16) |
+                             ((uint32_t)state[position + 7] << 24);
+        if (position == SAVE_STATE_HEADER_SIZE)
+        {
+            temp_first_end += temp_size;
+        }
+        temp_last = position;
+        position += SAVE_STATE_CHUNK_HEADER_SIZE + temp_size;
+    }
+    broken.assign(state.begin(), state.begin() + temp_last);
+    broken.insert(broken.end(), state.begin() + SAVE_STATE_HEADER_SIZE, state.begin() + temp_first_end);
+    temp_refused = temp_refused && !motherboard->load_state(broken.data(), broken.size());
+    Snapshot unchanged;
+    unchanged.take(*motherboard);
+    if (!temp_refused || !(unchanged == expected))
+    {
+        printf("%s: broken state loaded\n", rom_path);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TEST_TIMING_RUNS; i++)
+    {
+        motherboard->save_state(state);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < TEST_TIMING_RUNS; i++)
+    {
+        motherboard->load_state(state.data(), state.size());
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("%s: %u bytes, save %.1f us, load %.1f us\n", rom_path, (unsigned)state.size(),
+           std::chrono::duration<double, std::micro>(middle - start).count() / TEST_TIMING_RUNS,
+           std::chrono::duration<double, std::micro>(end - middle).count() / TEST_TIMING_RUNS);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int failed = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        failed += test_rom(argv[i]);
+    }
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed ? 1 : 0;
+}